@@ -0,0 +1,57 @@
+/**
+ * @file simulation_scenarios.h
+ * @brief Simulated plant and scenarios used by app_simulate_motion_control
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <plant_simulator_service.h>
+
+/*
+ * Simulated plant
+ */
+#define PLANT_MOMENT_OF_INERTIA         200     // [gram square centimeter]
+#define PLANT_VISCOUS_FRICTION          50      // [micro-Nm per rpm]
+#define PLANT_COULOMB_FRICTION          20      // [milli-Nm]
+#define PLANT_STATIC_FRICTION           30      // [milli-Nm]
+#define PLANT_TORQUE_TIME_CONSTANT      200     // time constant of the torque loop [microseconds]
+#define PLANT_BRAKE_RELEASE_TIME        50      // [milliseconds]
+#define PLANT_BRAKE_HOLDING_TORQUE      2000    // [milli-Nm]
+
+/*
+ * Example gains for the simulated plant, used instead of the (motor specific) gains of user_config.h
+ * about 100 Hz velocity and 20 Hz position bandwidth with a 16 bit position sensor
+ */
+#define SIMULATION_VELOCITY_Kp          1300000
+#define SIMULATION_VELOCITY_Ki          70000
+#define SIMULATION_VELOCITY_Kd          0
+#define SIMULATION_POSITION_Kp          114000
+#define SIMULATION_POSITION_Ki          0
+#define SIMULATION_POSITION_Kd          0
+
+/*
+ * Scenarios, position targets are relative to the position at the start of the scenario
+ */
+#define SCENARIO_POSITION_STEP { \
+        { SIMULATION_STEP_HOLD,              0,  200 }, \
+        { SIMULATION_STEP_POSITION,      10000, 1000 }, \
+        { SIMULATION_STEP_POSITION,          0, 1000 }  }
+
+#define SCENARIO_POSITION_RAMP { \
+        { SIMULATION_STEP_POSITION_RAMP, 100000, 2000 }, \
+        { SIMULATION_STEP_HOLD,               0,  500 }, \
+        { SIMULATION_STEP_LOAD_TORQUE,      100,  500 }, \
+        { SIMULATION_STEP_LOAD_TORQUE,        0,  500 }, \
+        { SIMULATION_STEP_POSITION_RAMP,      0, 2000 }  }
+
+#define SCENARIO_VELOCITY_REVERSAL { \
+        { SIMULATION_STEP_VELOCITY_RAMP,   1000, 1000 }, \
+        { SIMULATION_STEP_HOLD,               0,  500 }, \
+        { SIMULATION_STEP_REVERSAL,           0, 1000 }, \
+        { SIMULATION_STEP_VELOCITY_RAMP,      0, 1000 }  }
+
+#define SCENARIO_BRAKE_RELEASE { \
+        { SIMULATION_STEP_BRAKE_RELEASE,      0, 1000 }, \
+        { SIMULATION_STEP_POSITION,        5000, 1000 }, \
+        { SIMULATION_STEP_BRAKE_RELEASE,      0, 1000 }  }
@@ -5,6 +5,8 @@
 //General config
 #define SENSOR_MAX_TICKS                  0x7fffffff   // the count is reset to 0 if greater than this
 #define SENSOR_VELOCITY_COMPUTE_PERIOD    1000         // default velocity compute period 1ms
+#define SENSOR_VELOCITY_ESTIMATOR         VELOCITY_ESTIMATOR_DIFFERENCE // default velocity computation [VELOCITY_ESTIMATOR_DIFFERENCE, VELOCITY_ESTIMATOR_ALPHA_BETA_GAMMA]
+#define SENSOR_VELOCITY_ESTIMATOR_BANDWIDTH 200        // default bandwidth of the alpha-beta-gamma estimator [Hz]
 
 //BiSS config, use default if not set before
 #ifndef BISS_CONFIG
@@ -39,6 +39,11 @@
 // VELOCITY COMPUTE PERIOD (ALSO POLLING RATE) OF SENSOR_1 (in microseconds)
 #define SENSOR_1_VELOCITY_COMPUTE_PERIOD  REM_16MT_SENSOR_VELOCITY_COMPUTE_PERIOD
 
+// VELOCITY COMPUTATION OF SENSOR_1 [VELOCITY_ESTIMATOR_DIFFERENCE, VELOCITY_ESTIMATOR_ALPHA_BETA_GAMMA]
+// AND BANDWIDTH OF THE ESTIMATOR (in Hz), the estimator is updated with every position read, it is not used with HALL_SENSOR
+#define SENSOR_1_VELOCITY_ESTIMATOR            SENSOR_VELOCITY_ESTIMATOR
+#define SENSOR_1_VELOCITY_ESTIMATOR_BANDWIDTH  SENSOR_VELOCITY_ESTIMATOR_BANDWIDTH
+
 // POLARITY OF SENSOR_1 SENSOR [0 - normal, 1 - inverted]
 #define SENSOR_1_POLARITY                 SENSOR_POLARITY_NORMAL
 
@@ -63,6 +68,11 @@
 // VELOCITY COMPUTE PERIOD (ALSO POLLING RATE) OF SENSOR_2 (in microseconds)
 #define SENSOR_2_VELOCITY_COMPUTE_PERIOD  HALL_SENSOR_VELOCITY_COMPUTE_PERIOD
 
+// VELOCITY COMPUTATION OF SENSOR_2 [VELOCITY_ESTIMATOR_DIFFERENCE, VELOCITY_ESTIMATOR_ALPHA_BETA_GAMMA]
+// AND BANDWIDTH OF THE ESTIMATOR (in Hz), the estimator is updated with every position read, it is not used with HALL_SENSOR
+#define SENSOR_2_VELOCITY_ESTIMATOR            SENSOR_VELOCITY_ESTIMATOR
+#define SENSOR_2_VELOCITY_ESTIMATOR_BANDWIDTH  SENSOR_VELOCITY_ESTIMATOR_BANDWIDTH
+
 // POLARITY OF SENSOR_2 SENSOR [0 - normal, 1 - inverted]
 #define SENSOR_2_POLARITY                 SENSOR_POLARITY_NORMAL
 
@@ -83,6 +93,15 @@
 // Selecting USEC_STD will result in 12kHZ switching frequency, USEC_FAST (recommended) - in 15kHz
 #define IFM_TILE_USEC       USEC_FAST      // Number of ticks in a microsecond for IFM Tile.
 
+// DEAD-TIME COMPENSATION OF THE POWER STAGE OF YOUR IFM BOARD [ns], 0 disables it.
+// Start with half of the dead-time of the PWM service (3000) and add the switching delays of the board.
+// The compensation fades out for phase voltages below DEADTIME_COMPENSATION_BAND [ns of pulse width] (start with 250).
+// The sign of the phase currents is taken from the phase voltages, which only holds at a small power-factor angle (low speed).
+// The compensation therefore fades out between 25% and 50% modulation depth (DEADTIME_COMP_FADE_START/END in pwm_general.h).
+// Leave it at 0 for motors whose current lags far behind the voltage already at low speed (high inductance, low resistance).
+#define DEADTIME_COMPENSATION           0
+#define DEADTIME_COMPENSATION_BAND      250
+
 //////////////////////////////////////////////
 //////  MOTOR COMMUTATION CONFIGURATION
 //////////////////////////////////////////////
@@ -140,11 +159,36 @@
 //     "1000"                 in case of using position controller in "LT_POSITION_CONTROLLER"               mode
 #define POSITION_INTEGRAL_LIMIT                 PEAK_SPEED
 
+// feed-forward of the reference velocity and acceleration in "POS_PID_VELOCITY_CASCADED_CONTROLLER" mode [per thousand, 1000: full feed-forward, 0: disabled]
+// the acceleration feed-forward uses MOMENT_OF_INERTIA
+#define VELOCITY_FEEDFORWARD                    0
+#define ACCELERATION_FEEDFORWARD                0
+
+// bandwidth of the observer estimating and compensating the load torque in velocity and position control [Hz], 0 disables it
+// the observer uses MOMENT_OF_INERTIA
+#define DISTURBANCE_OBSERVER_BANDWIDTH          0
+
+// online estimation of the moment of inertia and the friction while the motor accelerates [0 off, 1 estimate, 2 estimate and use as MOMENT_OF_INERTIA]
+#define INERTIA_ESTIMATION                      0
+
+// bandwidth of the alpha-beta-gamma estimator of the velocity from the timestamped position and the torque reference [Hz], 0 uses the velocity of the sensor
+// the torque reference is used with MOMENT_OF_INERTIA, the bandwidth is at most 1/(2*pi) of the control frequency
+#define VELOCITY_ESTIMATOR_BANDWIDTH            0
+
 // POLARITY OF THE MOVEMENT OF YOUR MOTOR [MOTION_POLARITY_NORMAL(0), MOTION_POLARITY_INVERTED(1)]
 #define POLARITY           MOTION_POLARITY_NORMAL
 
 #define FILTER_CUT_OFF_FREQ     0;//cut-off frequency of filter in motion control service (default value 100 kHz)
 
+#define ADAPTIVE_NOTCH                  0   //notch following the resonance in the torque reference (0 off, 1 learning, 2 frozen)
+#define ADAPTIVE_NOTCH_WIDTH            100 //width of the adaptive notch [Hz]
+#define ADAPTIVE_NOTCH_THRESHOLD        20  //amplitude of the resonance in the torque reference needed to adapt the notch [mNm]
+
+#define ENABLE_POSITION_EXTRAPOLATION   0   //compensate the age of the position feedback by extrapolation (0 disabled, 1 enabled)
+
+#define CYCLIC_INTERPOLATION            0   //interpolate the targets of the master between its cycles (0 none, 1 linear, 2 cubic)
+#define CYCLIC_MASTER_PERIOD            1000 //cycle time of the master [us]
+
 /////////////////////////////////////////////////
 //////  PROFILES AND LIMITS CONFIGURATION
 /////////////////////////////////////////////////
@@ -163,6 +207,7 @@
 #define MAX_ACCELERATION_PROFILER               10000    // [rpm/sec]
 #define MAX_DECELERATION_PROFILER               10000    // [rpm/sec]
 #define MAX_SPEED_PROFILER                      2000     // [rpm]
+#define MAX_JERK_PROFILER                       0        // [rpm/sec^2], 0 selects the trapezoidal position profiler
 
 #define POSITION_CONTROL_STRATEGY               POS_PID_VELOCITY_CASCADED_CONTROLLER
 
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <motion_control_service.h>
+#include <relay_tune.h>
 
 /**
  * @brief The velocity in which the tuning will happen. (suggested value: 60% of rated velocity).
@@ -13,13 +14,29 @@
 #define TUNING_VELOCITY 1000        //[rpm]
 #define KP_VELOCITY_TUNING  500000  //kp initial value while running the automatic tuning of velocity controller
 #define SETTLING_TIME   0.3         //preffered settling time for velocity controller [seconds]
-#define MEASUREMENT_ARRAY_LENGTH    1000    //length of measurement array which is used while sampling velocity in velocity autotuner
+#define MEASUREMENT_ARRAY_LENGTH    1000    //number of velocity samples of the step response in velocity autotuner
 
 // parameters of position controller autotuner
 #define AUTO_TUNE_STEP_AMPLITUDE    20000 // The tuning procedure uses steps to evaluate the response of controller. This input is equal to half of step command amplitude.
 #define AUTO_TUNE_COUNTER_MAX        5000 // The period of step commands in ticks. Each tick is corresponding to one execution sycle of motion_control_service. As a result, 3000 ticks when the frequency of motion_control_service is 1 ms leads to a period equal to 3 seconds for each step command.
 #define PER_THOUSAND_OVERSHOOT         10 // Overshoot limit while tuning (it is set as per thousand of step amplitude)
 
+// parameters of the relay feedback autotuner of the cascaded position controller (position_control_autotune = RELAY_AUTOTUNE)
+#define RELAY_AUTOTUNE                  2 // Value of position_control_autotune which starts the relay feedback autotuner
+#define RELAY_TUNE_TORQUE_AMPLITUDE   100 // Torque relay while tuning the velocity controller [mNm]. It has to be above the friction torque.
+#define RELAY_TUNE_VELOCITY_AMPLITUDE  20 // Velocity relay while tuning the position controller [rpm]
+#define RELAY_TUNE_VELOCITY_HYSTERESIS  3 // Hysteresis of the torque relay [rpm]. It has to be above the noise of the measured velocity.
+#define RELAY_TUNE_POSITION_HYSTERESIS 10 // Hysteresis of the velocity relay [ticks]. It has to be above the noise of the measured position.
+#define RELAY_TUNE_CYCLES               4 // Number of measured oscillation cycles of each controller
+#define RELAY_TUNE_RULE  RELAY_TUNE_TYREUS_LUYBEN // Tuning rule (see RelayTuneRule)
+
+// parameters of the commissioning identification of the plant (enable_velocity_auto_tuner = PLANT_IDENTIFICATION)
+#define PLANT_IDENTIFICATION            2 // Value of enable_velocity_auto_tuner which starts the plant identification
+#define IDENTIFICATION_VELOCITY       200 // Operating velocity of the identification [rpm]. It has to be high enough so the velocity does not change its sign.
+#define IDENTIFICATION_AMPLITUDE      100 // Amplitude of the PRBS torque [mNm]. The velocity change of one period has to be above the noise of the measured velocity.
+#define IDENTIFICATION_BANDWIDTH       50 // Requested bandwidth of the velocity controller [Hz]
+#define IDENTIFICATION_RESONANCE        0 // 1 identifies the first resonance as well, 0 a rigid plant only. The resonant fit needs about three times the operations per period.
+
 /**
  * @brief steps of position controller autotuning procedure
  */
@@ -50,7 +67,8 @@ typedef struct {
     int counter;
     int save_counter;
     double velocity_ref;
-    int  actual_velocity[1001];
+    double velocity_sum;        // sum of all samples of the step response
+    double steady_state_sum;    // sum of the last samples of the step response, from MEASUREMENT_ARRAY_LENGTH-100 on
     double j;
     double f;
     double z;
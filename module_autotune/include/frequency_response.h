@@ -0,0 +1,159 @@
+/**
+ * @file frequency_response.h
+ * @brief Frequency response analyzer measuring the plant and the closed loop with an injected excitation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Maximum number of frequencies of a frequency response measurement.
+ */
+#define FREQUENCY_RESPONSE_MAX_POINTS   16
+
+/**
+ * @brief Excitation signal of a frequency response measurement.
+ *        All excitations repeat with the record length, so the measured frequencies do not leak into each other.
+ */
+typedef enum {
+    FREQUENCY_RESPONSE_MULTISINE    = 0,    /**< Sum of sines at the measured frequencies with Schroeder phases */
+    FREQUENCY_RESPONSE_CHIRP        = 1,    /**< Logarithmic sweep from the lowest to the highest measured frequency */
+    FREQUENCY_RESPONSE_PRBS         = 2     /**< Pseudo random binary sequence, each bit held up to 0.4/(highest frequency) */
+} FrequencyResponseExcitation;
+
+/**
+ * @brief Injection point of the excitation.
+ */
+typedef enum {
+    FREQUENCY_RESPONSE_TORQUE       = 0,    /**< Added to the torque reference [mNm], the closed loop is the input sensitivity torque/excitation */
+    FREQUENCY_RESPONSE_VELOCITY     = 1     /**< Added to the velocity reference in velocity control [rpm], the closed loop is velocity/excitation */
+} FrequencyResponseInjection;
+
+/**
+ * @brief Status of a frequency response measurement.
+ */
+typedef enum {
+    FREQUENCY_RESPONSE_IDLE         = 0,    /**< No measurement started, or aborted */
+    FREQUENCY_RESPONSE_RUNNING      = 1,    /**< Excitation running */
+    FREQUENCY_RESPONSE_DONE         = 2     /**< Measurement finished, the results are valid */
+} FrequencyResponseStatus;
+
+/**
+ * @brief Structure type for the configuration of a frequency response measurement.
+ */
+typedef struct {
+    int excitation;         /**< Excitation signal (see FrequencyResponseExcitation) */
+    int injection;          /**< Injection point (see FrequencyResponseInjection) */
+    int amplitude;          /**< Peak amplitude of the excitation [mNm] or [rpm] */
+    int record_length;      /**< Length of one period of the excitation [control periods], the frequency resolution is 1/(record_length*T_s) */
+    int periods;            /**< Number of measured periods, one more period is applied before to settle */
+    int n_points;           /**< Number of measured frequencies */
+    int frequency[FREQUENCY_RESPONSE_MAX_POINTS];   /**< Measured frequencies [Hz], rounded to the frequency resolution */
+} FrequencyResponseConfig;
+
+/**
+ * @brief Structure type for the result of a frequency response measurement.
+ */
+typedef struct {
+    int status;             /**< Status of the measurement (see FrequencyResponseStatus) */
+    int n_points;           /**< Number of measured frequencies */
+    int frequency[FREQUENCY_RESPONSE_MAX_POINTS];               /**< Measured frequencies [mHz] */
+    int plant_magnitude[FREQUENCY_RESPONSE_MAX_POINTS];         /**< Magnitude of velocity/torque [0.01 dB of rpm/Nm] */
+    int plant_phase[FREQUENCY_RESPONSE_MAX_POINTS];             /**< Phase of velocity/torque [0.01 degree] */
+    int closed_loop_magnitude[FREQUENCY_RESPONSE_MAX_POINTS];   /**< Magnitude of the closed loop [0.01 dB] */
+    int closed_loop_phase[FREQUENCY_RESPONSE_MAX_POINTS];       /**< Phase of the closed loop [0.01 degree] */
+} FrequencyResponse;
+
+/**
+ * @brief Structure type of the frequency response analyzer. The spectra of the excitation, the torque and
+ *        the velocity are accumulated with one Goertzel filter per signal and frequency, no samples are stored.
+ */
+typedef struct {
+    FrequencyResponseConfig config;
+    int status;
+    int counter;
+    int n_samples;
+    double T_s;                                         // [s]
+    double omega[FREQUENCY_RESPONSE_MAX_POINTS];        // [rad/sample]
+    double coefficient[FREQUENCY_RESPONSE_MAX_POINTS];  // 2*cos(omega)
+    double rotation[FREQUENCY_RESPONSE_MAX_POINTS];     // sin(omega)
+    double amplitude;
+    double sine_cos[FREQUENCY_RESPONSE_MAX_POINTS];     // multisine oscillators
+    double sine_sin[FREQUENCY_RESPONSE_MAX_POINTS];
+    double chirp_phase;
+    double chirp_omega;
+    double chirp_omega_start;
+    double chirp_ratio;
+    unsigned prbs_register;
+    int prbs_hold;
+    double prbs_value;
+    double excitation_1n[FREQUENCY_RESPONSE_MAX_POINTS];    // Goertzel states
+    double excitation_2n[FREQUENCY_RESPONSE_MAX_POINTS];
+    double torque_1n[FREQUENCY_RESPONSE_MAX_POINTS];
+    double torque_2n[FREQUENCY_RESPONSE_MAX_POINTS];
+    double velocity_1n[FREQUENCY_RESPONSE_MAX_POINTS];
+    double velocity_2n[FREQUENCY_RESPONSE_MAX_POINTS];
+} FrequencyResponseParam;
+
+/**
+ * @brief Stops the analyzer, it stays idle until a measurement is started.
+ *
+ * @param param     frequency response analyzer
+ *
+ * @return void
+ */
+void frequency_response_init(REFERENCE_PARAM(FrequencyResponseParam, param));
+
+/**
+ * @brief Checks the configuration and starts a measurement.
+ *
+ * @param config    configuration of the measurement
+ * @param T_s       sampling-time in us (microseconds)
+ * @param param     frequency response analyzer
+ *
+ * @return 0 if the measurement started, -1 if the configuration is not valid
+ *         (unknown excitation or injection, frequencies not strictly increasing after the rounding, or above half the sampling frequency)
+ */
+int frequency_response_start(FrequencyResponseConfig config, int T_s, REFERENCE_PARAM(FrequencyResponseParam, param));
+
+/**
+ * @brief Returns the excitation of the current control period.
+ *
+ * @param param     frequency response analyzer
+ *
+ * @return excitation [mNm] or [rpm], 0 if no measurement is running
+ */
+double frequency_response_excitation(REFERENCE_PARAM(FrequencyResponseParam, param));
+
+/**
+ * @brief Accumulates the signals of the current control period, has to be called once per control period after frequency_response_excitation().
+ *
+ * @param excitation    excitation of the control period
+ * @param torque        torque reference [mNm]
+ * @param velocity      actual velocity [rpm]
+ * @param param         frequency response analyzer
+ *
+ * @return void
+ */
+void frequency_response_update(double excitation, int torque, int velocity, REFERENCE_PARAM(FrequencyResponseParam, param));
+
+/**
+ * @brief Aborts a running measurement.
+ *
+ * @param param     frequency response analyzer
+ *
+ * @return void
+ */
+void frequency_response_stop(REFERENCE_PARAM(FrequencyResponseParam, param));
+
+/**
+ * @brief Computes the magnitude and the phase of the plant and of the closed loop once the measurement is done.
+ *
+ * @param param     frequency response analyzer
+ * @param response  result, only the status and the frequencies are set before the measurement is done
+ *
+ * @return void
+ */
+void frequency_response_result(REFERENCE_PARAM(FrequencyResponseParam, param), REFERENCE_PARAM(FrequencyResponse, response));
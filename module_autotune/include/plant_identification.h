@@ -0,0 +1,128 @@
+/**
+ * @file plant_identification.h
+ * @brief Commissioning identification of the mechanical plant with a PRBS excitation of the velocity loop
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Highest delay between the torque reference and the velocity which is identified [control periods].
+ */
+#define PLANT_ID_MAX_DELAY          3
+
+/**
+ * @brief Number of parameters of the resonant model.
+ */
+#define PLANT_ID_RESONANT_ORDER     (PLANT_ID_MAX_DELAY+7)
+
+/**
+ * @brief Time at the operating velocity before the excitation starts [s].
+ */
+#define PLANT_ID_SETTLING_TIME      0.5
+
+/**
+ * @brief Duration of the excitation [s].
+ */
+#define PLANT_ID_EXCITATION_TIME    2.0
+
+/**
+ * @brief Duration of the excitation if the resonance is identified [s], the lightly damped poles need more samples.
+ */
+#define PLANT_ID_RESONANCE_EXCITATION_TIME  8.0
+
+/**
+ * @brief Proportional gain of the velocity controller holding the operating velocity during the identification [mNm/rpm].
+ */
+#define PLANT_ID_VELOCITY_KP        0.5
+
+/**
+ * @brief Steps of the identification.
+ */
+typedef enum {
+    PLANT_ID_IDLE       = 0,    /**< Not started */
+    PLANT_ID_SETTLING   = 1,    /**< The velocity controller reaches the operating velocity */
+    PLANT_ID_EXCITING   = 2,    /**< The PRBS is added to the torque reference and the models are fitted */
+    PLANT_ID_DONE       = 3,    /**< The model and the gains are valid */
+    PLANT_ID_FAILED     = 4     /**< No plausible model was fitted */
+} PlantIdentificationStep;
+
+/**
+ * @brief Structure type for the identified plant and the derived gains. The gains have the scaling of MotionControlConfig.
+ */
+typedef struct {
+    int status;                 /**< Step of the identification (see PlantIdentificationStep) */
+    int moment_of_inertia;      /**< Moment of inertia [g cm^2] */
+    int viscous_friction;       /**< Viscous friction [uNm/rpm] */
+    int coulomb_friction;       /**< Coulomb friction [mNm] */
+    int delay;                  /**< Delay between the torque reference and the velocity [control periods] */
+    int resonance_frequency;    /**< Frequency of the first resonance [Hz], 0 if none was identified */
+    int resonance_damping;      /**< Damping of the first resonance [per thousand] */
+    int bandwidth;              /**< Bandwidth of the velocity controller [Hz], below the requested one if the delay or the resonance limit it */
+    int velocity_kp;            /**< P constant of the velocity controller */
+    int velocity_ki;            /**< I constant of the velocity controller */
+    int position_kp;            /**< P constant of the cascaded position controller, its bandwidth is a quarter of the velocity bandwidth */
+} PlantModel;
+
+/**
+ * @brief Structure type of the identification.
+ *        The rigid model v(k) = a*v(k-1) + b*u(k-1-d) + c is fitted for each delay d by recursive instrumental variables,
+ *        the resonant model dv(k) = a1*dv(k-1) + a2*dv(k-2) + g*v(k-1) + b1*u(k-1) + ... + bn*u(k-n) + c of the velocity change
+ *        dv(k) = v(k) - v(k-1), with n = PLANT_ID_MAX_DELAY+3, only if enabled.
+ *        v is the velocity relative to the operating velocity and u the torque reference.
+ */
+typedef struct {
+    int step;
+    int counter;
+    int settling_length;
+    int excitation_length;
+    int resonance;              // fit the resonant model
+    double velocity;            // operating velocity [rpm]
+    double amplitude;           // PRBS amplitude [mNm]
+    double bandwidth;           // requested bandwidth [Hz]
+    int resolution;             // [ticks/rotation]
+    double T_s;                 // [s]
+    unsigned prbs_register;
+    double torque_offset;       // integral of the velocity controller [mNm]
+
+    double velocity_1n[4];      // previous velocities relative to the operating velocity
+    double torque_1n[PLANT_ID_MAX_DELAY+3]; // previous torque references
+
+    double rigid_theta[PLANT_ID_MAX_DELAY+1][3];
+    double rigid_P[PLANT_ID_MAX_DELAY+1][9];
+    double rigid_residual[PLANT_ID_MAX_DELAY+1];
+    double resonant_theta[PLANT_ID_RESONANT_ORDER];
+    double resonant_P[PLANT_ID_RESONANT_ORDER*PLANT_ID_RESONANT_ORDER];
+    double resonant_residual;
+    double change_1n[2];        // previous velocity changes simulated by the resonant model
+
+    PlantModel model;
+} PlantIdentificationParam;
+
+/**
+ * @brief Starts the identification.
+ *
+ * @param velocity      operating velocity [rpm], the velocity has to stay on one side of 0 during the identification
+ * @param amplitude     amplitude of the PRBS added to the torque reference [mNm]
+ * @param bandwidth     requested bandwidth of the velocity controller [Hz]
+ * @param resonance     1 to identify the first resonance as well, 0 for a rigid plant only
+ * @param resolution    resolution of the position sensor [ticks/rotation]
+ * @param T_s           sampling-time in us (microseconds)
+ * @param param         identification
+ *
+ * @return 0 if started, -1 if a parameter is not valid
+ */
+int plant_identification_init(int velocity, int amplitude, int bandwidth, int resonance, int resolution, int T_s,
+        REFERENCE_PARAM(PlantIdentificationParam, param));
+
+/**
+ * @brief Executes one period of the identification, the step changes to PLANT_ID_DONE or PLANT_ID_FAILED at the end.
+ *
+ * @param velocity  actual velocity [rpm]
+ * @param param     identification
+ *
+ * @return torque reference [mNm], 0 once the identification has ended
+ */
+double plant_identification_update(double velocity, REFERENCE_PARAM(PlantIdentificationParam, param));
@@ -0,0 +1,104 @@
+/**
+ * @file relay_tune.h
+ * @brief Relay feedback (Astrom-Hagglund) tuner of the cascaded velocity and position controllers
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Number of oscillation cycles which are ignored before the relay oscillation is measured.
+ */
+#define RELAY_TUNE_SETTLING_CYCLES  2
+
+/**
+ * @brief Maximum duration of each step of the relay tuner [s], the tuning fails if it has not measured enough cycles by then.
+ */
+#define RELAY_TUNE_TIMEOUT          3.0
+
+/**
+ * @brief Rules deriving the PID constants from the ultimate gain Ku and period Tu.
+ */
+typedef enum {
+    RELAY_TUNE_ZIEGLER_NICHOLS  = 0,    /**< Kp = 0.6 Ku,  Ti = Tu/2,   Td = Tu/8 */
+    RELAY_TUNE_TYREUS_LUYBEN    = 1,    /**< Kp = Ku/2.2,  Ti = 2.2 Tu, Td = Tu/6.3 */
+    RELAY_TUNE_SOME_OVERSHOOT   = 2,    /**< Kp = Ku/3,    Ti = Tu/2,   Td = Tu/3 */
+    RELAY_TUNE_NO_OVERSHOOT     = 3     /**< Kp = Ku/5,    Ti = Tu/2,   Td = Tu/3 */
+} RelayTuneRule;
+
+/**
+ * @brief Steps of the relay tuner.
+ */
+typedef enum {
+    RELAY_TUNE_IDLE             = 0,    /**< Not started */
+    RELAY_TUNE_VELOCITY_LOOP    = 1,    /**< Torque relay around zero velocity */
+    RELAY_TUNE_POSITION_LOOP    = 2,    /**< Velocity relay around the start position, with the tuned velocity controller */
+    RELAY_TUNE_DONE             = 3,    /**< Velocity and position constants are valid */
+    RELAY_TUNE_FAILED           = 4     /**< No stable oscillation within RELAY_TUNE_TIMEOUT */
+} RelayTuneStep;
+
+/**
+ * @brief Structure type of the relay tuner. The constants have the scaling of MotionControlConfig.
+ */
+typedef struct {
+    int step;
+    int rule;
+    int cycles;                 // measured cycles per step
+    double torque_amplitude;    // relay of the velocity step [mNm]
+    double velocity_amplitude;  // relay of the position step [rpm]
+    double velocity_hysteresis; // [rpm]
+    double position_hysteresis; // [ticks]
+    double T_s;                 // [s]
+
+    double setpoint;
+    double output;
+    int counter;
+    int rising_edge_counter;
+    int n_edges;
+    double maximum;
+    double minimum;
+    double amplitude_sum;
+    double period_sum;
+    int n_periods;
+
+    double ultimate_gain;       // of the last step
+    double ultimate_period;     // of the last step [s]
+
+    int velocity_kp;
+    int velocity_ki;
+    int velocity_kd;
+    int position_kp;
+    int position_ki;
+    int position_kd;
+} RelayTuneParam;
+
+/**
+ * @brief Starts the relay tuner with the velocity step.
+ *
+ * @param torque_amplitude      amplitude of the torque relay of the velocity step [mNm]
+ * @param velocity_amplitude    amplitude of the velocity relay of the position step [rpm]
+ * @param velocity_hysteresis   hysteresis of the velocity step [rpm], above the noise of the velocity
+ * @param position_hysteresis   hysteresis of the position step [ticks], above the noise of the position
+ * @param cycles                number of measured oscillation cycles per step
+ * @param rule                  tuning rule (see RelayTuneRule)
+ * @param T_s                   sampling-time in us (microseconds)
+ * @param param                 relay tuner
+ *
+ * @return 0 if started, -1 if a parameter is not valid
+ */
+int relay_tune_init(int torque_amplitude, int velocity_amplitude, int velocity_hysteresis, int position_hysteresis,
+        int cycles, int rule, int T_s, REFERENCE_PARAM(RelayTuneParam, param));
+
+/**
+ * @brief Executes one period of the relay tuner. In the velocity step the output is the torque reference and the
+ *        actual value the velocity, in the position step the output is the velocity reference and the actual value the position.
+ *        The step changes once enough cycles are measured.
+ *
+ * @param actual_value  actual velocity [rpm] or position [ticks]
+ * @param param         relay tuner
+ *
+ * @return output of the relay, 0 once the tuning is done or failed
+ */
+double relay_tune_update(double actual_value, REFERENCE_PARAM(RelayTuneParam, param));
@@ -0,0 +1,256 @@
+/**
+ * @file frequency_response.c
+ * @brief Frequency response analyzer measuring the plant and the closed loop with an injected excitation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <frequency_response.h>
+#include <math.h>
+
+#define FREQUENCY_RESPONSE_PI           3.14159265359
+#define FREQUENCY_RESPONSE_PRBS_SEED    0x7fff
+
+/*
+ * restarts the excitation at the beginning of a period, so it repeats with the record length
+ */
+static void frequency_response_restart(FrequencyResponseParam * param)
+{
+    int n = param->config.n_points;
+
+    //Schroeder phases keep the crest factor of the multisine low
+    for (int i=0; i<n; i++)
+    {
+        double phase = -(FREQUENCY_RESPONSE_PI * ((double)i) * ((double)(i+1))) / ((double)n);
+        param->sine_cos[i] = cos(phase);
+        param->sine_sin[i] = sin(phase);
+    }
+
+    param->chirp_phase = 0.00;
+    param->chirp_omega = param->chirp_omega_start;
+
+    param->prbs_register = FREQUENCY_RESPONSE_PRBS_SEED;
+    param->prbs_value = param->amplitude;
+}
+
+void frequency_response_init(FrequencyResponseParam * param)
+{
+    param->status = FREQUENCY_RESPONSE_IDLE;
+    param->config.n_points = 0;
+    param->counter = 0;
+    param->n_samples = 0;
+}
+
+int frequency_response_start(FrequencyResponseConfig config, int T_s, FrequencyResponseParam * param)
+{
+    int bin, bin_1n = 0;
+    double omega_max;
+
+    if (config.excitation < FREQUENCY_RESPONSE_MULTISINE || config.excitation > FREQUENCY_RESPONSE_PRBS)
+        return -1;
+    if (config.injection < FREQUENCY_RESPONSE_TORQUE || config.injection > FREQUENCY_RESPONSE_VELOCITY)
+        return -1;
+    if (config.n_points <= 0 || config.n_points > FREQUENCY_RESPONSE_MAX_POINTS)
+        return -1;
+    if (config.amplitude <= 0 || config.record_length <= 2 || config.periods <= 0 || T_s <= 0)
+        return -1;
+
+    //round the frequencies to the bins of the record
+    for (int i=0; i<config.n_points; i++)
+    {
+        bin = (int)floor((((double)config.frequency[i]) * ((double)config.record_length) * ((double)T_s))/1000000.00 + 0.50);
+        if (bin <= bin_1n || 2*bin >= config.record_length)
+            return -1;
+        param->omega[i] = (2.00 * FREQUENCY_RESPONSE_PI * ((double)bin)) / ((double)config.record_length);
+        param->coefficient[i] = 2.00 * cos(param->omega[i]);
+        param->rotation[i] = sin(param->omega[i]);
+        bin_1n = bin;
+    }
+
+    param->config = config;
+    param->T_s = ((double)T_s)/1000000.00;
+    omega_max = param->omega[config.n_points-1];
+
+    if (config.excitation == FREQUENCY_RESPONSE_MULTISINE)
+        param->amplitude = ((double)config.amplitude) / sqrt(2.00 * ((double)config.n_points));
+    else
+        param->amplitude = (double)config.amplitude;
+
+    //logarithmic sweep over one record
+    param->chirp_omega_start = param->omega[0];
+    param->chirp_ratio = exp(log(omega_max / param->omega[0]) / ((double)config.record_length));
+
+    //bits of the sequence are held so its spectrum is flat up to the highest frequency
+    param->prbs_hold = (int)floor((0.40 * 2.00 * FREQUENCY_RESPONSE_PI) / omega_max);
+    if (param->prbs_hold < 1)
+        param->prbs_hold = 1;
+
+    for (int i=0; i<config.n_points; i++)
+    {
+        param->excitation_1n[i] = 0.00;
+        param->excitation_2n[i] = 0.00;
+        param->torque_1n[i] = 0.00;
+        param->torque_2n[i] = 0.00;
+        param->velocity_1n[i] = 0.00;
+        param->velocity_2n[i] = 0.00;
+    }
+
+    param->counter = 0;
+    param->n_samples = config.record_length * (config.periods + 1);
+    param->status = FREQUENCY_RESPONSE_RUNNING;
+
+    return 0;
+}
+
+double frequency_response_excitation(FrequencyResponseParam * param)
+{
+    int k;
+    double value = 0.00, c;
+
+    if (param->status != FREQUENCY_RESPONSE_RUNNING)
+        return 0.00;
+
+    k = param->counter % param->config.record_length;
+    if (k == 0)
+        frequency_response_restart(param);
+
+    switch (param->config.excitation)
+    {
+    case FREQUENCY_RESPONSE_MULTISINE:
+        for (int i=0; i<param->config.n_points; i++)
+        {
+            value += param->sine_sin[i];
+
+            //rotate the oscillator by omega
+            c = param->sine_cos[i];
+            param->sine_cos[i] = (c * param->coefficient[i] * 0.50) - (param->sine_sin[i] * param->rotation[i]);
+            param->sine_sin[i] = (param->sine_sin[i] * param->coefficient[i] * 0.50) + (c * param->rotation[i]);
+        }
+        value *= param->amplitude;
+        if (value > (double)param->config.amplitude)
+            value = (double)param->config.amplitude;
+        else if (value < -(double)param->config.amplitude)
+            value = -(double)param->config.amplitude;
+        break;
+
+    case FREQUENCY_RESPONSE_CHIRP:
+        value = param->amplitude * sin(param->chirp_phase);
+        param->chirp_phase += param->chirp_omega;
+        param->chirp_omega *= param->chirp_ratio;
+        break;
+
+    case FREQUENCY_RESPONSE_PRBS:
+        if ((k % param->prbs_hold) == 0)
+        {
+            //maximum length sequence x^15 + x^14 + 1
+            unsigned bit = ((param->prbs_register >> 14) ^ (param->prbs_register >> 13)) & 1;
+            param->prbs_register = ((param->prbs_register << 1) | bit) & 0x7fff;
+            param->prbs_value = bit ? param->amplitude : -param->amplitude;
+        }
+        value = param->prbs_value;
+        break;
+    }
+
+    return value;
+}
+
+void frequency_response_update(double excitation, int torque, int velocity, FrequencyResponseParam * param)
+{
+    double s;
+
+    if (param->status != FREQUENCY_RESPONSE_RUNNING)
+        return;
+
+    //the first period lets the loop settle
+    if (param->counter >= param->config.record_length)
+    {
+        for (int i=0; i<param->config.n_points; i++)
+        {
+            s = excitation + (param->coefficient[i] * param->excitation_1n[i]) - param->excitation_2n[i];
+            param->excitation_2n[i] = param->excitation_1n[i];
+            param->excitation_1n[i] = s;
+
+            s = ((double)torque) + (param->coefficient[i] * param->torque_1n[i]) - param->torque_2n[i];
+            param->torque_2n[i] = param->torque_1n[i];
+            param->torque_1n[i] = s;
+
+            s = ((double)velocity) + (param->coefficient[i] * param->velocity_1n[i]) - param->velocity_2n[i];
+            param->velocity_2n[i] = param->velocity_1n[i];
+            param->velocity_1n[i] = s;
+        }
+    }
+
+    param->counter++;
+    if (param->counter >= param->n_samples)
+        param->status = FREQUENCY_RESPONSE_DONE;
+}
+
+void frequency_response_stop(FrequencyResponseParam * param)
+{
+    if (param->status == FREQUENCY_RESPONSE_RUNNING)
+        param->status = FREQUENCY_RESPONSE_IDLE;
+}
+
+/*
+ * ratio of two Goertzel outputs y/u at the same frequency in 0.01 dB and 0.01 degree,
+ * the common phase factor of the outputs cancels
+ */
+static void frequency_response_ratio(double y_1n, double y_2n, double u_1n, double u_2n, double omega, double scale,
+        int * magnitude, int * phase)
+{
+    //s(N-1) - exp(-j*omega)*s(N-2) is the DFT bin times exp(j*omega*(N-1))
+    double y_re = y_1n - (cos(omega) * y_2n), y_im = sin(omega) * y_2n;
+    double u_re = u_1n - (cos(omega) * u_2n), u_im = sin(omega) * u_2n;
+    double den = (u_re * u_re) + (u_im * u_im);
+    double h_re, h_im, h_abs;
+
+    if (den <= 0.00)
+    {
+        *magnitude = 0;
+        *phase = 0;
+        return;
+    }
+
+    h_re = ((y_re * u_re) + (y_im * u_im)) / den;
+    h_im = ((y_im * u_re) - (y_re * u_im)) / den;
+    h_abs = sqrt((h_re * h_re) + (h_im * h_im)) * scale;
+
+    if (h_abs < 1e-12)
+        h_abs = 1e-12;
+
+    *magnitude = (int)floor((2000.00 * log10(h_abs)) + 0.50);
+    *phase = (int)floor(((18000.00 / FREQUENCY_RESPONSE_PI) * atan2(h_im, h_re)) + 0.50);
+}
+
+void frequency_response_result(FrequencyResponseParam * param, FrequencyResponse * response)
+{
+    int n = param->config.n_points;
+
+    response->status = param->status;
+    response->n_points = n;
+
+    for (int i=0; i<n; i++)
+    {
+        response->frequency[i] = (int)floor(((param->omega[i] * 1000.00) / (2.00 * FREQUENCY_RESPONSE_PI * param->T_s)) + 0.50);
+        response->plant_magnitude[i] = 0;
+        response->plant_phase[i] = 0;
+        response->closed_loop_magnitude[i] = 0;
+        response->closed_loop_phase[i] = 0;
+    }
+
+    if (param->status != FREQUENCY_RESPONSE_DONE)
+        return;
+
+    for (int i=0; i<n; i++)
+    {
+        //velocity [rpm] per torque [Nm]
+        frequency_response_ratio(param->velocity_1n[i], param->velocity_2n[i], param->torque_1n[i], param->torque_2n[i],
+                param->omega[i], 1000.00, &response->plant_magnitude[i], &response->plant_phase[i]);
+
+        if (param->config.injection == FREQUENCY_RESPONSE_TORQUE)
+            frequency_response_ratio(param->torque_1n[i], param->torque_2n[i], param->excitation_1n[i], param->excitation_2n[i],
+                    param->omega[i], 1.00, &response->closed_loop_magnitude[i], &response->closed_loop_phase[i]);
+        else
+            frequency_response_ratio(param->velocity_1n[i], param->velocity_2n[i], param->excitation_1n[i], param->excitation_2n[i],
+                    param->omega[i], 1.00, &response->closed_loop_magnitude[i], &response->closed_loop_phase[i]);
+    }
+}
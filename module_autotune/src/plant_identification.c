@@ -0,0 +1,354 @@
+/**
+ * @file plant_identification.c
+ * @brief Commissioning identification of the mechanical plant with a PRBS excitation of the velocity loop
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <plant_identification.h>
+#include <math.h>
+
+#define PLANT_ID_PI                 3.14159265359
+#define PLANT_ID_RPM_TO_RAD         (2.00 * PLANT_ID_PI / 60.00)
+#define PLANT_ID_PRBS_SEED          0x7fff
+#define PLANT_ID_INITIAL_COVARIANCE 1.0e4
+
+/*
+ * integral corner of the velocity controller during the settling [rad/s]
+ */
+#define PLANT_ID_INTEGRAL_OMEGA     (2.00 * PLANT_ID_PI * 2.00)
+
+/*
+ * velocity bandwidth times the delay of the loop [rad], keeps a phase margin of about 45 degrees with the PI controller
+ */
+#define PLANT_ID_DELAY_MARGIN       0.54
+
+/*
+ * an identified pole pair below a quarter of the sampling frequency is a resonance if its damping is below this value
+ * and the resonant model reduces the residual of the best rigid model by this factor
+ */
+#define PLANT_ID_RESONANCE_DAMPING  0.30
+#define PLANT_ID_RESONANCE_RESIDUAL 0.80
+
+/*
+ * one recursive instrumental variable update of the n parameters theta with the regressor phi and the instruments zeta,
+ * with the a priori error added to the residual
+ */
+static void plant_identification_riv(double * theta, double * P, const double * phi, const double * zeta, int n,
+        double y, double * residual)
+{
+    double p_zeta[PLANT_ID_RESONANT_ORDER], phi_p[PLANT_ID_RESONANT_ORDER];
+    double den = 1.00, inv_den, error = y;
+
+    for (int i=0; i<n; i++)
+    {
+        p_zeta[i] = 0.00;
+        phi_p[i] = 0.00;
+        for (int j=0; j<n; j++)
+        {
+            p_zeta[i] += P[(i*n)+j] * zeta[j];
+            phi_p[i] += phi[j] * P[(j*n)+i];
+        }
+        error -= theta[i] * phi[i];
+    }
+    for (int i=0; i<n; i++)
+        den += phi[i] * p_zeta[i];
+    inv_den = 1.00 / den;
+
+    *residual += error * error;
+
+    //P = P - P*zeta*phi'*P/den, gain P*zeta/den
+    for (int i=0; i<n; i++)
+    {
+        double gain = p_zeta[i] * inv_den;
+
+        theta[i] += gain * error;
+        for (int j=0; j<n; j++)
+            P[(i*n)+j] -= gain * phi_p[j];
+    }
+}
+
+static void plant_identification_reset(double * theta, double * P, int n)
+{
+    for (int i=0; i<n; i++)
+    {
+        theta[i] = 0.00;
+        for (int j=0; j<n; j++)
+            P[(i*n)+j] = (i == j) ? PLANT_ID_INITIAL_COVARIANCE : 0.00;
+    }
+}
+
+/*
+ * first resonance of the resonant model, the pole pair of z^2 - a1*z - a2.
+ * The rigid body is returned as the equivalent first order model a, b, c.
+ */
+static int plant_identification_resonance(PlantIdentificationParam * param, double * a, double * b, double * c,
+        double * omega, double * damping)
+{
+    double p = -param->resonant_theta[0], q = -param->resonant_theta[1];
+    double rho, theta, sigma;
+
+    if (((p * p) - (4.00 * q)) >= 0.00 || q <= 0.00 || q >= 1.00)
+        return 0;
+
+    rho = sqrt(q);
+    theta = acos(-p / (2.00 * rho));
+    sigma = log(rho) / param->T_s;
+    *omega = sqrt((sigma * sigma) + ((theta / param->T_s) * (theta / param->T_s)));
+    *damping = -sigma / *omega;
+
+    //low frequency gains over the resonant factor
+    *a = 1.00 + (param->resonant_theta[2] / (1.00 + p + q));
+    *b = 0.00;
+    for (int i=3; i<(PLANT_ID_RESONANT_ORDER-1); i++)
+        *b += param->resonant_theta[i];
+    *b /= 1.00 + p + q;
+    *c = param->resonant_theta[PLANT_ID_RESONANT_ORDER-1] / (1.00 + p + q);
+
+    return 1;
+}
+
+/*
+ * plant and gains from the fitted models at the end of the excitation
+ */
+static void plant_identification_model(PlantIdentificationParam * param)
+{
+    PlantModel * model = &param->model;
+    double a, b, c, inertia, viscous, coulomb, omega_c, omega_limit, kp;
+    double omega_r = 0.00, damping_r = 0.00;
+    int delay = 0;
+
+    for (int d=1; d<=PLANT_ID_MAX_DELAY; d++)
+        if (param->rigid_residual[d] < param->rigid_residual[delay])
+            delay = d;
+
+    a = param->rigid_theta[delay][0];
+    b = param->rigid_theta[delay][1] / param->amplitude;
+    c = param->rigid_theta[delay][2];
+
+    //the resonant model replaces the rigid one if it fits clearly better
+    if (param->resonance &&
+            param->resonant_residual < (PLANT_ID_RESONANCE_RESIDUAL * param->rigid_residual[delay]))
+    {
+        double a_r, b_r, c_r;
+        if (plant_identification_resonance(param, &a_r, &b_r, &c_r, &omega_r, &damping_r) &&
+                damping_r < PLANT_ID_RESONANCE_DAMPING && omega_r < (PLANT_ID_PI / (2.00 * param->T_s)))
+        {
+            a = a_r;
+            b = b_r / param->amplitude;
+            c = c_r;
+        }
+        else
+        {
+            omega_r = 0.00;
+            damping_r = 0.00;
+        }
+    }
+
+    //a time constant below 2 periods or a negative gain is not a mechanical plant
+    if (b <= 0.00 || a < 0.60 || a > 1.01)
+    {
+        param->step = PLANT_ID_FAILED;
+        model->status = PLANT_ID_FAILED;
+        return;
+    }
+
+    //J*dw/dt = u - B*w - Fc*sign(w), sampled: a = exp(-B*T_s/J), b = (1-a)/B [rpm/mNm]
+    if (a < 1.00)
+    {
+        viscous = (1.00 - a) / b;                                                   // mNm/rpm
+        inertia = ((viscous / PLANT_ID_RPM_TO_RAD) * param->T_s) / (-log(a));       // mNm/(rad/s^2)
+    }
+    else
+    {
+        viscous = 0.00;
+        inertia = param->T_s / (b * PLANT_ID_RPM_TO_RAD);
+    }
+    coulomb = (-(c / b) - (viscous * param->velocity)) * ((param->velocity > 0.00) ? 1.00 : -1.00);
+
+    //the requested bandwidth, limited by the delay of the loop and the resonance
+    omega_c = 2.00 * PLANT_ID_PI * param->bandwidth;
+    omega_limit = PLANT_ID_DELAY_MARGIN / (((double)(delay + 1)) * param->T_s);
+    if (omega_c > omega_limit)
+        omega_c = omega_limit;
+    if (omega_r > 0.00 && omega_c > (omega_r / 3.00))
+        omega_c = omega_r / 3.00;
+
+    //PI velocity controller with the integral corner at a quarter of the bandwidth
+    kp = inertia * omega_c * PLANT_ID_RPM_TO_RAD;                                   // mNm/rpm
+    model->velocity_kp = (int)floor((kp * 1000000.00) + 0.50);
+    model->velocity_ki = (int)floor((kp * param->T_s * (omega_c / 4.00) * 1000000.00) + 0.50);
+
+    //P position controller [rpm/tick] at a quarter of the velocity bandwidth
+    model->position_kp = (int)floor((((omega_c / 4.00) * 60.00) / ((double)param->resolution)) * 1000000.00 + 0.50);
+
+    model->moment_of_inertia = (int)floor((inertia * 10000.00) + 0.50);
+    model->viscous_friction = (int)floor((viscous * 1000.00) + 0.50);
+    model->coulomb_friction = (coulomb > 0.00) ? (int)floor(coulomb + 0.50) : 0;
+    model->delay = delay;
+    model->resonance_frequency = (int)floor((omega_r / (2.00 * PLANT_ID_PI)) + 0.50);
+    model->resonance_damping = (int)floor((damping_r * 1000.00) + 0.50);
+    model->bandwidth = (int)floor((omega_c / (2.00 * PLANT_ID_PI)) + 0.50);
+
+    param->step = PLANT_ID_DONE;
+    model->status = PLANT_ID_DONE;
+}
+
+int plant_identification_init(int velocity, int amplitude, int bandwidth, int resonance, int resolution, int T_s,
+        PlantIdentificationParam * param)
+{
+    param->model.status = PLANT_ID_FAILED;
+
+    if (velocity == 0 || amplitude <= 0 || bandwidth <= 0 || resolution <= 0 || T_s <= 0)
+    {
+        param->step = PLANT_ID_FAILED;
+        return -1;
+    }
+
+    param->velocity = (double)velocity;
+    param->amplitude = (double)amplitude;
+    param->bandwidth = (double)bandwidth;
+    param->resonance = resonance;
+    param->resolution = resolution;
+    param->T_s = ((double)T_s) / 1000000.00;
+    param->settling_length = (int)floor((PLANT_ID_SETTLING_TIME / param->T_s) + 0.50);
+    param->excitation_length = (int)floor(((resonance ? PLANT_ID_RESONANCE_EXCITATION_TIME : PLANT_ID_EXCITATION_TIME) / param->T_s) + 0.50);
+    param->prbs_register = PLANT_ID_PRBS_SEED;
+    param->torque_offset = 0.00;
+
+    for (int i=0; i<4; i++)
+        param->velocity_1n[i] = 0.00;
+    for (int i=0; i<(PLANT_ID_MAX_DELAY+3); i++)
+        param->torque_1n[i] = 0.00;
+
+    for (int d=0; d<=PLANT_ID_MAX_DELAY; d++)
+    {
+        plant_identification_reset(param->rigid_theta[d], param->rigid_P[d], 3);
+        param->rigid_residual[d] = 0.00;
+    }
+    plant_identification_reset(param->resonant_theta, param->resonant_P, PLANT_ID_RESONANT_ORDER);
+    param->change_1n[0] = 0.00;
+    param->change_1n[1] = 0.00;
+    param->resonant_residual = 0.00;
+
+    param->model.moment_of_inertia = 0;
+    param->model.viscous_friction = 0;
+    param->model.coulomb_friction = 0;
+    param->model.delay = 0;
+    param->model.resonance_frequency = 0;
+    param->model.resonance_damping = 0;
+    param->model.bandwidth = 0;
+    param->model.velocity_kp = 0;
+    param->model.velocity_ki = 0;
+    param->model.position_kp = 0;
+
+    param->counter = 0;
+    param->step = PLANT_ID_SETTLING;
+    param->model.status = PLANT_ID_SETTLING;
+
+    return 0;
+}
+
+double plant_identification_update(double velocity, PlantIdentificationParam * param)
+{
+    double v, torque, residual, phi[PLANT_ID_RESONANT_ORDER], zeta[PLANT_ID_RESONANT_ORDER];
+
+    if (param->step != PLANT_ID_SETTLING && param->step != PLANT_ID_EXCITING)
+        return 0.00;
+
+    //the velocity relative to the operating velocity keeps the regression well conditioned
+    v = velocity - param->velocity;
+    param->counter++;
+
+    if (param->step == PLANT_ID_EXCITING)
+    {
+        //the instruments of the velocities are the velocities older than the order of the model,
+        //they do not correlate with the noise of the equation error.
+        //The residuals of the first half include the convergence and are not compared.
+        for (int d=0; d<=PLANT_ID_MAX_DELAY; d++)
+        {
+            phi[0] = param->velocity_1n[0];
+            phi[1] = param->torque_1n[d] / param->amplitude;
+            phi[2] = 1.00;
+            zeta[0] = param->velocity_1n[1];
+            zeta[1] = phi[1];
+            zeta[2] = 1.00;
+            residual = 0.00;
+            plant_identification_riv(param->rigid_theta[d], param->rigid_P[d], phi, zeta, 3, v, &residual);
+            if ((2 * param->counter) > param->excitation_length)
+                param->rigid_residual[d] += residual;
+        }
+
+        //the resonant model is fitted to the velocity change, its instruments are the changes simulated by the model itself.
+        //It is compared by the error of the simulated change, the equation error amplifies the noise by the resonant poles.
+        if (param->resonance)
+        {
+            double * theta = param->resonant_theta;
+            int stable = (-theta[1] < 0.98) && (fabs(theta[0]) < (1.00 - theta[1]));
+            double change = v - param->velocity_1n[0];
+            double change_model;
+
+            for (int i=0; i<2; i++)
+            {
+                phi[i] = param->velocity_1n[i] - param->velocity_1n[i+1];
+                zeta[i] = stable ? param->change_1n[i] : phi[i];
+            }
+            phi[2] = param->velocity_1n[0];
+            zeta[2] = param->velocity_1n[3];
+            for (int i=0; i<(PLANT_ID_MAX_DELAY+3); i++)
+            {
+                phi[3+i] = param->torque_1n[i] / param->amplitude;
+                zeta[3+i] = phi[3+i];
+            }
+            phi[PLANT_ID_RESONANT_ORDER-1] = 1.00;
+            zeta[PLANT_ID_RESONANT_ORDER-1] = 1.00;
+
+            //simulated change, with the simulated changes instead of the measured ones
+            change_model = (theta[0] * zeta[0]) + (theta[1] * zeta[1]);
+            for (int i=2; i<PLANT_ID_RESONANT_ORDER; i++)
+                change_model += theta[i] * phi[i];
+
+            residual = 0.00;
+            plant_identification_riv(theta, param->resonant_P, phi, zeta, PLANT_ID_RESONANT_ORDER, change, &residual);
+            if (stable)
+                residual = (change - change_model) * (change - change_model);
+            if ((2 * param->counter) > param->excitation_length)
+                param->resonant_residual += residual;
+
+            param->change_1n[1] = param->change_1n[0];
+            param->change_1n[0] = stable ? change_model : change;
+        }
+
+        if (param->counter >= param->excitation_length)
+        {
+            plant_identification_model(param);
+            return 0.00;
+        }
+    }
+    else if (param->counter >= param->settling_length)
+    {
+        param->step = PLANT_ID_EXCITING;
+        param->model.status = PLANT_ID_EXCITING;
+        param->counter = 0;
+    }
+
+    //weak PI controller holding the operating velocity, its integral is frozen during the excitation
+    if (param->step == PLANT_ID_SETTLING)
+        param->torque_offset -= PLANT_ID_VELOCITY_KP * PLANT_ID_INTEGRAL_OMEGA * param->T_s * v;
+    torque = param->torque_offset - (PLANT_ID_VELOCITY_KP * v);
+
+    if (param->step == PLANT_ID_EXCITING)
+    {
+        unsigned bit = ((param->prbs_register >> 14) ^ (param->prbs_register >> 13)) & 1;
+        param->prbs_register = ((param->prbs_register << 1) | bit) & 0x7fff;
+        torque += bit ? param->amplitude : -param->amplitude;
+    }
+
+    for (int i=3; i>0; i--)
+        param->velocity_1n[i] = param->velocity_1n[i-1];
+    param->velocity_1n[0] = v;
+    for (int i=(PLANT_ID_MAX_DELAY+2); i>0; i--)
+        param->torque_1n[i] = param->torque_1n[i-1];
+    param->torque_1n[0] = torque;
+
+    return torque;
+}
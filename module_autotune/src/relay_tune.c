@@ -0,0 +1,175 @@
+/**
+ * @file relay_tune.c
+ * @brief Relay feedback (Astrom-Hagglund) tuner of the cascaded velocity and position controllers
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <relay_tune.h>
+#include <math.h>
+
+#define RELAY_TUNE_PI   3.14159265359
+
+/*
+ * Kp/Ku, Ti/Tu and Td/Tu of the tuning rules
+ */
+static const double relay_tune_rules[4][3] = {
+        {0.60,       0.50, 0.125},
+        {1.00/2.20,  2.20, 1.00/6.30},
+        {1.00/3.00,  0.50, 1.00/3.00},
+        {0.20,       0.50, 1.00/3.00}
+};
+
+static void relay_tune_start_step(int step, double setpoint, RelayTuneParam * param)
+{
+    param->step = step;
+    param->setpoint = setpoint;
+    param->output = (step == RELAY_TUNE_VELOCITY_LOOP) ? param->torque_amplitude : param->velocity_amplitude;
+    param->counter = 0;
+    param->rising_edge_counter = 0;
+    param->n_edges = 0;
+    param->maximum = setpoint;
+    param->minimum = setpoint;
+    param->amplitude_sum = 0.00;
+    param->period_sum = 0.00;
+    param->n_periods = 0;
+}
+
+/*
+ * PID constants in the scaling of pid_update from the ultimate gain and period
+ */
+static void relay_tune_gains(double ku, double tu, int derivative, RelayTuneParam * param, int * kp, int * ki, int * kd)
+{
+    double p = relay_tune_rules[param->rule][0] * ku;
+    double ti = relay_tune_rules[param->rule][1] * tu;
+    double td = derivative ? relay_tune_rules[param->rule][2] * tu : 0.00;
+
+    *kp = (int)floor((p * 1000000.00) + 0.50);
+    *ki = (int)floor((p * (param->T_s / ti) * 1000000.00) + 0.50);
+    *kd = (int)floor((p * (td / param->T_s) * 1000000.00) + 0.50);
+}
+
+int relay_tune_init(int torque_amplitude, int velocity_amplitude, int velocity_hysteresis, int position_hysteresis,
+        int cycles, int rule, int T_s, RelayTuneParam * param)
+{
+    if (torque_amplitude <= 0 || velocity_amplitude <= 0 || velocity_hysteresis < 0 || position_hysteresis < 0 ||
+            cycles <= 0 || rule < RELAY_TUNE_ZIEGLER_NICHOLS || rule > RELAY_TUNE_NO_OVERSHOOT || T_s <= 0)
+    {
+        param->step = RELAY_TUNE_FAILED;
+        return -1;
+    }
+
+    param->rule = rule;
+    param->cycles = cycles;
+    param->torque_amplitude = (double)torque_amplitude;
+    param->velocity_amplitude = (double)velocity_amplitude;
+    param->velocity_hysteresis = (double)velocity_hysteresis;
+    param->position_hysteresis = (double)position_hysteresis;
+    param->T_s = ((double)T_s)/1000000.00;
+
+    param->ultimate_gain = 0.00;
+    param->ultimate_period = 0.00;
+    param->velocity_kp = 0;
+    param->velocity_ki = 0;
+    param->velocity_kd = 0;
+    param->position_kp = 0;
+    param->position_ki = 0;
+    param->position_kd = 0;
+
+    relay_tune_start_step(RELAY_TUNE_VELOCITY_LOOP, 0.00, param);
+
+    return 0;
+}
+
+double relay_tune_update(double actual_value, RelayTuneParam * param)
+{
+    double error, hysteresis, amplitude, d;
+
+    if (param->step != RELAY_TUNE_VELOCITY_LOOP && param->step != RELAY_TUNE_POSITION_LOOP)
+        return 0.00;
+
+    //the position step oscillates around the position at its start
+    if (param->step == RELAY_TUNE_POSITION_LOOP && param->counter == 0)
+    {
+        param->setpoint = actual_value;
+        param->maximum = actual_value;
+        param->minimum = actual_value;
+    }
+
+    param->counter++;
+    if (((double)param->counter) * param->T_s > RELAY_TUNE_TIMEOUT)
+    {
+        param->step = RELAY_TUNE_FAILED;
+        return 0.00;
+    }
+
+    if (param->step == RELAY_TUNE_VELOCITY_LOOP)
+    {
+        hysteresis = param->velocity_hysteresis;
+        d = param->torque_amplitude;
+    }
+    else
+    {
+        hysteresis = param->position_hysteresis;
+        d = param->velocity_amplitude;
+    }
+
+    if (actual_value > param->maximum)
+        param->maximum = actual_value;
+    if (actual_value < param->minimum)
+        param->minimum = actual_value;
+
+    error = param->setpoint - actual_value;
+
+    if (param->output < 0.00 && error > hysteresis)
+    {
+        //rising edge of the relay, one cycle ends
+        param->output = d;
+        param->n_edges++;
+
+        if (param->n_edges > RELAY_TUNE_SETTLING_CYCLES)
+        {
+            param->amplitude_sum += (param->maximum - param->minimum) / 2.00;
+            param->period_sum += ((double)(param->counter - param->rising_edge_counter)) * param->T_s;
+            param->n_periods++;
+        }
+        param->rising_edge_counter = param->counter;
+        param->maximum = actual_value;
+        param->minimum = actual_value;
+
+        if (param->n_periods >= param->cycles)
+        {
+            amplitude = param->amplitude_sum / ((double)param->n_periods);
+            if (amplitude <= hysteresis)
+            {
+                param->step = RELAY_TUNE_FAILED;
+                return 0.00;
+            }
+
+            //describing function of the relay with hysteresis
+            param->ultimate_gain = (4.00 * d) / (RELAY_TUNE_PI * sqrt((amplitude * amplitude) - (hysteresis * hysteresis)));
+            param->ultimate_period = param->period_sum / ((double)param->n_periods);
+
+            if (param->step == RELAY_TUNE_VELOCITY_LOOP)
+            {
+                //PI velocity controller, the derivative would amplify the noise of the velocity
+                relay_tune_gains(param->ultimate_gain, param->ultimate_period, 0, param,
+                        &param->velocity_kp, &param->velocity_ki, &param->velocity_kd);
+                relay_tune_start_step(RELAY_TUNE_POSITION_LOOP, 0.00, param);
+                return 0.00;
+            }
+            else
+            {
+                relay_tune_gains(param->ultimate_gain, param->ultimate_period, 1, param,
+                        &param->position_kp, &param->position_ki, &param->position_kd);
+                param->step = RELAY_TUNE_DONE;
+                return 0.00;
+            }
+        }
+    }
+    else if (param->output > 0.00 && error < -hysteresis)
+    {
+        param->output = -d;
+    }
+
+    return param->output;
+}
@@ -6,6 +6,17 @@
 #pragma once
 
 #include <motion_control_service.h>
+#include <gain_schedule.h>
+
+/**
+ * @brief Number of fractional bits of the gains of the fixed-point PID controller (Q8.24).
+ */
+#define PID_FIXED_GAIN_SHIFT    24
+
+/**
+ * @brief Number of fractional bits of the integrator and output of the fixed-point PID controller (Q48.16).
+ */
+#define PID_FIXED_STATE_SHIFT   16
 
 /**
  * @brief Structure type to set the parameters of the PID controller.
@@ -62,6 +73,236 @@ double pid_update(double desired_value, double actual_value, int T_s, PIDparam &
  */
 void pid_reset(PIDparam &param);
 
+/**
+ * @brief changing the gains of a running PID controller. The integrator is adjusted so that
+ *        the output for the given error does not change (bumpless). If the integrator would exceed
+ *        the integral limit, only the part of the change of Kp which fits into the integrator is
+ *        applied, the rest follows at the next calls as the error gets smaller.
+ * @param input, P parameter
+ * @param input, I parameter
+ * @param input, D parameter
+ * @param input, actual error of the controller
+ * @param structure including the parameters of the PID controller
+ *
+ * @return void
+ */
+void pid_set_gains_bumpless(double Kp, double Ki, double Kd, double error, PIDparam &param);
+
+/**
+ * @brief setting the gains of a PID controller from a gain schedule. The gains are only changed
+ *        if the schedule is enabled and the interpolated gains differ from the actual ones.
+ * @param schedule, the gain schedule
+ * @param input, value of the input of the schedule
+ * @param input, actual error of the controller
+ * @param structure including the parameters of the PID controller
+ *
+ * @return void
+ */
+void pid_gain_schedule_update(GainSchedule &schedule, int value, double error, PIDparam &param);
+
+
+/**
+ * @brief Structure type to set the parameters of the fixed-point PID controller.
+ *        Gains are stored in Q8.24 and are pre-scaled once when they are set,
+ *        integrator and previous measurement are kept with 16 fractional bits.
+ */
+typedef struct {
+    int Kp;                     //Q8.24
+    int Ki;                     //Q8.24
+    int Kd;                     //Q8.24
+    long long integral_limit;   //Q48.16
+    long long integral;         //Q48.16
+    int actual_value_1n;
+    int T_s;    //Sampling-Time in microseconds
+} PIDparamFixed;
+
+/**
+ * @brief intializing the parameters of the fixed-point PID controller.
+ *
+ * @param the parameters of the controller
+ *
+ * @return void
+ */
+void pid_fixed_init(PIDparamFixed &param);
+
+/**
+ * @brief setting the parameters of the fixed-point PID controller.
+ *        The gains have the same scaling as the ones of pid_set_parameters (1000000 equals a gain of 1)
+ *        and are limited to the range 0..100000000.
+ * @param input, P parameter
+ * @param input, I parameter
+ * @param input, D parameter
+ * @param input, Integral limit
+ * @param input, sample-time in us (microseconds).
+ * @param structure including the parameters of the PID controller
+ *
+ * @return void
+ */
+void pid_fixed_set_parameters(int Kp, int Ki, int Kd, int integral_limit, int T_s, PIDparamFixed &param);
+
+/**
+ * @brief updating the fixed-point PID controller. The integrator saturates at the integral limit,
+ *        the derivative part acts on the measurement.
+ * @param desired_value, the reference set point
+ * @param actual_value, the actual value (measurement)
+ * @param T_s, sampling time
+ * @param param, the structure containing the pid controller parameters
+ *
+ *
+ * @return the output of pid controller
+ */
+int pid_fixed_update(int desired_value, int actual_value, int T_s, PIDparamFixed &param);
+
+/**
+ * @brief resetting the parameters of the fixed-point PID controller.
+ * @param the parameters of the controller
+ *
+ * @return void
+ */
+void pid_fixed_reset(PIDparamFixed &param);
+
+
+/**
+ * @brief Structure type to set the parameters of the two-degree-of-freedom PID controller.
+ *        Proportional and derivative parts act on weighted setpoints, the derivative part is
+ *        low pass filtered and the integrator tracks the saturated output (back-calculation).
+ */
+typedef struct {
+    double Kp;
+    double Ki;
+    double Kd;
+    double b;                   //setpoint weight of the proportional part
+    double c;                   //setpoint weight of the derivative part
+    double derivative_filter;   //coefficient of the first order low pass filter of the derivative part
+    double tracking;            //gain of the back-calculation of the integrator
+    double output_limit;
+    double integral;
+    double derivative;          //filtered derivative part
+    double derivative_error_1n; //previous weighted error of the derivative part
+    double desired_value_1n;
+    double actual_value_1n;
+    int started;                //previous values are valid
+    int T_s;    //Sampling-Time in microseconds
+} PIDparam2DOF;
+
+/**
+ * @brief intializing the parameters of the two-degree-of-freedom PID controller.
+ *
+ * @param the parameters of the controller
+ *
+ * @return void
+ */
+void pid_2dof_init(PIDparam2DOF &param);
+
+/**
+ * @brief setting the parameters of the two-degree-of-freedom PID controller.
+ *        The gains have the same scaling as the ones of pid_set_parameters (1000000 equals a gain of 1).
+ *        If the controller is running, the integrator is adjusted so that the output does not jump (bumpless).
+ * @param input, P parameter
+ * @param input, I parameter
+ * @param input, D parameter
+ * @param input, setpoint weight of the P part (1 acts on the error, 0 on the measurement only)
+ * @param input, setpoint weight of the D part (1 acts on the error, 0 on the measurement only)
+ * @param input, cut-off frequency of the derivative filter [Hz], 0 disables the filter
+ * @param input, output limit, 0 disables the limit
+ * @param input, sample-time in us (microseconds).
+ * @param structure including the parameters of the PID controller
+ *
+ * @return void
+ */
+void pid_2dof_set_parameters(double Kp, double Ki, double Kd, double b, double c, double derivative_cutoff,
+        double output_limit, int T_s, PIDparam2DOF &param);
+
+/**
+ * @brief updating the two-degree-of-freedom PID controller. The output is saturated at the output limit
+ *        and the integrator is corrected by the saturation with a tracking time equal to the integral time.
+ * @param desired_value, the reference set point
+ * @param actual_value, the actual value (measurement)
+ * @param T_s, sampling time
+ * @param param, the structure containing the pid controller parameters
+ *
+ *
+ * @return the output of pid controller
+ */
+double pid_2dof_update(double desired_value, double actual_value, int T_s, PIDparam2DOF &param);
+
+/**
+ * @brief resetting the parameters of the two-degree-of-freedom PID controller.
+ * @param the parameters of the controller
+ *
+ * @return void
+ */
+void pid_2dof_reset(PIDparam2DOF &param);
 
+/**
+ * @brief Structure type to set the parameters of the load torque disturbance observer.
+ */
+typedef struct {
+    double inertia;             //moment of inertia [mNm/(rad/s^2)]
+    double alpha;               //coefficient of the first order low pass filter of the estimate
+    double velocity_1n;         //previous velocity [rad/s]
+    double torque_1n;           //previous motor torque [mNm]
+    double estimate;            //estimated load torque [mNm]
+    int started;                //previous velocity and torque are valid
+    int T_s;    //Sampling-Time in microseconds
+} DisturbanceObserverParam;
 
+/**
+ * @brief intializing the parameters of the disturbance observer.
+ *
+ * @param the parameters of the observer
+ *
+ * @return void
+ */
+void disturbance_observer_init(DisturbanceObserverParam &param);
 
+/**
+ * @brief setting the parameters of the disturbance observer.
+ * @param input, moment of inertia [gram square centimeter], 0 disables the observer
+ * @param input, bandwidth of the observer [Hz], 0 disables the observer
+ * @param input, sample-time in us (microseconds).
+ * @param structure including the parameters of the observer
+ *
+ * @return void
+ */
+void disturbance_observer_set_parameters(int moment_of_inertia, int bandwidth, int T_s, DisturbanceObserverParam &param);
+
+/**
+ * @brief updating the disturbance observer. The load torque is the part of the motor torque
+ *        which does not accelerate the inertia, filtered with the bandwidth of the observer.
+ * @param torque, the motor torque [mNm]
+ * @param velocity, the velocity [rpm]
+ * @param param, the structure containing the observer parameters
+ *
+ * @return the estimated load torque [mNm], including friction
+ */
+double disturbance_observer_update(int torque, int velocity, DisturbanceObserverParam &param);
+
+/**
+ * @brief resetting the estimate of the disturbance observer.
+ * @param the parameters of the observer
+ *
+ * @return void
+ */
+void disturbance_observer_reset(DisturbanceObserverParam &param);
+
+/**
+ * @brief computing the feed-forward of the cascaded position controller from the position reference history.
+ *        The velocity is the backward difference of the last two references, the acceleration the second
+ *        difference of the last three.
+ * @param position_ref_k_1n, position reference of this period [ticks]
+ * @param position_ref_k_2n, position reference one period ago [ticks]
+ * @param position_ref_k_3n, position reference two periods ago [ticks]
+ * @param velocity_feedforward, gain of the velocity feed-forward [per thousand]
+ * @param acceleration_feedforward, gain of the acceleration feed-forward [per thousand]
+ * @param moment_of_inertia, moment of inertia [gram square centimeter]
+ * @param resolution, resolution of the position sensor [ticks/rotation], 0 disables the feed-forward
+ * @param T_s, sample-time in us (microseconds).
+ * @param velocity_feedforward_k, output, feed-forward of the velocity reference [rpm]
+ * @param torque_feedforward_k, output, feed-forward of the torque reference [mNm]
+ *
+ * @return void
+ */
+void position_feedforward(double position_ref_k_1n, double position_ref_k_2n, double position_ref_k_3n,
+        int velocity_feedforward, int acceleration_feedforward, int moment_of_inertia, int resolution, int T_s,
+        double &velocity_feedforward_k, double &torque_feedforward_k);
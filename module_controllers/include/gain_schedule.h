@@ -0,0 +1,71 @@
+/**
+ * @file gain_schedule.h
+ * @brief Gain scheduling tables for the PID controllers
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Maximum number of breakpoints of a gain schedule.
+ */
+#define GAIN_SCHEDULE_MAX_POINTS    16
+
+/**
+ * @brief Input of a gain schedule.
+ */
+typedef enum {
+    GAIN_SCHEDULE_DISABLED      = 0,    /**< The gains of MotionControlConfig are used */
+    GAIN_SCHEDULE_VELOCITY      = 1,    /**< Absolute value of the actual velocity [rpm] */
+    GAIN_SCHEDULE_POSITION      = 2,    /**< Actual position [ticks] */
+    GAIN_SCHEDULE_LOAD_INDEX    = 3     /**< External load index set by the application */
+} GainScheduleInput;
+
+/**
+ * @brief Structure type for a gain schedule. The gains are interpolated linearly between the breakpoints
+ *        and held outside of them. They have the same scaling as the gains of MotionControlConfig.
+ */
+typedef struct {
+    GainScheduleInput input;                /**< Input of the schedule */
+    int length;                             /**< Number of breakpoints, 0 disables the schedule */
+    int breakpoint[GAIN_SCHEDULE_MAX_POINTS];   /**< Values of the input, strictly increasing */
+    int kp[GAIN_SCHEDULE_MAX_POINTS];       /**< P constant at the breakpoints */
+    int ki[GAIN_SCHEDULE_MAX_POINTS];       /**< I constant at the breakpoints */
+    int kd[GAIN_SCHEDULE_MAX_POINTS];       /**< D constant at the breakpoints */
+} GainSchedule;
+
+/**
+ * @brief Disables a gain schedule.
+ *
+ * @param schedule  gain schedule
+ *
+ * @return void
+ */
+void gain_schedule_init(REFERENCE_PARAM(GainSchedule, schedule));
+
+/**
+ * @brief Checks a gain schedule: known input, at most GAIN_SCHEDULE_MAX_POINTS breakpoints,
+ *        strictly increasing breakpoints and gains in the range 0..100000000.
+ *
+ * @param schedule  gain schedule
+ *
+ * @return 1 if the schedule is valid, 0 otherwise
+ */
+int gain_schedule_check(REFERENCE_PARAM(GainSchedule, schedule));
+
+/**
+ * @brief Interpolates the gains at the given value of the input of the schedule.
+ *        Uses integer arithmetic only.
+ *
+ * @param schedule  gain schedule
+ * @param value     value of the input
+ * @param kp        interpolated P constant
+ * @param ki        interpolated I constant
+ * @param kd        interpolated D constant
+ *
+ * @return 1 if the gains were interpolated, 0 if the schedule is disabled (gains unchanged)
+ */
+int gain_schedule_interpolate(REFERENCE_PARAM(GainSchedule, schedule), int value,
+        REFERENCE_PARAM(int, kp), REFERENCE_PARAM(int, ki), REFERENCE_PARAM(int, kd));
@@ -0,0 +1,118 @@
+/**
+ * @file inertia_estimator.h
+ * @brief Online estimation of the moment of inertia, the viscous friction and the Coulomb friction
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Forgetting factor of the recursive least squares estimator.
+ *        0.9995 forgets old samples with a time constant of 2000 updates.
+ */
+#define INERTIA_ESTIMATOR_FORGETTING        0.9995
+
+/**
+ * @brief Bandwidth of the low pass filters of the torque and the velocity [Hz].
+ */
+#define INERTIA_ESTIMATOR_BANDWIDTH         20
+
+/**
+ * @brief Minimum absolute acceleration for an update [rpm/s], below it the inertia is not observable.
+ */
+#define INERTIA_ESTIMATOR_MIN_ACCELERATION  1000
+
+/**
+ * @brief Minimum absolute velocity for an update [rpm], below it the sign of the Coulomb friction is not known.
+ */
+#define INERTIA_ESTIMATOR_MIN_VELOCITY      20
+
+/**
+ * @brief Upper bound of the trace of the covariance, the forgetting stops above it.
+ */
+#define INERTIA_ESTIMATOR_MAX_COVARIANCE    1.0e6
+
+/**
+ * @brief Number of updates before the estimated inertia is used (INERTIA_ESTIMATION_APPLY).
+ */
+#define INERTIA_ESTIMATOR_APPLY_UPDATES     3000
+
+/**
+ * @brief The estimated inertia replaces the moment of inertia once it differs by more than this value [percent] (INERTIA_ESTIMATION_APPLY).
+ */
+#define INERTIA_ESTIMATOR_APPLY_TOLERANCE   5
+
+/**
+ * @brief Mode of the inertia estimation in motion_control_service.
+ */
+typedef enum {
+    INERTIA_ESTIMATION_OFF      = 0,    /**< No estimation */
+    INERTIA_ESTIMATION_ON       = 1,    /**< The estimates are only published */
+    INERTIA_ESTIMATION_APPLY    = 2     /**< The estimated inertia also replaces the moment of inertia of the controllers */
+} InertiaEstimationMode;
+
+/**
+ * @brief Structure type for the published estimates.
+ */
+typedef struct {
+    int moment_of_inertia;  /**< Moment of inertia [g cm^2] */
+    int viscous_friction;   /**< Viscous friction [uNm/rpm] */
+    int coulomb_friction;   /**< Coulomb friction [mNm] */
+    int updates;            /**< Number of updates with enough excitation since the estimator was initialized */
+} InertiaEstimate;
+
+/**
+ * @brief Structure type of the estimator. The torque is modeled as
+ *        J*acceleration + B*velocity + Fc*sign(velocity) and the parameters are estimated with
+ *        recursive least squares on the scaled regressor (acceleration/1000, velocity/100, sign(velocity)).
+ */
+typedef struct {
+    double theta[3];            // 1000*J [mNm/(rad/s^2)], 100*B [mNm/(rad/s)], Fc [mNm]
+    double P[3][3];             // covariance
+    double alpha;               // coefficient of the low pass filters
+    double min_acceleration;    // [rad/s^2]
+    double min_velocity;        // [rad/s]
+    double torque_f;            // filtered torque [mNm]
+    double torque_f_1n;
+    double velocity_f;          // filtered velocity [rad/s]
+    double velocity_f_1n;
+    double T_s;                 // [s]
+    int started;
+    int updates;
+} InertiaEstimatorParam;
+
+/**
+ * @brief Initializes the estimator, the inertia starts at the given value and the frictions at 0.
+ *
+ * @param moment_of_inertia -> initial moment of inertia [g cm^2]
+ * @param T_s               -> sampling-time in us (microseconds)
+ * @param param             -> estimator
+ *
+ * @return void
+ */
+void inertia_estimator_init(int moment_of_inertia, int T_s, REFERENCE_PARAM(InertiaEstimatorParam, param));
+
+/**
+ * @brief Filters the torque and the velocity and updates the estimates if the acceleration and the velocity
+ *        are above INERTIA_ESTIMATOR_MIN_ACCELERATION and INERTIA_ESTIMATOR_MIN_VELOCITY. The number of
+ *        operations does not depend on the data.
+ *
+ * @param torque    -> motor torque [mNm]
+ * @param velocity  -> velocity [rpm]
+ * @param param     -> estimator
+ *
+ * @return 1 if the estimates were updated, 0 otherwise
+ */
+int inertia_estimator_update(int torque, int velocity, REFERENCE_PARAM(InertiaEstimatorParam, param));
+
+/**
+ * @brief Returns the estimates.
+ *
+ * @param param     -> estimator
+ * @param estimate  -> estimates, negative values are clamped to 0
+ *
+ * @return void
+ */
+void inertia_estimator_result(REFERENCE_PARAM(InertiaEstimatorParam, param), REFERENCE_PARAM(InertiaEstimate, estimate));
@@ -0,0 +1,93 @@
+/**
+ * @file gain_schedule.c
+ * @brief Gain scheduling tables for the PID controllers
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <gain_schedule.h>
+
+void gain_schedule_init(GainSchedule * schedule)
+{
+    schedule->input = GAIN_SCHEDULE_DISABLED;
+    schedule->length = 0;
+}
+
+int gain_schedule_check(GainSchedule * schedule)
+{
+    if (schedule->input < GAIN_SCHEDULE_DISABLED || schedule->input > GAIN_SCHEDULE_LOAD_INDEX)
+        return 0;
+    if (schedule->length < 0 || schedule->length > GAIN_SCHEDULE_MAX_POINTS)
+        return 0;
+
+    for (int i = 0; i < schedule->length; i++)
+    {
+        if (i > 0 && schedule->breakpoint[i] <= schedule->breakpoint[i-1])
+            return 0;
+        if (schedule->kp[i] < 0 || schedule->kp[i] > 100000000 ||
+            schedule->ki[i] < 0 || schedule->ki[i] > 100000000 ||
+            schedule->kd[i] < 0 || schedule->kd[i] > 100000000)
+            return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * gain at the offset from breakpoint i in the segment between the breakpoints i and i+1, rounded
+ */
+static int gain_schedule_segment(int gain[], int i, long long offset, long long span)
+{
+    long long delta = ((long long)(gain[i+1] - gain[i])) * offset;
+
+    if (delta >= 0)
+        return gain[i] + (int)((delta + (span >> 1)) / span);
+    else
+        return gain[i] - (int)(((-delta) + (span >> 1)) / span);
+}
+
+int gain_schedule_interpolate(GainSchedule * schedule, int value, int * kp, int * ki, int * kd)
+{
+    int low, high, i;
+    long long offset, span;
+
+    if (schedule->input == GAIN_SCHEDULE_DISABLED || schedule->length <= 0)
+        return 0;
+
+    //hold the gains outside of the breakpoints
+    if (value <= schedule->breakpoint[0])
+    {
+        *kp = schedule->kp[0];
+        *ki = schedule->ki[0];
+        *kd = schedule->kd[0];
+        return 1;
+    }
+    i = schedule->length - 1;
+    if (value >= schedule->breakpoint[i])
+    {
+        *kp = schedule->kp[i];
+        *ki = schedule->ki[i];
+        *kd = schedule->kd[i];
+        return 1;
+    }
+
+    //binary search of the segment breakpoint[low] <= value < breakpoint[low+1]
+    low = 0;
+    high = i;
+    while (high - low > 1)
+    {
+        i = (low + high) >> 1;
+        if (value < schedule->breakpoint[i])
+            high = i;
+        else
+            low = i;
+    }
+
+    offset = ((long long)value) - schedule->breakpoint[low];
+    span = ((long long)schedule->breakpoint[low+1]) - schedule->breakpoint[low];
+
+    *kp = gain_schedule_segment(schedule->kp, low, offset, span);
+    *ki = gain_schedule_segment(schedule->ki, low, offset, span);
+    *kd = gain_schedule_segment(schedule->kd, low, offset, span);
+
+    return 1;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file inertia_estimator.c
+ * @brief Online estimation of the moment of inertia, the viscous friction and the Coulomb friction
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <inertia_estimator.h>
+#include <math.h>
+
+#define INERTIA_ESTIMATOR_PI            3.14159265359
+#define INERTIA_ESTIMATOR_RPM_TO_RAD    (2.00 * INERTIA_ESTIMATOR_PI / 60.00)
+
+void inertia_estimator_init(int moment_of_inertia, int T_s, InertiaEstimatorParam * param)
+{
+    // g cm^2 -> kg m^2, Nm -> mNm, scaled by 1000
+    param->theta[0] = ((double)moment_of_inertia) * 1.0e-1;
+    param->theta[1] = 0.00;
+    param->theta[2] = 0.00;
+
+    for (int i=0; i<3; i++)
+        for (int j=0; j<3; j++)
+            param->P[i][j] = (i == j) ? 1.0e4 : 0.00;
+
+    param->T_s = ((double)T_s) / 1000000.00;
+    param->alpha = 1.00 - exp(-2.00 * INERTIA_ESTIMATOR_PI * INERTIA_ESTIMATOR_BANDWIDTH * param->T_s);
+    param->min_acceleration = INERTIA_ESTIMATOR_MIN_ACCELERATION * INERTIA_ESTIMATOR_RPM_TO_RAD;
+    param->min_velocity = INERTIA_ESTIMATOR_MIN_VELOCITY * INERTIA_ESTIMATOR_RPM_TO_RAD;
+
+    param->torque_f = 0.00;
+    param->torque_f_1n = 0.00;
+    param->velocity_f = 0.00;
+    param->velocity_f_1n = 0.00;
+    param->started = 0;
+    param->updates = 0;
+}
+
+int inertia_estimator_update(int torque, int velocity, InertiaEstimatorParam * param)
+{
+    double phi[3], p_phi[3], gain[3];
+    double acceleration, velocity_m, error, den, forgetting;
+
+    if (!param->started)
+    {
+        param->torque_f = (double)torque;
+        param->velocity_f = ((double)velocity) * INERTIA_ESTIMATOR_RPM_TO_RAD;
+        param->torque_f_1n = param->torque_f;
+        param->velocity_f_1n = param->velocity_f;
+        param->started = 1;
+        return 0;
+    }
+
+    //the same low pass on both sides keeps the model, and the velocity change of the last period is caused by the torque of the previous period
+    param->torque_f_1n = param->torque_f;
+    param->velocity_f_1n = param->velocity_f;
+    param->torque_f += param->alpha * (((double)torque) - param->torque_f);
+    param->velocity_f += param->alpha * ((((double)velocity) * INERTIA_ESTIMATOR_RPM_TO_RAD) - param->velocity_f);
+
+    acceleration = (param->velocity_f - param->velocity_f_1n) / param->T_s;
+    velocity_m = 0.50 * (param->velocity_f + param->velocity_f_1n);
+
+    //reject samples without excitation, neither the estimates nor the covariance change
+    if (fabs(acceleration) < param->min_acceleration || fabs(velocity_m) < param->min_velocity)
+        return 0;
+
+    phi[0] = acceleration / 1000.00;
+    phi[1] = velocity_m / 100.00;
+    phi[2] = (velocity_m > 0.00) ? 1.00 : -1.00;
+
+    for (int i=0; i<3; i++)
+        p_phi[i] = (param->P[i][0] * phi[0]) + (param->P[i][1] * phi[1]) + (param->P[i][2] * phi[2]);
+
+    //no forgetting once the covariance is large, so it stays bounded
+    forgetting = INERTIA_ESTIMATOR_FORGETTING;
+    if ((param->P[0][0] + param->P[1][1] + param->P[2][2]) > INERTIA_ESTIMATOR_MAX_COVARIANCE)
+        forgetting = 1.00;
+
+    den = forgetting + (phi[0] * p_phi[0]) + (phi[1] * p_phi[1]) + (phi[2] * p_phi[2]);
+    error = param->torque_f_1n - ((param->theta[0] * phi[0]) + (param->theta[1] * phi[1]) + (param->theta[2] * phi[2]));
+
+    for (int i=0; i<3; i++)
+    {
+        gain[i] = p_phi[i] / den;
+        param->theta[i] += gain[i] * error;
+    }
+
+    //P = (P - gain*p_phi')/forgetting, kept symmetric
+    for (int i=0; i<3; i++)
+    {
+        for (int j=i; j<3; j++)
+        {
+            param->P[i][j] = (param->P[i][j] - (gain[i] * p_phi[j])) / forgetting;
+            param->P[j][i] = param->P[i][j];
+        }
+    }
+
+    param->updates++;
+
+    return 1;
+}
+
+void inertia_estimator_result(InertiaEstimatorParam * param, InertiaEstimate * estimate)
+{
+    double moment_of_inertia = param->theta[0] * 10.00;                                         // g cm^2
+    double viscous_friction = (param->theta[1] / 100.00) * INERTIA_ESTIMATOR_RPM_TO_RAD * 1000.00; // uNm/rpm
+    double coulomb_friction = param->theta[2];                                                  // mNm
+
+    estimate->moment_of_inertia = (moment_of_inertia > 0.00) ? (int)floor(moment_of_inertia + 0.50) : 0;
+    estimate->viscous_friction = (viscous_friction > 0.00) ? (int)floor(viscous_friction + 0.50) : 0;
+    estimate->coulomb_friction = (coulomb_friction > 0.00) ? (int)floor(coulomb_friction + 0.50) : 0;
+    estimate->updates = param->updates;
+}
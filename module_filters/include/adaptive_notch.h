@@ -0,0 +1,114 @@
+/**
+ * @file adaptive_notch.h
+ * @brief Adaptive notch filter tracking the dominant resonance of a signal
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Lowest frequency the adaptive notch tracks [Hz].
+ *        The tracker only sees the signal above this frequency, so the low frequency part of
+ *        the torque reference does not pull the notch away from the resonance.
+ */
+#define ADAPTIVE_NOTCH_MIN_FREQUENCY    100
+
+/**
+ * @brief Normalized adaptation step of the notch frequency.
+ */
+#define ADAPTIVE_NOTCH_STEP             0.01
+
+/**
+ * @brief Mode of the adaptive notch.
+ */
+typedef enum
+{
+    ADAPTIVE_NOTCH_OFF          = 0,    /**< The signal passes unchanged */
+    ADAPTIVE_NOTCH_LEARNING     = 1,    /**< The notch follows the dominant resonance */
+    ADAPTIVE_NOTCH_FROZEN       = 2     /**< The notch stays at the last identified frequency */
+} AdaptiveNotchMode;
+
+/**
+ * @brief Structure type for an adaptive notch filter.
+ *        The notch is H(z) = (1 + A(z))/2 with the second order lattice allpass
+ *        A(z) = (k2 + k1*(1+k2)*z^-1 + z^-2)/(1 + k1*(1+k2)*z^-1 + k2*z^-2),
+ *        its center frequency is acos(-k1)/T_s and its -3 dB width is set by k2.
+ */
+typedef struct
+{
+    int mode;           // AdaptiveNotchMode
+    double k1;          // -cos(w0), adapted
+    double k2;          // width of the notch
+    double k1_min;      // lowest tracked frequency
+    double k1_max;      // highest tracked frequency
+    double threshold;   // squared amplitude needed to adapt
+    double hp_alpha;    // high pass of the tracker input
+    double hp_x1;
+    double hp_y1;
+    double hp_x2;
+    double hp_y2;
+    double power;       // power of the tracker input
+    double regressor_power;
+    double track_1n;    // allpass state of the tracker
+    double track_2n;
+    double gradient_1n; // gradient filter state of the tracker
+    double gradient_2n;
+    double gradient_3n;
+    double notch_1n;    // allpass state of the notch
+    double notch_2n;
+    double T_s;
+} AdaptiveNotchParam;
+
+/**
+ * @brief Initializes an adaptive notch filter at a quarter of the sampling frequency.
+ *
+ * @param width     -> -3 dB width of the notch in Hz.
+ * @param threshold -> amplitude of the signal above ADAPTIVE_NOTCH_MIN_FREQUENCY needed to adapt the notch.
+ * @param T_s       -> sampling-time in us (microseconds).
+ * @param param     -> adaptive notch
+ *
+ * @return void
+ */
+void adaptive_notch_init(int width, int threshold, int T_s, REFERENCE_PARAM(AdaptiveNotchParam, param));
+
+/**
+ * @brief Changes the width and the threshold of an adaptive notch filter, the identified frequency is kept.
+ *
+ * @param width     -> -3 dB width of the notch in Hz.
+ * @param threshold -> amplitude of the signal above ADAPTIVE_NOTCH_MIN_FREQUENCY needed to adapt the notch.
+ * @param param     -> adaptive notch
+ *
+ * @return void
+ */
+void adaptive_notch_set_parameters(int width, int threshold, REFERENCE_PARAM(AdaptiveNotchParam, param));
+
+/**
+ * @brief Switches an adaptive notch filter between off, learning and frozen (see AdaptiveNotchMode).
+ *
+ * @param mode  -> new mode, ignored if unknown
+ * @param param -> adaptive notch
+ *
+ * @return void
+ */
+void adaptive_notch_set_mode(int mode, REFERENCE_PARAM(AdaptiveNotchParam, param));
+
+/**
+ * @brief Filters one sample with the adaptive notch and, in learning mode, moves the notch towards the dominant resonance.
+ *
+ * @param x_k   -> the input signal.
+ * @param param -> adaptive notch
+ *
+ * @return filtered value
+ */
+int adaptive_notch_update(int x_k, REFERENCE_PARAM(AdaptiveNotchParam, param));
+
+/**
+ * @brief Returns the center frequency of an adaptive notch filter.
+ *
+ * @param param -> adaptive notch
+ *
+ * @return center frequency in Hz
+ */
+int adaptive_notch_frequency(REFERENCE_PARAM(AdaptiveNotchParam, param));
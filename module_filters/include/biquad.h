@@ -0,0 +1,231 @@
+/**
+ * @file biquad.h
+ * @brief Fixed-point biquad (second order section) filters
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Number of fractional bits of the biquad coefficients (Q2.30).
+ */
+#define BIQUAD_COEFF_SHIFT              30
+
+/**
+ * @brief Number of fractional bits added to the signal inside the filter.
+ *        The input of the filter must be within +/-(2^(31-BIQUAD_SIGNAL_SHIFT)).
+ */
+#define BIQUAD_SIGNAL_SHIFT             8
+
+/**
+ * @brief Maximum number of sections of a biquad cascade.
+ */
+#define BIQUAD_CASCADE_MAX_SECTIONS     4
+
+/**
+ * @brief Structure type for one fixed-point biquad section in direct form II transposed.
+ *        y(k) = b0*x(k) + b1*x(k-1) + b2*x(k-2) - a1*y(k-1) - a2*y(k-2)
+ */
+typedef struct
+{
+    int b0;         //Q2.30
+    int b1;         //Q2.30
+    int b2;         //Q2.30
+    int a1;         //Q2.30
+    int a2;         //Q2.30
+    long long s1;   //state 1, Q.(BIQUAD_COEFF_SHIFT+BIQUAD_SIGNAL_SHIFT)
+    long long s2;   //state 2, Q.(BIQUAD_COEFF_SHIFT+BIQUAD_SIGNAL_SHIFT)
+} BiquadFilterParam;
+
+/**
+ * @brief Structure type for a cascade of biquad sections.
+ */
+typedef struct
+{
+    int n_sections;
+    BiquadFilterParam section[BIQUAD_CASCADE_MAX_SECTIONS];
+} BiquadCascadeParam;
+
+/**
+ * @brief Type of a section of a configurable biquad cascade.
+ */
+typedef enum
+{
+    BIQUAD_SECTION_NONE         = 0,    /**< Section not used */
+    BIQUAD_SECTION_LOW_PASS     = 1,    /**< Second order low pass (as biquad_second_order_LP_filter_init) */
+    BIQUAD_SECTION_NOTCH        = 2,    /**< Notch with configurable width and depth */
+    BIQUAD_SECTION_LEAD_LAG     = 3     /**< First order lead-lag, one zero and one pole */
+} BiquadSectionType;
+
+/**
+ * @brief Structure type for the configuration of one section of a configurable biquad cascade.
+ */
+typedef struct
+{
+    BiquadSectionType type;     /**< Type of the section */
+    int frequency;              /**< Cut-off frequency of the low pass, center frequency of the notch or zero of the lead-lag [Hz] */
+    int width;                  /**< Width of the notch or pole of the lead-lag [Hz] */
+    int depth;                  /**< Attenuation at the center frequency of the notch [dB] */
+} BiquadSectionConfig;
+
+/**
+ * @brief Structure type for the configuration of a biquad cascade.
+ */
+typedef struct
+{
+    int n_sections;                                             /**< Number of configured sections */
+    BiquadSectionConfig section[BIQUAD_CASCADE_MAX_SECTIONS];   /**< Configuration of the sections */
+} BiquadCascadeConfig;
+
+/**
+ * @brief Sets the coefficients of a biquad section (normalized to a0 = 1) and resets its state.
+ *        The coefficients are converted once to fixed-point, they must be within (-2, 2).
+ *
+ * @param b0, b1, b2    -> numerator coefficients
+ * @param a1, a2        -> denominator coefficients
+ * @param param         -> biquad section
+ *
+ * @return void
+ */
+void biquad_set_coefficients(double b0, double b1, double b2, double a1, double a2, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Intializing a biquad section as first-order-LP-filter (same response as first_order_LP_filter_init).
+ *
+ * @param f_c   -> cut-off frequency in Hz.
+ * @param T_s   -> sampling-time in us (microseconds).
+ * @param param -> biquad section
+ *
+ * @return void
+ */
+void biquad_first_order_LP_filter_init(int f_c, int T_s, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Intializing a biquad section as second-order-LP-filter (same response as second_order_LP_filter_init).
+ *
+ * @param f_c   -> cut-off frequency in Hz.
+ * @param T_s   -> sampling-time in us (microseconds).
+ * @param param -> biquad section
+ *
+ * @return void
+ */
+void biquad_second_order_LP_filter_init(int f_c, int T_s, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Intializing a biquad section as notch filter. The bilinear transform is prewarped at the center frequency.
+ *
+ * @param f_c   -> center frequency in Hz.
+ * @param width -> width of the notch in Hz.
+ * @param depth -> attenuation at the center frequency in dB.
+ * @param T_s   -> sampling-time in us (microseconds).
+ * @param param -> biquad section
+ *
+ * @return 0 if the coefficients are within range, -1 otherwise
+ */
+int biquad_notch_filter_init(int f_c, int width, int depth, int T_s, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Intializing a biquad section as first order lead-lag filter (1 + s/w_zero)/(1 + s/w_pole).
+ *        As the coefficients are limited to (-2, 2), the high frequency gain f_pole/f_zero must be below 2.
+ *
+ * @param f_zero -> frequency of the zero in Hz.
+ * @param f_pole -> frequency of the pole in Hz.
+ * @param T_s    -> sampling-time in us (microseconds).
+ * @param param  -> biquad section
+ *
+ * @return 0 if the coefficients are within range, -1 otherwise
+ */
+int biquad_lead_lag_filter_init(int f_zero, int f_pole, int T_s, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Resets the state of a biquad section, the coefficients are kept.
+ *
+ * @param param -> biquad section
+ *
+ * @return void
+ */
+void biquad_reset(REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief filtering the signal x_k with one biquad section.
+ *
+ * @param x_k    ->  the input signal.
+ * @param param  ->  biquad section.
+ *
+ * @return       ->  filtered value
+ */
+int biquad_update(int x_k, REFERENCE_PARAM(BiquadFilterParam, param));
+
+/**
+ * @brief Initializes an empty biquad cascade (passing the signal through unchanged).
+ *
+ * @param cascade -> biquad cascade
+ *
+ * @return void
+ */
+void biquad_cascade_init(REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief Appends a section to a biquad cascade.
+ *
+ * @param section -> biquad section to append
+ * @param cascade -> biquad cascade
+ *
+ * @return index of the section in the cascade, -1 if the cascade is full
+ */
+int biquad_cascade_add_section(BiquadFilterParam section, REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief Intializing a biquad cascade as third-order-LP-filter (same response as third_order_LP_filter_init).
+ *
+ * @param f_c     -> cut-off frequency in Hz.
+ * @param T_s     -> sampling-time in us (microseconds).
+ * @param cascade -> biquad cascade
+ *
+ * @return void
+ */
+void biquad_third_order_LP_filter_init(int f_c, int T_s, REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief Computes the sections of a biquad cascade from their configuration.
+ *        The cascade is only changed if all sections are valid.
+ *
+ * @param config  -> configuration of the sections
+ * @param T_s     -> sampling-time in us (microseconds).
+ * @param cascade -> biquad cascade
+ *
+ * @return number of sections, -1 if a section is not valid
+ */
+int biquad_cascade_design(BiquadCascadeConfig config, int T_s, REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief Sets the state of all sections of a biquad cascade to the steady state of a constant input,
+ *        so a new cascade can replace a running one without a jump of the output.
+ *
+ * @param x_k     -> constant input signal.
+ * @param cascade -> biquad cascade
+ *
+ * @return void
+ */
+void biquad_cascade_preset(int x_k, REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief Resets the state of all sections of a biquad cascade.
+ *
+ * @param cascade -> biquad cascade
+ *
+ * @return void
+ */
+void biquad_cascade_reset(REFERENCE_PARAM(BiquadCascadeParam, cascade));
+
+/**
+ * @brief filtering the signal x_k with all sections of a biquad cascade.
+ *
+ * @param x_k     ->  the input signal.
+ * @param cascade ->  biquad cascade.
+ *
+ * @return        ->  filtered value
+ */
+int biquad_cascade_update(int x_k, REFERENCE_PARAM(BiquadCascadeParam, cascade));
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <mc_internal_constants.h>
 
 #define US_DENOMINATOR          1000000
 
@@ -50,6 +51,18 @@ typedef struct
     double y_k_3;
 } ThirdOrderLPfilterParam;
 
+/**
+ * @brief Structure type for the running sum moving average filter.
+ */
+typedef struct
+{
+    int buffer[FILTER_SIZE_MAX];
+    int index;
+    int length;
+    int shift;  //log2(length) if length is a power of two, -1 otherwise
+    int sum;
+} MovingAverageFilterParam;
+
 /**
  * @brief Initialize Moving Average Filter Configuration.
  *
@@ -73,6 +86,49 @@ void init_filter(int filter_buffer[], int &index, int filter_length);
  */
 int filter(int filter_buffer[], int & index, int filter_length, int input);
 
+/**
+ * @brief Intializing the running sum moving average filter.
+ *
+ * @param filter_length -> length of the filter, limited to 1..FILTER_SIZE_MAX.
+ * @param param         -> filter parameters structure
+ *
+ * @return void
+ */
+void moving_average_filter_init(int filter_length, MovingAverageFilterParam &param);
+
+/**
+ * @brief Get moving average filtered output. The running sum is updated with the new sample,
+ *        so the cost does not depend on the filter length. Lengths which are a power of two
+ *        use a shift instead of the division.
+ *
+ * @param input  -> New sample.
+ * @param param  -> filter parameters structure
+ *
+ * @return       -> filtered value
+ */
+int moving_average_filter_update(int input, MovingAverageFilterParam &param);
+
+/**
+ * @brief Get moving average filtered output of a filter with a length of 2^log2_length samples.
+ *        With a constant log2_length the length is fixed at compile time and mask and shift are folded.
+ *
+ * @param filter_buffer Samples to filter, (1 << log2_length) elements initialized to 0.
+ * @param index Index of the filter, initialized to 0.
+ * @param sum Running sum of the samples, initialized to 0.
+ * @param log2_length Defines the length of the filter as power of two.
+ * @param input New sample.
+ *
+ * @return Filtered output (rounded towards zero as filter()).
+ */
+static inline int moving_average_filter_pow2(int filter_buffer[], int &index, int &sum, const int log2_length, int input)
+{
+    sum += input - filter_buffer[index];
+    filter_buffer[index] = input;
+    index = (index + 1) & ((1 << log2_length) - 1);
+
+    return (sum + ((sum >> 31) & ((1 << log2_length) - 1))) >> log2_length;
+}
+
 /**
  * @brief Intializing the parameters of the first-order-LP-filters.
  *
@@ -0,0 +1,147 @@
+/**
+ * @file adaptive_notch.c
+ * @brief Adaptive notch filter tracking the dominant resonance of a signal
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <adaptive_notch.h>
+#include <math.h>
+
+#define ADAPTIVE_NOTCH_PI           3.14159265359
+#define ADAPTIVE_NOTCH_FORGETTING   0.001
+
+void adaptive_notch_init(int width, int threshold, int T_s, AdaptiveNotchParam * param)
+{
+    double w_min, w_max;
+
+    param->mode = ADAPTIVE_NOTCH_OFF;
+    param->T_s = ((double)T_s)/1000000.00;
+
+    //track between ADAPTIVE_NOTCH_MIN_FREQUENCY and 90% of the Nyquist frequency, start in the middle (fs/4)
+    w_min = 2.00 * ADAPTIVE_NOTCH_PI * ((double)ADAPTIVE_NOTCH_MIN_FREQUENCY) * param->T_s;
+    if (w_min > 0.50 * ADAPTIVE_NOTCH_PI)
+        w_min = 0.50 * ADAPTIVE_NOTCH_PI;
+    w_max = 0.90 * ADAPTIVE_NOTCH_PI;
+    param->k1_min = -cos(w_min);
+    param->k1_max = -cos(w_max);
+    param->k1 = 0.00;
+
+    //second order high pass (two first order sections) at ADAPTIVE_NOTCH_MIN_FREQUENCY
+    param->hp_alpha = 1.00/(1.00 + w_min);
+
+    adaptive_notch_set_parameters(width, threshold, param);
+
+    param->hp_x1 = 0.00;
+    param->hp_y1 = 0.00;
+    param->hp_x2 = 0.00;
+    param->hp_y2 = 0.00;
+    param->power = 0.00;
+    param->regressor_power = 0.00;
+    param->track_1n = 0.00;
+    param->track_2n = 0.00;
+    param->gradient_1n = 0.00;
+    param->gradient_2n = 0.00;
+    param->gradient_3n = 0.00;
+    param->notch_1n = 0.00;
+    param->notch_2n = 0.00;
+}
+
+void adaptive_notch_set_parameters(int width, int threshold, AdaptiveNotchParam * param)
+{
+    double t;
+
+    if (width < 1)
+        width = 1;
+
+    t = tan(ADAPTIVE_NOTCH_PI * ((double)width) * param->T_s);
+    param->k2 = (1.00 - t)/(1.00 + t);
+
+    //a sine of the amplitude threshold has the power threshold^2/2
+    param->threshold = (((double)threshold) * ((double)threshold))/2.00;
+}
+
+void adaptive_notch_set_mode(int mode, AdaptiveNotchParam * param)
+{
+    if (mode < ADAPTIVE_NOTCH_OFF || mode > ADAPTIVE_NOTCH_FROZEN)
+        return;
+
+    if (mode == ADAPTIVE_NOTCH_OFF || param->mode == ADAPTIVE_NOTCH_OFF)
+    {
+        param->notch_1n = 0.00;
+        param->notch_2n = 0.00;
+    }
+
+    param->mode = mode;
+}
+
+int adaptive_notch_update(int x_k, AdaptiveNotchParam * param)
+{
+    double x, h, c, w, allpass, e, y, q, r, delta;
+
+    if (param->mode == ADAPTIVE_NOTCH_OFF)
+        return x_k;
+
+    x = (double)x_k;
+    c = param->k1 * (1.00 + param->k2);
+
+    if (param->mode == ADAPTIVE_NOTCH_LEARNING)
+    {
+        //tracker input, high pass filtered
+        h = param->hp_alpha * (param->hp_y1 + x - param->hp_x1);
+        param->hp_x1 = x;
+        param->hp_y1 = h;
+        h = param->hp_alpha * (param->hp_y2 + param->hp_y1 - param->hp_x2);
+        param->hp_x2 = param->hp_y1;
+        param->hp_y2 = h;
+
+        w = h - (c * param->track_1n) - (param->k2 * param->track_2n);
+        allpass = (param->k2 * w) + (c * param->track_1n) + param->track_2n;
+        e = (h + allpass)/2.00;
+
+        //gradient of the notch output to k1, proportional to z^-1*(1 - z^-2)/D(z)^2 applied to the input
+        q = w - (c * param->gradient_1n) - (param->k2 * param->gradient_2n);
+        r = param->gradient_1n - param->gradient_3n;
+        param->gradient_3n = param->gradient_2n;
+        param->gradient_2n = param->gradient_1n;
+        param->gradient_1n = q;
+
+        param->power += ADAPTIVE_NOTCH_FORGETTING * ((h * h) - param->power);
+        param->regressor_power += ADAPTIVE_NOTCH_FORGETTING * ((r * r) - param->regressor_power);
+
+        //normalized gradient step minimizing the power of the notch output, only with enough excitation
+        if (param->power > param->threshold && param->regressor_power > 0.00)
+        {
+            delta = (ADAPTIVE_NOTCH_STEP * e * r) / param->regressor_power;
+            if (delta > ADAPTIVE_NOTCH_STEP)
+                delta = ADAPTIVE_NOTCH_STEP;
+            else if (delta < -ADAPTIVE_NOTCH_STEP)
+                delta = -ADAPTIVE_NOTCH_STEP;
+            param->k1 -= delta;
+
+            if (param->k1 < param->k1_min)
+                param->k1 = param->k1_min;
+            else if (param->k1 > param->k1_max)
+                param->k1 = param->k1_max;
+
+            c = param->k1 * (1.00 + param->k2);
+        }
+
+        param->track_2n = param->track_1n;
+        param->track_1n = w;
+    }
+
+    //notch on the full signal with the tracked frequency
+    w = x - (c * param->notch_1n) - (param->k2 * param->notch_2n);
+    allpass = (param->k2 * w) + (c * param->notch_1n) + param->notch_2n;
+    y = (x + allpass)/2.00;
+
+    param->notch_2n = param->notch_1n;
+    param->notch_1n = w;
+
+    return (int)floor(y + 0.50);
+}
+
+int adaptive_notch_frequency(AdaptiveNotchParam * param)
+{
+    return (int)floor((acos(-param->k1)/(2.00 * ADAPTIVE_NOTCH_PI * param->T_s)) + 0.50);
+}
@@ -0,0 +1,265 @@
+/**
+ * @file biquad.c
+ * @brief Fixed-point biquad (second order section) filters
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <biquad.h>
+#include <math.h>
+
+#define BIQUAD_TWO_PI   6.28318530718
+
+static int biquad_coefficient_in_range(double c)
+{
+    return (c > -2.00 && c < 2.00);
+}
+
+static int biquad_coefficient(double c)
+{
+    double c_q = floor((c * (double)(1 << BIQUAD_COEFF_SHIFT)) + 0.5);
+
+    if (c_q >  2147483647.00) c_q =  2147483647.00;
+    if (c_q < -2147483647.00) c_q = -2147483647.00;
+
+    return (int) c_q;
+}
+
+/*
+ * one direct form II transposed step on a signal scaled by 2^BIQUAD_SIGNAL_SHIFT
+ */
+static int biquad_update_scaled(int x_s, BiquadFilterParam * param)
+{
+    long long acc;
+    int y_s;
+
+    acc = ((long long)param->b0 * x_s) + param->s1;
+    acc = (acc + (1LL << (BIQUAD_COEFF_SHIFT-1))) >> BIQUAD_COEFF_SHIFT;
+
+    if (acc >  0x7fffffff) acc =  0x7fffffff;
+    if (acc < -0x7fffffff) acc = -0x7fffffff;
+    y_s = (int) acc;
+
+    param->s1 = ((long long)param->b1 * x_s) - ((long long)param->a1 * y_s) + param->s2;
+    param->s2 = ((long long)param->b2 * x_s) - ((long long)param->a2 * y_s);
+
+    return y_s;
+}
+
+static int biquad_scale_input(int x_k)
+{
+    if (x_k >  ((1 << (31-BIQUAD_SIGNAL_SHIFT)) - 1)) x_k =  ((1 << (31-BIQUAD_SIGNAL_SHIFT)) - 1);
+    if (x_k < -((1 << (31-BIQUAD_SIGNAL_SHIFT)) - 1)) x_k = -((1 << (31-BIQUAD_SIGNAL_SHIFT)) - 1);
+
+    return x_k << BIQUAD_SIGNAL_SHIFT;
+}
+
+static int biquad_scale_output(int y_s)
+{
+    return (int)((((long long)y_s) + (1 << (BIQUAD_SIGNAL_SHIFT-1))) >> BIQUAD_SIGNAL_SHIFT);
+}
+
+/*
+ * second order low pass with the discretization of second_order_LP_filter_init,
+ * y(k) = a1*y(k-1) + a2*y(k-2) + b0*x(k)
+ */
+static void biquad_second_order_LP_design(int f_c, int T_s, double z, BiquadFilterParam * param)
+{
+    double fs=0.00, w=0.00, d=0.00;
+
+    fs= 1000000.00/((double)(T_s));
+    w = BIQUAD_TWO_PI * ((double)f_c);
+
+    d = (fs*fs) + (2*z*w*fs) + (w*w);
+
+    biquad_set_coefficients((w*w)/d, 0.00, 0.00, -((2*fs*fs) + (2*z*w*fs))/d, (fs*fs)/d, param);
+}
+
+void biquad_set_coefficients(double b0, double b1, double b2, double a1, double a2, BiquadFilterParam * param)
+{
+    param->b0 = biquad_coefficient(b0);
+    param->b1 = biquad_coefficient(b1);
+    param->b2 = biquad_coefficient(b2);
+    param->a1 = biquad_coefficient(a1);
+    param->a2 = biquad_coefficient(a2);
+
+    biquad_reset(param);
+}
+
+void biquad_first_order_LP_filter_init(int f_c, int T_s, BiquadFilterParam * param)
+{
+    double omega_T = (BIQUAD_TWO_PI * ((double)f_c) * ((double)T_s))/1000000.00;
+
+    biquad_set_coefficients(omega_T/(1.00+omega_T), 0.00, 0.00, -1.00/(1.00+omega_T), 0.00, param);
+}
+
+void biquad_second_order_LP_filter_init(int f_c, int T_s, BiquadFilterParam * param)
+{
+    biquad_second_order_LP_design(f_c, T_s, 0.70, param);
+}
+
+int biquad_notch_filter_init(int f_c, int width, int depth, int T_s, BiquadFilterParam * param)
+{
+    double w0, alpha, g, a0;
+
+    if (f_c <= 0 || width <= 0 || depth < 0 || T_s <= 0 || (2.00 * ((double)f_c) * ((double)T_s)) >= 1000000.00)
+        return -1;
+
+    w0 = (BIQUAD_TWO_PI * ((double)f_c) * ((double)T_s))/1000000.00;
+    alpha = (sin(w0) * ((double)width)) / (2.00 * ((double)f_c));
+    g = pow(10.00, -((double)depth)/20.00);
+    a0 = 1.00 + alpha;
+
+    biquad_set_coefficients((1.00 + (g*alpha))/a0, (-2.00*cos(w0))/a0, (1.00 - (g*alpha))/a0,
+            (-2.00*cos(w0))/a0, (1.00 - alpha)/a0, param);
+
+    return 0;
+}
+
+int biquad_lead_lag_filter_init(int f_zero, int f_pole, int T_s, BiquadFilterParam * param)
+{
+    double k_zero, k_pole, b0, b1, a1;
+
+    if (f_zero <= 0 || f_pole <= 0 || T_s <= 0)
+        return -1;
+
+    // bilinear transform s = (2/T_s)*(1 - z^-1)/(1 + z^-1)
+    k_zero = 2000000.00 / (BIQUAD_TWO_PI * ((double)f_zero) * ((double)T_s));
+    k_pole = 2000000.00 / (BIQUAD_TWO_PI * ((double)f_pole) * ((double)T_s));
+
+    b0 = (1.00 + k_zero) / (1.00 + k_pole);
+    b1 = (1.00 - k_zero) / (1.00 + k_pole);
+    a1 = (1.00 - k_pole) / (1.00 + k_pole);
+
+    if (!biquad_coefficient_in_range(b0) || !biquad_coefficient_in_range(b1))
+        return -1;
+
+    biquad_set_coefficients(b0, b1, 0.00, a1, 0.00, param);
+
+    return 0;
+}
+
+void biquad_reset(BiquadFilterParam * param)
+{
+    param->s1 = 0;
+    param->s2 = 0;
+}
+
+int biquad_update(int x_k, BiquadFilterParam * param)
+{
+    return biquad_scale_output(biquad_update_scaled(biquad_scale_input(x_k), param));
+}
+
+void biquad_cascade_init(BiquadCascadeParam * cascade)
+{
+    cascade->n_sections = 0;
+}
+
+int biquad_cascade_add_section(BiquadFilterParam section, BiquadCascadeParam * cascade)
+{
+    if (cascade->n_sections >= BIQUAD_CASCADE_MAX_SECTIONS)
+        return -1;
+
+    cascade->section[cascade->n_sections] = section;
+    biquad_reset(&cascade->section[cascade->n_sections]);
+
+    return cascade->n_sections++;
+}
+
+void biquad_third_order_LP_filter_init(int f_c, int T_s, BiquadCascadeParam * cascade)
+{
+    BiquadFilterParam section;
+
+    // the third order design of third_order_LP_filter_init factors into (fs+w)*(fs^2 + 2*z*w*fs + w^2)
+    biquad_cascade_init(cascade);
+
+    biquad_first_order_LP_filter_init(f_c, T_s, &section);
+    biquad_cascade_add_section(section, cascade);
+
+    biquad_second_order_LP_design(f_c, T_s, 0.40, &section);
+    biquad_cascade_add_section(section, cascade);
+}
+
+int biquad_cascade_design(BiquadCascadeConfig config, int T_s, BiquadCascadeParam * cascade)
+{
+    BiquadCascadeParam designed;
+    BiquadFilterParam section;
+    int error = 0;
+
+    if (config.n_sections < 0 || config.n_sections > BIQUAD_CASCADE_MAX_SECTIONS)
+        return -1;
+
+    biquad_cascade_init(&designed);
+
+    for (int i=0; i<config.n_sections; i++)
+    {
+        switch (config.section[i].type)
+        {
+        case BIQUAD_SECTION_NONE:
+            continue;
+        case BIQUAD_SECTION_LOW_PASS:
+            if (config.section[i].frequency <= 0 || T_s <= 0)
+                return -1;
+            biquad_second_order_LP_filter_init(config.section[i].frequency, T_s, &section);
+            break;
+        case BIQUAD_SECTION_NOTCH:
+            error = biquad_notch_filter_init(config.section[i].frequency, config.section[i].width, config.section[i].depth, T_s, &section);
+            break;
+        case BIQUAD_SECTION_LEAD_LAG:
+            error = biquad_lead_lag_filter_init(config.section[i].frequency, config.section[i].width, T_s, &section);
+            break;
+        default:
+            return -1;
+        }
+
+        if (error != 0)
+            return -1;
+
+        biquad_cascade_add_section(section, &designed);
+    }
+
+    *cascade = designed;
+
+    return cascade->n_sections;
+}
+
+void biquad_cascade_preset(int x_k, BiquadCascadeParam * cascade)
+{
+    long long x_s = biquad_scale_input(x_k), y_s, den;
+
+    for (int i=0; i<cascade->n_sections; i++)
+    {
+        BiquadFilterParam * param = &cascade->section[i];
+
+        // steady state y = x*(b0 + b1 + b2)/(1 + a1 + a2) of direct form II transposed
+        den = (1LL << BIQUAD_COEFF_SHIFT) + param->a1 + param->a2;
+        if (den != 0)
+            y_s = (x_s * ((long long)param->b0 + param->b1 + param->b2)) / den;
+        else
+            y_s = x_s;
+
+        if (y_s >  0x7fffffff) y_s =  0x7fffffff;
+        if (y_s < -0x7fffffff) y_s = -0x7fffffff;
+
+        param->s1 = (y_s << BIQUAD_COEFF_SHIFT) - (param->b0 * x_s);
+        param->s2 = (param->b2 * x_s) - (param->a2 * y_s);
+
+        x_s = y_s;
+    }
+}
+
+void biquad_cascade_reset(BiquadCascadeParam * cascade)
+{
+    for (int i=0; i<cascade->n_sections; i++)
+        biquad_reset(&cascade->section[i]);
+}
+
+int biquad_cascade_update(int x_k, BiquadCascadeParam * cascade)
+{
+    int x_s = biquad_scale_input(x_k);
+
+    // sections exchange the scaled signal, it is rounded only once at the output
+    for (int i=0; i<cascade->n_sections; i++)
+        x_s = biquad_update_scaled(x_s, &cascade->section[i]);
+
+    return biquad_scale_output(x_s);
+}
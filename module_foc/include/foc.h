@@ -0,0 +1,216 @@
+/**
+ * @file foc.h
+ * @brief Portable fixed-point field oriented control: Clarke/Park transforms, dq current controllers, inverse Park and space vector modulation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Resolution of the electrical angle [ticks/electrical rotation], as the angle of the position feedback.
+ */
+#define FOC_ANGLE_RESOLUTION        4096
+
+/**
+ * @brief Scaling of the sine table (Q14), the same for sine_table_control and sine_table_expanded.
+ */
+#define FOC_SINE_SHIFT              14
+
+/**
+ * @brief 1/sqrt(3) in Q30.
+ */
+#define FOC_ONE_BY_SQRT3            619925131
+
+/**
+ * @brief sqrt(3)/2 in Q30.
+ */
+#define FOC_SQRT3_BY_TWO            929887697
+
+/**
+ * @brief Range of the DC bus voltage [mV], the squared voltage limit has to fit 32 bits.
+ */
+#define FOC_DC_BUS_VOLTAGE_MIN      1000
+#define FOC_DC_BUS_VOLTAGE_MAX      110000
+
+/**
+ * @brief Instruction budgets of the stages of foc_update on an xCORE logical core.
+ *        A 16 kHz current loop has 62.5 us, i.e. 3906 instructions of a core running at 62.5 MIPS.
+ */
+#define FOC_BUDGET_SINE_COSINE      12      // with FOC_INTERPOLATED_SINE: 30
+#define FOC_BUDGET_CLARKE_PARK      20
+#define FOC_BUDGET_DECOUPLING       12
+#define FOC_BUDGET_CURRENT_CONTROL  60      // both axes
+#define FOC_BUDGET_VOLTAGE_LIMIT    120     // only while the voltage vector is limited (square root)
+#define FOC_BUDGET_INVERSE_PARK     12
+#define FOC_BUDGET_SVPWM            40
+#define FOC_BUDGET_TOTAL            (FOC_BUDGET_SINE_COSINE+FOC_BUDGET_CLARKE_PARK+FOC_BUDGET_DECOUPLING+FOC_BUDGET_CURRENT_CONTROL+\
+                                     FOC_BUDGET_VOLTAGE_LIMIT+FOC_BUDGET_INVERSE_PARK+FOC_BUDGET_SVPWM)
+
+/**
+ * @brief Structure type of the PI controller of one current axis.
+ */
+typedef struct {
+    int kp;                         // Q16 [mV/mA]
+    int ki;                         // Q16 [mV/mA], per period
+    int integral;                   // Q8 [mV]
+} FocCurrentController;
+
+/**
+ * @brief Structure type of the current loop.
+ *        The currents are in mA, the voltages in mV and the duties in ticks of the PWM service.
+ *        Ld = Lq is assumed for the decoupling.
+ */
+typedef struct {
+    FocCurrentController d;
+    FocCurrentController q;
+    int decoupling;                 // omega_e*L, Q32 [mV/(rpm*mA)]
+    int dc_bus_voltage;             // [mV]
+    int voltage_limit;              // largest voltage vector of the linear modulation, dc_bus_voltage/sqrt(3) [mV]
+    long long voltage_limit_square; // [mV^2]
+    int pwm_scale;                  // Q16 [ticks/mV]
+    int pwm_half;                   // duty of 0 V [ticks]
+    int duty_min;                   // [ticks]
+    int duty_max;                   // [ticks]
+
+    int i_d;                        // [mA]
+    int i_q;                        // [mA]
+    int v_d;                        // [mV]
+    int v_q;                        // [mV]
+} FocParam;
+
+/**
+ * @brief Initializes the current loop, the DC bus voltage can be updated with foc_set_dc_bus_voltage.
+ *
+ * @param kp                proportional gain of the current controllers [mV/A]
+ * @param ki                integral gain of the current controllers [mV/(A*ms)]
+ * @param phase_inductance  phase inductance for the decoupling of the axes [uH], 0 disables the decoupling
+ * @param pole_pairs        number of pole pairs of the motor
+ * @param dc_bus_voltage    DC bus voltage [mV]
+ * @param T_s               period of the current loop [us]
+ * @param pwm_max_value     period of the PWM [ticks]
+ * @param pwm_limit         shortest pulse and shortest gap of a phase [ticks], at least the deadtime of the PWM service
+ * @param param             current loop
+ *
+ * @return 0 if initialized, -1 if a parameter is not valid
+ */
+int foc_init(int kp, int ki, int phase_inductance, int pole_pairs, int dc_bus_voltage, int T_s, int pwm_max_value, int pwm_limit,
+        REFERENCE_PARAM(FocParam, param));
+
+/**
+ * @brief Sets the DC bus voltage which scales the voltages to duties and limits the voltage vector.
+ *
+ * @param dc_bus_voltage    DC bus voltage [mV], limited to [FOC_DC_BUS_VOLTAGE_MIN, FOC_DC_BUS_VOLTAGE_MAX]
+ * @param param             current loop
+ *
+ * @return void
+ */
+void foc_set_dc_bus_voltage(int dc_bus_voltage, REFERENCE_PARAM(FocParam, param));
+
+/**
+ * @brief Clears the integrals of the current controllers.
+ *
+ * @param param current loop
+ *
+ * @return void
+ */
+void foc_reset(REFERENCE_PARAM(FocParam, param));
+
+/**
+ * @brief Getter for the sine and the cosine of the electrical angle. The table is sine_table_control,
+ *        or the interpolated quarter wave table of sine_cosine if FOC_INTERPOLATED_SINE is defined.
+ *
+ * @param angle     electrical angle [0:FOC_ANGLE_RESOLUTION-1], higher bits are ignored, rounded to the 1024 entries
+ *                  of sine_table_control or interpolated
+ * @param sine      sine, Q14
+ * @param cosine    cosine, Q14
+ *
+ * @return void
+ */
+void foc_sine_cosine(unsigned int angle, REFERENCE_PARAM(int, sine), REFERENCE_PARAM(int, cosine));
+
+/**
+ * @brief Clarke transform (amplitude invariant) of the phase currents, i_c = -i_a - i_b.
+ *
+ * @param i_a       current of phase A
+ * @param i_b       current of phase B
+ * @param i_alpha   alpha component
+ * @param i_beta    beta component
+ *
+ * @return void
+ */
+void foc_clarke(int i_a, int i_b, REFERENCE_PARAM(int, i_alpha), REFERENCE_PARAM(int, i_beta));
+
+/**
+ * @brief Park transform of a stationary vector into the rotor frame.
+ *
+ * @param alpha     alpha component
+ * @param beta      beta component
+ * @param sine      sine of the electrical angle, Q14
+ * @param cosine    cosine of the electrical angle, Q14
+ * @param d         d component
+ * @param q         q component
+ *
+ * @return void
+ */
+void foc_park(int alpha, int beta, int sine, int cosine, REFERENCE_PARAM(int, d), REFERENCE_PARAM(int, q));
+
+/**
+ * @brief Inverse Park transform of a rotor frame vector into the stationary frame.
+ *
+ * @param d         d component
+ * @param q         q component
+ * @param sine      sine of the electrical angle, Q14
+ * @param cosine    cosine of the electrical angle, Q14
+ * @param alpha     alpha component
+ * @param beta      beta component
+ *
+ * @return void
+ */
+void foc_inverse_park(int d, int q, int sine, int cosine, REFERENCE_PARAM(int, alpha), REFERENCE_PARAM(int, beta));
+
+/**
+ * @brief PI controller of one current axis. The integral stops while the output is limited.
+ *
+ * @param reference     current reference [mA]
+ * @param actual        measured current [mA]
+ * @param feed_forward  voltage added to the output, e.g. the decoupling [mV]
+ * @param limit         limit of the output [mV]
+ * @param pi            controller of the axis
+ *
+ * @return voltage [mV]
+ */
+int foc_current_control(int reference, int actual, int feed_forward, int limit, REFERENCE_PARAM(FocCurrentController, pi));
+
+/**
+ * @brief Space vector modulation of a stationary voltage vector (min-max zero sequence injection).
+ *        The duties are limited to [duty_min, duty_max].
+ *
+ * @param v_alpha   alpha component of the voltage [mV]
+ * @param v_beta    beta component of the voltage [mV]
+ * @param duty      duties of the phases A, B and C [ticks]
+ * @param param     current loop
+ *
+ * @return void
+ */
+void foc_space_vector_modulation(int v_alpha, int v_beta, int duty[3], REFERENCE_PARAM(FocParam, param));
+
+/**
+ * @brief Executes one period of the current loop: Clarke/Park transform of the measured currents, PI controllers of the
+ *        d and q currents with decoupling, limit of the voltage vector (d axis first), inverse Park transform and
+ *        space vector modulation.
+ *
+ * @param i_a       current of phase A [mA]
+ * @param i_b       current of phase B [mA]
+ * @param angle     electrical angle [0:FOC_ANGLE_RESOLUTION-1]
+ * @param velocity  velocity of the rotor for the decoupling [rpm]
+ * @param i_d_ref   d current reference [mA]
+ * @param i_q_ref   q current reference [mA]
+ * @param duty      duties of the phases A, B and C for the PWM service [ticks]
+ * @param param     current loop
+ *
+ * @return void
+ */
+void foc_update(int i_a, int i_b, unsigned int angle, int velocity, int i_d_ref, int i_q_ref, int duty[3],
+        REFERENCE_PARAM(FocParam, param));
@@ -0,0 +1,231 @@
+/**
+ * @file foc.c
+ * @brief Portable fixed-point field oriented control: Clarke/Park transforms, dq current controllers, inverse Park and space vector modulation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <foc.h>
+#include <lookup_tables.h>
+#include <sine_table_big.h>
+
+#define FOC_PI  3.14159265359
+
+/*
+ * integer square root, largest r with r*r <= x
+ */
+static unsigned int foc_sqrt(unsigned int x)
+{
+    unsigned int root = 0, bit = 1u << 30;
+
+    while (bit > x)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+int foc_init(int kp, int ki, int phase_inductance, int pole_pairs, int dc_bus_voltage, int T_s, int pwm_max_value, int pwm_limit,
+        FocParam * param)
+{
+    if (kp < 0 || ki < 0 || phase_inductance < 0 || pole_pairs <= 0 || dc_bus_voltage < FOC_DC_BUS_VOLTAGE_MIN || T_s <= 0 ||
+            pwm_limit < 0 || pwm_max_value <= 2*pwm_limit)
+        return -1;
+
+    // [mV/A] = [uV/mA], Q16
+    param->d.kp = (int)((((long long)kp) << 16) / 1000);
+    param->q.kp = param->d.kp;
+
+    // [mV/(A*ms)]*T_s[us]/1e6 = [mV/mA] per period, Q16
+    param->d.ki = (int)(((((long long)ki) * T_s) << 16) / 1000000);
+    param->q.ki = param->d.ki;
+
+    // omega_e*L = rpm*2*pi/60*pole_pairs*L[uH]*1e-6 [V/A] = [mV/mA], Q32
+    param->decoupling = (int)(((2.00 * FOC_PI / 60.00) * ((double)pole_pairs) * ((double)phase_inductance) * 0.000001 * 4294967296.00) + 0.50);
+
+    param->pwm_half = pwm_max_value / 2;
+    param->duty_min = pwm_limit;
+    param->duty_max = pwm_max_value - pwm_limit;
+
+    foc_set_dc_bus_voltage(dc_bus_voltage, param);
+    foc_reset(param);
+
+    return 0;
+}
+
+void foc_set_dc_bus_voltage(int dc_bus_voltage, FocParam * param)
+{
+    if (dc_bus_voltage < FOC_DC_BUS_VOLTAGE_MIN)
+        dc_bus_voltage = FOC_DC_BUS_VOLTAGE_MIN;
+    else if (dc_bus_voltage > FOC_DC_BUS_VOLTAGE_MAX)
+        dc_bus_voltage = FOC_DC_BUS_VOLTAGE_MAX;
+
+    param->dc_bus_voltage = dc_bus_voltage;
+    param->voltage_limit = (int)((((long long)dc_bus_voltage) * FOC_ONE_BY_SQRT3) >> 30);
+    param->voltage_limit_square = ((long long)param->voltage_limit) * param->voltage_limit;
+
+    // +dc_bus_voltage/2 gives the full pulse of 2*pwm_half
+    param->pwm_scale = (int)((((long long)param->pwm_half) << 17) / dc_bus_voltage);
+}
+
+void foc_reset(FocParam * param)
+{
+    param->d.integral = 0;
+    param->q.integral = 0;
+    param->i_d = 0;
+    param->i_q = 0;
+    param->v_d = 0;
+    param->v_q = 0;
+}
+
+void foc_sine_cosine(unsigned int angle, int * sine, int * cosine)
+{
+#ifdef FOC_INTERPOLATED_SINE
+    // the 12 bit angle is interpolated in the quarter wave table instead of rounded
+    sine_cosine(angle << (SINE_COSINE_ANGLE_BITS - 12), sine, cosine);
+#else
+    unsigned int index = ((angle + 2) >> 2) & 1023;
+
+    *sine = sine_table_control[index];
+    *cosine = sine_table_control[(index + 256) & 1023];
+#endif
+}
+
+void foc_clarke(int i_a, int i_b, int * i_alpha, int * i_beta)
+{
+    *i_alpha = i_a;
+    *i_beta = (int)((((long long)(i_a + 2*i_b)) * FOC_ONE_BY_SQRT3 + (1 << 29)) >> 30);
+}
+
+void foc_park(int alpha, int beta, int sine, int cosine, int * d, int * q)
+{
+    *d = (int)((((long long)alpha) * cosine + ((long long)beta) * sine + (1 << (FOC_SINE_SHIFT-1))) >> FOC_SINE_SHIFT);
+    *q = (int)((((long long)beta) * cosine - ((long long)alpha) * sine + (1 << (FOC_SINE_SHIFT-1))) >> FOC_SINE_SHIFT);
+}
+
+void foc_inverse_park(int d, int q, int sine, int cosine, int * alpha, int * beta)
+{
+    *alpha = (int)((((long long)d) * cosine - ((long long)q) * sine + (1 << (FOC_SINE_SHIFT-1))) >> FOC_SINE_SHIFT);
+    *beta = (int)((((long long)d) * sine + ((long long)q) * cosine + (1 << (FOC_SINE_SHIFT-1))) >> FOC_SINE_SHIFT);
+}
+
+int foc_current_control(int reference, int actual, int feed_forward, int limit, FocCurrentController * pi)
+{
+    int error = reference - actual;
+    int integral = pi->integral + (int)((((long long)pi->ki) * error) >> 8);
+    int output = (int)((((long long)pi->kp) * error) >> 16) + feed_forward;
+    int limit_q8 = limit << 8;
+
+    if (integral > limit_q8)
+        integral = limit_q8;
+    else if (integral < -limit_q8)
+        integral = -limit_q8;
+
+    output += (integral + (1 << 7)) >> 8;
+
+    // the integral is kept while it would drive the output further into the limit
+    if (output > limit)
+    {
+        output = limit;
+        if (error < 0)
+            pi->integral = integral;
+    }
+    else if (output < -limit)
+    {
+        output = -limit;
+        if (error > 0)
+            pi->integral = integral;
+    }
+    else
+    {
+        pi->integral = integral;
+    }
+
+    return output;
+}
+
+void foc_space_vector_modulation(int v_alpha, int v_beta, int duty[3], FocParam * param)
+{
+    int v_a, v_b, v_c, v_max, v_min, offset;
+    int half_beta = (int)((((long long)v_beta) * FOC_SQRT3_BY_TWO + (1 << 29)) >> 30);
+
+    // inverse Clarke transform
+    v_a = v_alpha;
+    v_b = half_beta - (v_alpha >> 1);
+    v_c = -half_beta - (v_alpha >> 1);
+
+    // the zero sequence centers the phases between the rails
+    v_max = v_a;
+    v_min = v_a;
+    if (v_b > v_max) v_max = v_b;
+    if (v_b < v_min) v_min = v_b;
+    if (v_c > v_max) v_max = v_c;
+    if (v_c < v_min) v_min = v_c;
+    offset = (v_max + v_min) >> 1;
+
+    duty[0] = param->pwm_half + (((v_a - offset) * param->pwm_scale + (1 << 15)) >> 16);
+    duty[1] = param->pwm_half + (((v_b - offset) * param->pwm_scale + (1 << 15)) >> 16);
+    duty[2] = param->pwm_half + (((v_c - offset) * param->pwm_scale + (1 << 15)) >> 16);
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (duty[i] < param->duty_min)
+            duty[i] = param->duty_min;
+        else if (duty[i] > param->duty_max)
+            duty[i] = param->duty_max;
+    }
+}
+
+void foc_update(int i_a, int i_b, unsigned int angle, int velocity, int i_d_ref, int i_q_ref, int duty[3],
+        FocParam * param)
+{
+    int sine, cosine, i_alpha, i_beta, v_alpha, v_beta, v_d_ff, v_q_ff, limit_q, integral_q;
+    long long omega_l;
+
+    foc_sine_cosine(angle, &sine, &cosine);
+
+    foc_clarke(i_a, i_b, &i_alpha, &i_beta);
+    foc_park(i_alpha, i_beta, sine, cosine, &param->i_d, &param->i_q);
+
+    // cross coupling of the axes by the rotation, v_d = -omega_e*L*i_q, v_q = omega_e*L*i_d
+    omega_l = ((long long)velocity) * param->decoupling;
+    v_d_ff = -(int)((omega_l * param->i_q) >> 32);
+    v_q_ff = (int)((omega_l * param->i_d) >> 32);
+
+    param->v_d = foc_current_control(i_d_ref, param->i_d, v_d_ff, param->voltage_limit, &param->d);
+    integral_q = param->q.integral;
+    param->v_q = foc_current_control(i_q_ref, param->i_q, v_q_ff, param->voltage_limit, &param->q);
+
+    // the d axis has the priority on the voltage vector, the square root is only needed while the vector is limited
+    if (((long long)param->v_d) * param->v_d + ((long long)param->v_q) * param->v_q > param->voltage_limit_square)
+    {
+        limit_q = (int)foc_sqrt(((unsigned int)(param->voltage_limit - param->v_d)) * ((unsigned int)(param->voltage_limit + param->v_d)));
+        if (param->v_q > limit_q)
+        {
+            param->v_q = limit_q;
+            if (param->q.integral > integral_q)
+                param->q.integral = integral_q;
+        }
+        else if (param->v_q < -limit_q)
+        {
+            param->v_q = -limit_q;
+            if (param->q.integral < integral_q)
+                param->q.integral = integral_q;
+        }
+    }
+
+    foc_inverse_park(param->v_d, param->v_q, sine, cosine, &v_alpha, &v_beta);
+    foc_space_vector_modulation(v_alpha, v_beta, duty, param);
+}
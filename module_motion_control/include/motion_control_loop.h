@@ -0,0 +1,168 @@
+/**
+ * @file motion_control_loop.h
+ * @brief Control law of one period of the Motion Control Service, shared with the host simulation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <motion_control_service.h>
+#include <controllers.h>
+#include <profile.h>
+#include <biquad.h>
+#include <adaptive_notch.h>
+#include <cyclic_interpolation.h>
+#include <velocity_estimator.h>
+
+/**
+ * @brief Value of the input of a gain schedule, the position is given to the schedule with the polarity of the commands.
+ *
+ * @param schedule, gain schedule
+ * @param velocity, actual velocity [rpm]
+ * @param position, actual position [ticks]
+ * @param load_index, load index set by the application
+ * @param polarity, polarity of the commands
+ *
+ * @return value of the input
+ */
+int gain_schedule_input_value(GainSchedule &schedule, int velocity, int position, int load_index, MotionPolarity polarity);
+
+/**
+ * @brief Initializes the estimator of the velocity from the timestamped position and the torque reference.
+ *
+ * @param motion_ctrl_config, configuration with the bandwidth of the estimator, the resolution and the moment of inertia
+ * @param velocity_estimator, estimator
+ *
+ * @return 1 if it replaces the velocity of the sensor, 0 otherwise
+ */
+int init_motion_velocity_estimator(MotionControlConfig &motion_ctrl_config, VelocityEstimatorParam &velocity_estimator);
+
+/**
+ * @brief Updates the gains of the enabled controllers from their gain schedules, with the errors to the last
+ *        references so the gain changes are bumpless. Not to be called while tuning.
+ *
+ * @param velocity_gain_schedule, gain schedule of the velocity controller
+ * @param position_gain_schedule, gain schedule of the position controller
+ * @param velocity_enable_flag, 1 in velocity control
+ * @param position_enable_flag, 1 in position control
+ * @param pos_control_mode, position control strategy (see MotionControlStrategies)
+ * @param velocity, actual velocity [rpm]
+ * @param position, actual position [ticks]
+ * @param load_index, load index set by the application
+ * @param polarity, polarity of the commands
+ * @param velocity_ref_in_k, last velocity reference of velocity control [rpm]
+ * @param position_ref_in_k, last position reference [ticks]
+ * @param velocity_ref_k, last velocity reference of the cascaded position controller [rpm]
+ * @param velocity_control_pid_param, velocity controller
+ * @param position_control_pid_param, position controller
+ *
+ * @return void
+ */
+void motion_control_gain_schedules(GainSchedule &velocity_gain_schedule, GainSchedule &position_gain_schedule,
+        int velocity_enable_flag, int position_enable_flag, int pos_control_mode,
+        int velocity, int position, int load_index, MotionPolarity polarity,
+        double velocity_ref_in_k, double position_ref_in_k, double velocity_ref_k,
+        PIDparam &velocity_control_pid_param, PIDparam &position_control_pid_param);
+
+/**
+ * @brief Torque reference of torque control: the interpolated target in cyclic synchronous torque mode,
+ *        the profiled or the direct target otherwise.
+ *
+ * @param torque_cmd, target torque [mNm]
+ * @param time, time of this period [timer ticks]
+ * @param enable_profiler, 1 if the profiler is enabled
+ * @param profiler_param, parameters of the profilers
+ * @param cyclic_targets, targets of the master
+ * @param torque_ref_in_k_1n, last profiled torque reference, updated [mNm]
+ *
+ * @return torque reference [mNm]
+ */
+int motion_control_torque_reference(int torque_cmd, unsigned int time, int enable_profiler, ProfilerParam &profiler_param,
+        CyclicInterpolator &cyclic_targets, double &torque_ref_in_k_1n);
+
+/**
+ * @brief Velocity control: the velocity reference is the interpolated target in cyclic synchronous velocity mode,
+ *        the profiled or the direct target otherwise.
+ *
+ * @param velocity_ref_k, target velocity [rpm]
+ * @param velocity_k, actual velocity [rpm]
+ * @param velocity_excitation_k, excitation added to the reference [rpm]
+ * @param time, time of this period [timer ticks]
+ * @param enable_profiler, 1 if the profiler is enabled
+ * @param profiler_param, parameters of the profilers
+ * @param cyclic_targets, targets of the master
+ * @param velocity_ref_in_k, output, velocity reference [rpm]
+ * @param velocity_ref_in_k_1n, last profiled velocity reference, updated [rpm]
+ * @param velocity_control_pid_param, velocity controller
+ *
+ * @return torque reference [mNm]
+ */
+double motion_control_velocity(double velocity_ref_k, double velocity_k, double velocity_excitation_k, unsigned int time,
+        int enable_profiler, ProfilerParam &profiler_param, CyclicInterpolator &cyclic_targets,
+        double &velocity_ref_in_k, double &velocity_ref_in_k_1n, PIDparam &velocity_control_pid_param);
+
+/**
+ * @brief Position reference of this period: the next step of a running profile table, the interpolated target
+ *        in cyclic synchronous position mode, the profiled or the direct target otherwise. The table and the
+ *        cyclic targets are kept within the position limits.
+ *
+ * @param position_cmd, target position, set to the end of the profile table when it is done [ticks]
+ * @param position_k, actual position of the last period [ticks]
+ * @param time, time of this period [timer ticks]
+ * @param enable_profiler, 1 if the profiler is enabled
+ * @param profiler_param, parameters of the profilers
+ * @param scurve_profiler_state, state of the jerk limited profiler
+ * @param position_profile_table, profile table
+ * @param position_profile_table_buffer, entries of the profile table
+ * @param position_profile_table_active, 1 while the profile table is played, cleared at its end
+ * @param cyclic_targets, targets of the master
+ * @param min_position, lower position limit [ticks]
+ * @param max_position, upper position limit [ticks]
+ * @param position_ref_in_k_1n, position reference of this period, updated [ticks]
+ * @param position_ref_in_k_2n, position reference one period ago, updated [ticks]
+ * @param position_ref_in_k_3n, position reference two periods ago, updated [ticks]
+ *
+ * @return position reference [ticks]
+ */
+double motion_control_position_reference(int &position_cmd, double position_k, unsigned int time,
+        int enable_profiler, ProfilerParam &profiler_param, ScurveProfilerState &scurve_profiler_state,
+        ProfileTable &position_profile_table, short position_profile_table_buffer[], int &position_profile_table_active,
+        CyclicInterpolator &cyclic_targets, int min_position, int max_position,
+        double &position_ref_in_k_1n, double &position_ref_in_k_2n, double &position_ref_in_k_3n);
+
+/**
+ * @brief Cascaded position and velocity controller with the feed-forward of the velocity and of the inertia torque
+ *        of the position reference.
+ *
+ * @param position_ref_in_k, position reference [ticks]
+ * @param position_ref_in_k_1n, position reference of this period for the feed-forward [ticks]
+ * @param position_ref_in_k_2n, position reference one period ago [ticks]
+ * @param position_ref_in_k_3n, position reference two periods ago [ticks]
+ * @param position_k, actual position [ticks]
+ * @param velocity_k, actual velocity [rpm]
+ * @param motion_ctrl_config, configuration with the feed-forward gains, the moment of inertia, the resolution and the maximum speed
+ * @param position_control_pid_param, position controller
+ * @param velocity_control_pid_param, velocity controller
+ * @param velocity_ref_k, output, velocity reference [rpm]
+ *
+ * @return torque reference [mNm]
+ */
+double motion_control_cascaded_position(double position_ref_in_k, double position_ref_in_k_1n, double position_ref_in_k_2n,
+        double position_ref_in_k_3n, double position_k, double velocity_k, MotionControlConfig &motion_ctrl_config,
+        PIDparam &position_control_pid_param, PIDparam &velocity_control_pid_param, double &velocity_ref_k);
+
+/**
+ * @brief Limits the torque reference and filters it with the low pass filter, the filter chain and the adaptive notch.
+ *
+ * @param torque_ref_k, torque reference, limited [mNm]
+ * @param max_torque, torque limit [mNm]
+ * @param filter, cut-off frequency of the low pass filter [Hz], not bigger than zero bypasses it
+ * @param torque_filter_param, low pass filter
+ * @param torque_filter_chain, active filter chain
+ * @param torque_filter_chain_input, output, input of the filter chain [mNm]
+ * @param adaptive_notch_param, adaptive notch
+ *
+ * @return torque command [mNm]
+ */
+int motion_control_torque_output(int &torque_ref_k, int max_torque, int filter, BiquadFilterParam &torque_filter_param,
+        BiquadCascadeParam &torque_filter_chain, int &torque_filter_chain_input, AdaptiveNotchParam &adaptive_notch_param);
@@ -6,8 +6,17 @@
 
 #pragma once
 
+#ifdef __XC__
 #include <motor_control_interfaces.h>
 #include <advanced_motor_control.h>
+#endif
+#include <gain_schedule.h>
+#include <inertia_estimator.h>
+#include <velocity_estimator.h>
+#include <biquad.h>
+#include <adaptive_notch.h>
+#include <frequency_response.h>
+#include <plant_identification.h>
 
 /**
  * @brief Denominator for PID contants. The values set by the user for such constants will be divided by this value (10000 by default).
@@ -40,6 +49,16 @@
  */
 #define BRAKE_UPDATE_CONFIG_WAIT        2000
 
+/**
+ * @brief Maximum time the position feedback is extrapolated to compensate the age of the sensor reading [microseconds].
+ */
+#define POSITION_EXTRAPOLATION_MAX_HORIZON  2000
+
+/**
+ * @brief Maximum number of 16 bit entries of a precomputed position profile table (see set_position_profile_table()).
+ */
+#define POSITION_PROFILE_TABLE_SIZE         1024
+
 /**
  * @brief Position/Velocity control strategie
  */
@@ -94,24 +113,39 @@ typedef struct {
     int max_deceleration_profiler;      /**< Parameter for setting the maximum deceleration in profiler mode */
     int max_speed_profiler;             /**< Parameter for setting the maximum speed in profiler mode */
     int max_torque_rate_profiler;       /**< Parameter for setting the maximum torque in profiler mode */
+    int max_jerk_profiler;              /**< Parameter for setting the maximum jerk of the position profiler, 0 selects the trapezoidal position profiler */
 
     int position_kp;                    /**< Parameter for position controller P-constant */
     int position_ki;                    /**< Parameter for position controller I-constant */
     int position_kd;                    /**< Parameter for position controller D-constant */
     int position_integral_limit;        /**< Parameter for integral limit of position pid controller */
+    int velocity_feedforward;           /**< Parameter for setting the velocity feed-forward of the cascaded position controller [per thousand of the reference velocity], 0 disables it */
+    int acceleration_feedforward;       /**< Parameter for setting the acceleration feed-forward of the cascaded position controller [per thousand of the inertia torque of the reference acceleration], 0 disables it */
+    int disturbance_observer_bandwidth; /**< Parameter for setting the bandwidth of the load torque observer which is compensated in velocity and position control [Hz], 0 disables it. It needs the moment of inertia */
+    int inertia_estimation;             /**< Parameter for setting the online estimation of the moment of inertia and the friction (0 off, 1 estimate, 2 estimate and use the inertia as moment of inertia, see InertiaEstimationMode) */
+    int velocity_estimator_bandwidth;   /**< Parameter for setting the bandwidth of the estimator of the velocity from the timestamped position and the torque reference [Hz], 0 uses the velocity of the sensor. The torque is used with the moment of inertia */
 
     int position_control_autotune;      /**< Parameter for enabling/disabling automatic tuning of position controller*/
     int step_amplitude_autotune;        /**< The tuning procedure uses steps to evaluate the response of controller. This input is equal to half of step command amplitude.*/
     int counter_max_autotune;           /**< The period of step commands in ticks. Each tick is corresponding to one execution sycle of motion_control_service. As a result, 3000 ticks when the frequency of motion_control_service is 1 ms leads to a period equal to 3 seconds for each step command.*/
     int per_thousand_overshoot_autotune;      /**< Overshoot limit while tuning (it is set as per thousand of step amplitude)*/
     int rise_time_freedom_percent_autotune;   /**< This value helps the tuner to find out whether the ki is high enough or not. By default set this value to 300, and if the tuner is not able to find proper values (and the response is having oscillations), increase this value to 400 or 500.*/
+    int relay_torque_autotune;          /**< Torque relay of the relay feedback autotuner while tuning the velocity controller [mNm] */
+    int relay_velocity_autotune;        /**< Velocity relay of the relay feedback autotuner while tuning the position controller [rpm] */
+    int relay_velocity_hysteresis_autotune; /**< Hysteresis of the torque relay of the relay feedback autotuner [rpm] */
+    int relay_position_hysteresis_autotune; /**< Hysteresis of the velocity relay of the relay feedback autotuner [ticks] */
+    int relay_rule_autotune;            /**< Tuning rule of the relay feedback autotuner (see RelayTuneRule) */
+    int identification_velocity_autotune;   /**< Operating velocity of the plant identification [rpm] */
+    int identification_amplitude_autotune;  /**< Amplitude of the PRBS torque of the plant identification [mNm] */
+    int identification_bandwidth_autotune;  /**< Requested bandwidth of the velocity controller tuned by the plant identification [Hz] */
+    int identification_resonance_autotune;  /**< 1 if the plant identification also identifies the first resonance, 0 for a rigid plant */
 
     int velocity_kp;                    /**< Parameter for velocity controller P-constant */
     int velocity_ki;                    /**< Parameter for velocity controller I-constant */
     int velocity_kd;                    /**< Parameter for velocity controller D-constant */
     int velocity_integral_limit;        /**< Parameter for integral limit of velocity pid controller */
 
-    int enable_velocity_auto_tuner;     /**< Parameter for enabling/disabling auto tuner for velocity controller */
+    int enable_velocity_auto_tuner;     /**< Parameter for enabling/disabling auto tuner for velocity controller (1 step response tuner, 2 plant identification) */
 
     int k_fb;                           /**< Parameter for setting the feedback position sensor gain */
     int resolution;                     /**< Parameter for setting the resolution of position sensor [ticks/rotation] */
@@ -127,8 +161,16 @@ typedef struct {
     int hold_brake_voltage;             /**< Parameter for setting the brake voltage after it is pulled */
 
     int filter;
+    int adaptive_notch;                 /**< Parameter for setting the mode of the adaptive notch of the torque reference (0 off, 1 learning, 2 frozen, see AdaptiveNotchMode) */
+    int adaptive_notch_width;           /**< Parameter for setting the width of the adaptive notch [Hz] */
+    int adaptive_notch_threshold;       /**< Parameter for setting the amplitude of the resonance in the torque reference needed to adapt the notch [mNm] */
+    int enable_position_extrapolation;  /**< Parameter for enabling/disabling the compensation of the age of the position feedback by extrapolation */
+    int cyclic_interpolation;           /**< Parameter for interpolating the targets of update_control_data() between master cycles (cyclic synchronous modes): 0 none, 1 linear, 2 cubic */
+    int cyclic_master_period;           /**< Parameter for setting the cycle time of the master sending the targets [microseconds] */
 } MotionControlConfig;
 
+#ifdef __XC__
+
 /**
  * @brief Interface type to communicate with the Motion Control Service.
  */
@@ -239,6 +281,97 @@ interface MotionControlInterface
      */
     int get_velocity();
 
+    /**
+     * @brief getter of the load torque estimated by the disturbance observer [mNm], including friction
+     */
+    int get_load_torque();
+
+    /**
+     * @brief getter of the moment of inertia, the viscous friction and the Coulomb friction estimated online (see MotionControlConfig.inertia_estimation)
+     */
+    InertiaEstimate get_inertia_estimate();
+
+    /**
+     * @brief getter of the plant and the gains of the last plant identification (see MotionControlConfig.enable_velocity_auto_tuner)
+     */
+    PlantModel get_plant_model();
+
+    /**
+     * @brief sets the gain schedule of the velocity controller, which is also the inner loop of
+     *        the cascaded position controller. The gains of MotionControlConfig are used again
+     *        if the schedule is disabled.
+     *
+     * @param schedule -> gain schedule, ignored if not valid (see gain_schedule_check())
+     */
+    void set_velocity_gain_schedule(GainSchedule schedule);
+
+    /**
+     * @brief sets the gain schedule of the position controller (POS_PID_CONTROLLER and
+     *        POS_PID_VELOCITY_CASCADED_CONTROLLER). The gains of MotionControlConfig are used again
+     *        if the schedule is disabled.
+     *
+     * @param schedule -> gain schedule, ignored if not valid (see gain_schedule_check())
+     */
+    void set_position_gain_schedule(GainSchedule schedule);
+
+    /**
+     * @brief sets the external load index used by gain schedules with GAIN_SCHEDULE_LOAD_INDEX input
+     *
+     * @param load_index -> load index
+     */
+    void set_gain_schedule_load_index(int load_index);
+
+    /**
+     * @brief sets the chain of biquad sections (notch, low pass, lead-lag) applied to the torque reference
+     *        after the low pass filter of MotionControlConfig. The coefficients are computed in this call
+     *        and the new chain replaces the running one between two control periods.
+     *
+     * @param config -> configuration of the sections, 0 sections disable the chain
+     *
+     * @return number of sections of the new chain, -1 if the configuration is not valid (the running chain is kept)
+     */
+    int set_torque_filter_chain(BiquadCascadeConfig config);
+
+    /**
+     * @brief switches the adaptive notch of the torque reference between off, learning and frozen
+     *
+     * @param mode -> mode of the adaptive notch (see AdaptiveNotchMode), ignored if unknown
+     */
+    void set_adaptive_notch_mode(int mode);
+
+    /**
+     * @brief getter of the frequency of the resonance identified by the adaptive notch [Hz]
+     */
+    int get_adaptive_notch_frequency();
+
+    /**
+     * @brief starts a frequency response measurement. The excitation is added to the torque reference,
+     *        or to the velocity reference in velocity control, and the measurement is aborted if the control is disabled.
+     *
+     * @param config -> configuration of the measurement
+     *
+     * @return 0 if the measurement started, -1 if the configuration is not valid
+     */
+    int start_frequency_response(FrequencyResponseConfig config);
+
+    /**
+     * @brief getter of the frequency response of the plant (velocity/torque) and of the closed loop,
+     *        valid once its status is FREQUENCY_RESPONSE_DONE
+     */
+    FrequencyResponse get_frequency_response();
+
+    /**
+     * @brief starts a precomputed position profile table (see profile_table_build_lfpb() and profile_table_build_scurve()).
+     *        The position controller plays one step of the table per control period without floating point math.
+     *        The table is stopped when the position controller is enabled or the service is disabled.
+     *
+     * @param start_position -> position before the first step of the profile
+     * @param log2_decimation -> decimation of the profile table
+     * @param table -> entries of the profile table
+     * @param n -> number of entries, the table is ignored if larger than POSITION_PROFILE_TABLE_SIZE
+     */
+    void set_position_profile_table(int start_position, int log2_decimation, short table[n], unsigned n);
+
     /**
      * @brief responsible for data communication between torque controller and higher level controllers
      *
@@ -312,3 +445,5 @@ void motion_control_service(MotionControlConfig &pos_velocity_control_config,
                     interface TorqueControlInterface client i_torque_control,
                     interface MotionControlInterface server i_motion_control[3],
                     client interface UpdateBrake i_update_brake);
+
+#endif
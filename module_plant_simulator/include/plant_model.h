@@ -0,0 +1,115 @@
+/**
+ * @file plant_model.h
+ * @brief Motor and load plant model used to simulate the motion control loop
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Structure type for the physical parameters of the simulated motor and load.
+ */
+typedef struct {
+    int resolution;                 /**< Resolution of the simulated position sensor [ticks/rotation] */
+    int moment_of_inertia;          /**< Moment of inertia of motor and load [gram square centimeter] */
+    int viscous_friction;           /**< Viscous friction coefficient [micro-Nm per rpm] */
+    int coulomb_friction;           /**< Coulomb (dynamic) friction torque [mNm] */
+    int static_friction;            /**< Static (break-away) friction torque [mNm] */
+    int torque_time_constant;       /**< Time constant of the underlying torque (current) loop [microseconds] */
+    int max_torque;                 /**< Maximum torque the simulated drive can produce [mNm] */
+    int brake_release_time;         /**< Time the brake needs to open after being released [milliseconds] */
+    int brake_holding_torque;       /**< Torque above which a closed brake slips [mNm] */
+} PlantModelConfig;
+
+/**
+ * @brief Structure type containing the state of the plant model.
+ */
+typedef struct {
+    double j;                       // inertia [kg m^2]
+    double b;                       // viscous friction [Nm s/rad]
+    double t_c;                     // coulomb friction [Nm]
+    double t_s;                     // static friction [Nm]
+    double tau;                     // torque loop time constant [s]
+    double t_max;                   // torque limit [Nm]
+    double t_brake;                 // brake holding torque [Nm]
+    double ticks_per_rad;
+
+    double theta;                   // position [rad]
+    double omega;                   // velocity [rad/s]
+    double torque;                  // torque produced by the motor [Nm]
+    double load_torque;             // external load torque [Nm]
+
+    int brake_released;             // brake released by the controller
+    int brake_open_time;            // time the brake is released [us]
+    int brake_release_time;         // time needed to open the brake [us]
+} PlantModelState;
+
+/**
+ * @brief Initializes the plant model from its configuration. The model starts at standstill, position 0, brake closed.
+ *
+ * @param config    physical parameters of the simulated plant
+ * @param state     state of the plant model
+ *
+ * @return void
+ */
+void plant_model_init(PlantModelConfig config, REFERENCE_PARAM(PlantModelState, state));
+
+/**
+ * @brief Integrates the plant model over one simulation step.
+ *
+ * @param state         state of the plant model
+ * @param torque_cmd    torque commanded to the torque controller [mNm]
+ * @param period        simulation step [microseconds]
+ *
+ * @return void
+ */
+void plant_model_update(REFERENCE_PARAM(PlantModelState, state), int torque_cmd, int period);
+
+/**
+ * @brief Releases (1) or closes (0) the brake of the simulated axis.
+ *
+ * @param state         state of the plant model
+ * @param brake_status  1 to release the brake, 0 to close it
+ *
+ * @return void
+ */
+void plant_model_set_brake(REFERENCE_PARAM(PlantModelState, state), int brake_status);
+
+/**
+ * @brief Sets the external load torque acting against the motor.
+ *
+ * @param state         state of the plant model
+ * @param load_torque   load torque [mNm]
+ *
+ * @return void
+ */
+void plant_model_set_load_torque(REFERENCE_PARAM(PlantModelState, state), int load_torque);
+
+/**
+ * @brief Getter for the simulated sensor position.
+ *
+ * @param state     state of the plant model
+ *
+ * @return position [ticks]
+ */
+int plant_model_get_position(REFERENCE_PARAM(PlantModelState, state));
+
+/**
+ * @brief Getter for the simulated sensor velocity.
+ *
+ * @param state     state of the plant model
+ *
+ * @return velocity [rpm]
+ */
+int plant_model_get_velocity(REFERENCE_PARAM(PlantModelState, state));
+
+/**
+ * @brief Getter for the torque produced by the simulated motor.
+ *
+ * @param state     state of the plant model
+ *
+ * @return torque [mNm]
+ */
+int plant_model_get_torque(REFERENCE_PARAM(PlantModelState, state));
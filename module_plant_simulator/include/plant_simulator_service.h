@@ -0,0 +1,123 @@
+/**
+ * @file plant_simulator_service.h
+ * @brief Simulated torque control service driving a motor and load plant model
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <motor_control_interfaces.h>
+#include <motion_control_service.h>
+#include <plant_model.h>
+
+/**
+ * @brief Integration step of the plant model [microseconds].
+ */
+#define PLANT_SIMULATION_PERIOD     50
+
+/**
+ * @brief Structure type containing the statistics collected by the plant simulator.
+ *        Loop cost is the time between the read of the upstream data and the
+ *        write of the new torque reference, i.e. the computation time of one
+ *        control tick of the motion control service.
+ */
+typedef struct {
+    int control_ticks;          /**< Number of control ticks since the last reset */
+    int loop_cost_max;          /**< Maximum computation time of one control tick [ns] */
+    int loop_cost_avg;          /**< Average computation time of one control tick [ns] */
+    int loop_period_min;        /**< Minimum period between two control ticks [ns] */
+    int loop_period_max;        /**< Maximum period between two control ticks [ns] */
+    int position;               /**< Actual position of the plant [ticks] */
+    int velocity;               /**< Actual velocity of the plant [rpm] */
+    int torque;                 /**< Actual torque produced by the plant [mNm] */
+    int brake_released;         /**< 1 if the brake of the plant is released */
+} PlantSimulatorStatistics;
+
+/**
+ * @brief Interface type to communicate with the Plant Simulator Service.
+ */
+interface PlantSimulatorInterface
+{
+    /**
+     * @brief Getter for the statistics collected since the last reset.
+     *
+     * @return statistics of the simulation
+     */
+    PlantSimulatorStatistics get_statistics();
+
+    /**
+     * @brief Resets the collected statistics.
+     */
+    void reset_statistics();
+
+    /**
+     * @brief Sets the external load torque acting on the plant.
+     *
+     * @param load_torque -> load torque [mNm]
+     */
+    void set_load_torque(int load_torque);
+
+    /**
+     * @brief Forces the brake of the plant open (1) or closed (0).
+     *
+     * @param brake_status -> release if 1, block if 0
+     */
+    void set_brake(int brake_status);
+};
+
+/**
+ * @brief Types of the steps of a simulation scenario.
+ */
+typedef enum {
+    SIMULATION_STEP_POSITION        = 1,    /**< Position step to value [ticks relative to the start position] */
+    SIMULATION_STEP_POSITION_RAMP   = 2,    /**< Position ramp to value [ticks relative to the start position] over the step duration */
+    SIMULATION_STEP_VELOCITY        = 3,    /**< Velocity step to value [rpm] */
+    SIMULATION_STEP_VELOCITY_RAMP   = 4,    /**< Velocity ramp to value [rpm] over the step duration */
+    SIMULATION_STEP_TORQUE          = 5,    /**< Torque step to value [mNm] */
+    SIMULATION_STEP_REVERSAL        = 6,    /**< Reverses the actual position or velocity target */
+    SIMULATION_STEP_LOAD_TORQUE     = 7,    /**< Applies value [mNm] as external load torque */
+    SIMULATION_STEP_BRAKE_RELEASE   = 8,    /**< Closes the brake and restarts position control, which releases it again */
+    SIMULATION_STEP_HOLD            = 9     /**< Keeps the actual target */
+} SimulationStepType;
+
+/**
+ * @brief Structure type for one step of a simulation scenario.
+ */
+typedef struct {
+    SimulationStepType type;    /**< Type of the step */
+    int value;                  /**< Target value of the step (unit depends on the type) */
+    int duration;               /**< Duration of the step [milliseconds] */
+} SimulationStep;
+
+/**
+ * @brief Service which replaces the torque control service (and the PWM brake update) with a simulated motor and load.
+ *        The motion control service can be connected to it without any change to run closed loop without hardware.
+ *
+ * @param plant_config          Physical parameters of the simulated plant
+ * @param motorcontrol_config   Configuration reported to the motion control service
+ * @param i_torque_control[2]   Array of interfaces to communicate with up to two clients for the torque control
+ * @param i_update_brake        Interface to receive the brake configuration of the motion control service
+ * @param i_plant_simulator     Interface to read the simulation statistics and inject disturbances
+ *
+ * @return void
+ */
+void plant_simulator_service(PlantModelConfig &plant_config, MotorcontrolConfig &motorcontrol_config,
+        interface TorqueControlInterface server i_torque_control[2],
+        server interface UpdateBrake i_update_brake,
+        server interface PlantSimulatorInterface i_plant_simulator);
+
+/**
+ * @brief Executes a simulation scenario on the motion control service and prints the control quality
+ *        (following error) and the control loop cost of each step.
+ *
+ * @param steps                     Steps of the scenario
+ * @param n_steps                   Number of steps of the scenario
+ * @param position_control_strategy Position control strategy used for the position steps
+ * @param i_motion_control          Interface to the motion control service
+ * @param i_plant_simulator         Interface to the plant simulator service
+ *
+ * @return void
+ */
+void run_simulation_scenario(SimulationStep steps[], int n_steps, int position_control_strategy,
+        client interface MotionControlInterface i_motion_control,
+        client interface PlantSimulatorInterface i_plant_simulator);
@@ -0,0 +1,114 @@
+/**
+ * @file plant_model.c
+ * @brief Motor and load plant model used to simulate the motion control loop
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <plant_model.h>
+#include <math.h>
+
+#define PLANT_TWO_PI        6.28318530718
+#define PLANT_RPM_PER_RAD_S (60.00/PLANT_TWO_PI)
+
+void plant_model_init(PlantModelConfig config, PlantModelState * state)
+{
+    state->j = ((double)config.moment_of_inertia) * 1.0e-7; // g cm^2 -> kg m^2
+    if (state->j <= 0)
+        state->j = 1.0e-5;
+
+    state->b   = (((double)config.viscous_friction) * 1.0e-6) * PLANT_RPM_PER_RAD_S;
+    state->t_c = ((double)config.coulomb_friction) / 1000.00;
+    state->t_s = ((double)config.static_friction)  / 1000.00;
+    if (state->t_s < state->t_c)
+        state->t_s = state->t_c;
+
+    state->tau   = ((double)config.torque_time_constant) / 1000000.00;
+    state->t_max = ((double)config.max_torque) / 1000.00;
+    state->t_brake = ((double)config.brake_holding_torque) / 1000.00;
+    state->ticks_per_rad = ((double)config.resolution) / PLANT_TWO_PI;
+
+    state->theta = 0.00;
+    state->omega = 0.00;
+    state->torque = 0.00;
+    state->load_torque = 0.00;
+
+    state->brake_released = 0;
+    state->brake_open_time = 0;
+    state->brake_release_time = config.brake_release_time * 1000;
+}
+
+void plant_model_update(PlantModelState * state, int torque_cmd, int period)
+{
+    double dt = ((double)period) / 1000000.00;
+    double torque_ref = ((double)torque_cmd) / 1000.00;
+    double driving_torque, holding_torque, friction, omega_new;
+
+    if (torque_ref >  state->t_max) torque_ref =  state->t_max;
+    if (torque_ref < -state->t_max) torque_ref = -state->t_max;
+
+    // the torque loop is modelled as a first order lag
+    if (state->tau > dt)
+        state->torque += (torque_ref - state->torque) * (dt / state->tau);
+    else
+        state->torque = torque_ref;
+
+    if (state->brake_released && state->brake_open_time < state->brake_release_time)
+        state->brake_open_time += period;
+
+    driving_torque = state->torque - state->load_torque;
+
+    // a closed brake behaves like an additional (large) static friction
+    holding_torque = state->t_s;
+    friction = state->t_c;
+    if (!state->brake_released || state->brake_open_time < state->brake_release_time)
+    {
+        holding_torque += state->t_brake;
+        friction += state->t_brake;
+    }
+
+    if (state->omega == 0.00 && fabs(driving_torque) <= holding_torque)
+    {
+        // stuck, static friction compensates the driving torque
+        return;
+    }
+
+    if (state->omega > 0.00 || (state->omega == 0.00 && driving_torque > 0.00))
+        friction = -friction;
+
+    omega_new = state->omega + (dt / state->j) * (driving_torque + friction - (state->b * state->omega));
+
+    // friction can stop the axis but never reverse it within one step
+    if ((state->omega > 0.00 && omega_new < 0.00) || (state->omega < 0.00 && omega_new > 0.00))
+        omega_new = 0.00;
+
+    state->omega = omega_new;
+    state->theta += state->omega * dt;
+}
+
+void plant_model_set_brake(PlantModelState * state, int brake_status)
+{
+    if (brake_status == 1 && state->brake_released == 0)
+        state->brake_open_time = 0;
+
+    state->brake_released = (brake_status == 1);
+}
+
+void plant_model_set_load_torque(PlantModelState * state, int load_torque)
+{
+    state->load_torque = ((double)load_torque) / 1000.00;
+}
+
+int plant_model_get_position(PlantModelState * state)
+{
+    return (int) floor(state->theta * state->ticks_per_rad);
+}
+
+int plant_model_get_velocity(PlantModelState * state)
+{
+    return (int) round(state->omega * PLANT_RPM_PER_RAD_S);
+}
+
+int plant_model_get_torque(PlantModelState * state)
+{
+    return (int) round(state->torque * 1000.00);
+}
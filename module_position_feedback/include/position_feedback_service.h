@@ -16,6 +16,7 @@
 #include <qei_struct.h>
 #include <motor_control_structures.h>
 #include <refclk.h>
+#include <velocity_estimator.h>
 
 #include <stdint.h>
 
@@ -74,6 +75,8 @@ typedef struct {
     int offset;                     /**< Offset (in ticks) added to the absolute multiturn position (count). Does not affect the electrical angle */
     int max_ticks;                  /**< The multiturn position is reset to 0 when reached */
     int velocity_compute_period;    /**< Velocity compute period in microsecond. Is also the polling period to write to the shared memory */
+    VelocityEstimatorType velocity_estimator;   /**< Velocity computation, the alpha-beta-gamma estimator is used by BiSS, REM 16MT, REM 14 and QEI */
+    int velocity_estimator_bandwidth;           /**< Bandwidth of the alpha-beta-gamma estimator [Hz], at most 1/(2*pi) of the frequency of the positions */
     BISSConfig biss_config;         /**< BiSS sensor configuration */
     REM_16MTConfig rem_16mt_config; /**< REM 16MT sensor configuration */
     REM_14Config rem_14_config;     /**< REM 14  configuration */
@@ -212,6 +215,7 @@ typedef struct {
 } HallEncSelectPort;
 
 #include <shared_memory.h>
+#include <shared_memory_seqlock.h>
 #include <biss_service.h>
 #include <rem_16mt_service.h>
 #include <rem_14_service.h>
@@ -250,6 +254,25 @@ void position_feedback_service(QEIHallPort &?qei_hall_port_1, QEIHallPort &?qei_
                                client interface shared_memory_interface ?i_shared_memory_2,
                                server interface PositionFeedbackInterface (&?i_position_feedback_2)[3]);
 
+/**
+ * @brief Same as position_feedback_service() but the sensor services write the position, velocity, electrical angle
+ *        and GPIO inputs directly to the lock-free shared memory (see shared_memory_seqlock.h) instead of calling
+ *        the shared memory service. The shared memory must be on the same tile. The shared memory interfaces are
+ *        only used if shared_memory_blocks is null.
+ *
+ * @param shared_memory_blocks Pointer to the lock-free shared memory, null to use the shared memory interfaces.
+ *
+ * See position_feedback_service() for the other parameters.
+ */
+void position_feedback_seqlock_service(QEIHallPort &?qei_hall_port_1, QEIHallPort &?qei_hall_port_2, HallEncSelectPort &?hall_enc_select_port, SPIPorts &?spi_ports, port ?gpio_port_0, port ?gpio_port_1, port ?gpio_port_2, port ?gpio_port_3,
+                               SharedMemoryBlocks * unsafe shared_memory_blocks,
+                               PositionFeedbackConfig &position_feedback_config_1,
+                               client interface shared_memory_interface ?i_shared_memory_1,
+                               server interface PositionFeedbackInterface i_position_feedback_1[3],
+                               PositionFeedbackConfig &?position_feedback_config_2,
+                               client interface shared_memory_interface ?i_shared_memory_2,
+                               server interface PositionFeedbackInterface (&?i_position_feedback_2)[3]);
+
 /**
  * @brief Convert the number of tick per turn into the number of resolution bits
  *
@@ -275,6 +298,7 @@ void multiturn(int &count, int last_position, int position, int ticks_per_turn);
  * @brief Write position, velocity and electrical angle to the shared memory.
  *
  * @param i_shared_memory The client interface to the shared memory
+ * @param shared_memory_blocks The lock-free shared memory, written instead of i_shared_memory if not null
  * @param sensor_function The sensor function to select which data to write.
  * @param count The absolute multiturn position
  * @param velocity The velocity
@@ -283,7 +307,7 @@ void multiturn(int &count, int last_position, int position, int ticks_per_turn);
  * @param sensor_error the sensor error status
  * @param timestamp timestamp in microseconds of when the position data was read
  */
-void write_shared_memory(client interface shared_memory_interface ?i_shared_memory, SensorFunction sensor_function, int count, int velocity, int angle, int hall_state, SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp);
+void write_shared_memory(client interface shared_memory_interface ?i_shared_memory, SharedMemoryBlocks * unsafe shared_memory_blocks, SensorFunction sensor_function, int count, int velocity, int angle, int hall_state, SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp);
 
 /**
  * @brief Compute the velocity in rpm
@@ -296,6 +320,17 @@ void write_shared_memory(client interface shared_memory_interface ?i_shared_memo
  */
 int velocity_compute(int difference, int timediff, int resolution);
 
+/**
+ * @brief Initialize the velocity estimator if it is selected in the configuration
+ *
+ * @param position_feedback_config The position feedback service configuration
+ * @param period The period of the positions in microseconds
+ * @param velocity_estimator The velocity estimator
+ *
+ * @return 1 if the velocity is estimated, 0 if it is computed with velocity_compute
+ */
+int init_velocity_estimator(PositionFeedbackConfig &position_feedback_config, int period, VelocityEstimatorParam &velocity_estimator);
+
 /**
  * @brief Read a GPIO port
  *
@@ -327,9 +362,10 @@ void gpio_write(port * (&?gpio_ports)[4], PositionFeedbackConfig &position_feedb
  * @param gpio_ports The GPIO ports array
  * @param position_feedback_config The position feedback service configuration
  * @param i_shared_memory The client interface to the shared memory
+ * @param shared_memory_blocks The lock-free shared memory, accessed instead of i_shared_memory if not null
  * @param service_number Service number (1 or 2) use to enable GPIO only on 1.
  */
-void gpio_shared_memory(port * (&?gpio_ports)[4], PositionFeedbackConfig &position_feedback_config, client interface shared_memory_interface ?i_shared_memory, int service_number);
+void gpio_shared_memory(port * (&?gpio_ports)[4], PositionFeedbackConfig &position_feedback_config, client interface shared_memory_interface ?i_shared_memory, SharedMemoryBlocks * unsafe shared_memory_blocks, int service_number);
 
 
 #endif
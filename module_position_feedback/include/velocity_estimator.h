@@ -0,0 +1,118 @@
+/**
+ * @file velocity_estimator.h
+ * @brief Fixed-point alpha-beta-gamma estimator of the velocity and the acceleration from timestamped positions
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Positions older than this number of periods restart the estimator at the new position and the given velocity.
+ */
+#define VELOCITY_ESTIMATOR_MAX_GAP          20
+
+/**
+ * @brief Maximum position error before the estimated position jumps to the measured one [ticks],
+ *        e.g. after set_position or when the multiturn position is reset to 0.
+ */
+#define VELOCITY_ESTIMATOR_MAX_ERROR        16383
+
+/**
+ * @brief Type of the velocity computation of a sensor.
+ */
+typedef enum {
+    VELOCITY_ESTIMATOR_DIFFERENCE       = 0,    /**< Position difference over the velocity compute period (velocity_compute) */
+    VELOCITY_ESTIMATOR_ALPHA_BETA_GAMMA = 1     /**< Steady-state alpha-beta-gamma estimator updated with every position */
+} VelocityEstimatorType;
+
+/**
+ * @brief Structure type of the estimator. The position, the velocity and the acceleration are predicted to the
+ *        timestamp of each position and corrected with constant gains, the three poles of the estimation error are at
+ *        exp(-2*pi*bandwidth*T_s) (critically damped, the steady-state gains of a Kalman filter for a random jerk).
+ *        With a moment of inertia the acceleration is the torque input divided by the inertia plus an estimated
+ *        disturbance acceleration, so the estimate does not lag the torque.
+ *        The sensor services (qei_service, serial_encoder_service) run it position-only, without inertia and with
+ *        torque 0, because they do not know the torque. Only motion_control_service feeds the torque reference, with
+ *        the moment of inertia of its configuration. tests/host/bench_velocity_estimator measures both modes.
+ */
+typedef struct {
+    long long position;             // Q16 [ticks]
+    long long velocity;             // Q32 [ticks/us]
+    long long acceleration;         // Q48 [ticks/us^2], acceleration which is not caused by the torque input
+    int gain_position;              // alpha, Q30
+    int gain_velocity;              // beta/T_s, Q30 [1/us]
+    long long gain_acceleration;    // 2*gamma/T_s^2, Q40 [1/us^2]
+    long long gain_torque;          // acceleration of 1 mNm, Q48 [ticks/us^2]
+    long long velocity_scale;       // Q16 [rpm/(ticks/us)]
+    long long acceleration_scale;   // [(rpm/s)/(ticks/us^2)]
+    int resolution;                 // [ticks/rotation]
+    int max_dt;                     // [us]
+    int torque;                     // torque input of the last period [mNm]
+    unsigned int timestamp;         // [us]
+    int started;
+} VelocityEstimatorParam;
+
+/**
+ * @brief Initializes the estimator without torque input, the first position starts it.
+ *
+ * @param bandwidth     -> bandwidth of the estimator [Hz], at most 1/(2*pi*T_s)
+ * @param resolution    -> resolution of the position sensor [ticks/rotation]
+ * @param T_s           -> period of the positions in us (microseconds), at least 10 us, the timestamps may jitter around it
+ * @param param         -> estimator
+ *
+ * @return 0 if initialized, -1 if a parameter is not valid
+ */
+int velocity_estimator_init(int bandwidth, int resolution, int T_s, REFERENCE_PARAM(VelocityEstimatorParam, param));
+
+/**
+ * @brief Sets the moment of inertia which converts the torque input into acceleration, 0 disables the torque input.
+ *
+ * @param moment_of_inertia -> moment of inertia [g cm^2]
+ * @param param             -> estimator
+ *
+ * @return void
+ */
+void velocity_estimator_set_inertia(int moment_of_inertia, REFERENCE_PARAM(VelocityEstimatorParam, param));
+
+/**
+ * @brief Restarts the estimator at the next position, the gains are kept.
+ *
+ * @param param -> estimator
+ *
+ * @return void
+ */
+void velocity_estimator_reset(REFERENCE_PARAM(VelocityEstimatorParam, param));
+
+/**
+ * @brief Predicts the estimates to the timestamp of a new position and corrects them with the position.
+ *        A position with the timestamp of the last one is ignored.
+ *
+ * @param position  -> absolute multiturn position [ticks]
+ * @param timestamp -> time when the position was read [us], only the difference to the last timestamp is used
+ * @param torque    -> torque since the last position [mNm], ignored without moment of inertia
+ * @param velocity  -> velocity the estimator restarts with [rpm], e.g. the velocity of the sensor, 0 if none is known
+ * @param param     -> estimator
+ *
+ * @return velocity [rpm]
+ */
+int velocity_estimator_update(int position, unsigned int timestamp, int torque, int velocity, REFERENCE_PARAM(VelocityEstimatorParam, param));
+
+/**
+ * @brief Getter for the estimated velocity at the timestamp of the last position.
+ *
+ * @param param -> estimator
+ *
+ * @return velocity [rpm]
+ */
+int velocity_estimator_get_velocity(REFERENCE_PARAM(VelocityEstimatorParam, param));
+
+/**
+ * @brief Getter for the estimated acceleration at the timestamp of the last position, including the torque input.
+ *
+ * @param param -> estimator
+ *
+ * @return acceleration [rpm/s]
+ */
+int velocity_estimator_get_acceleration(REFERENCE_PARAM(VelocityEstimatorParam, param));
@@ -0,0 +1,130 @@
+/**
+ * @file velocity_estimator.c
+ * @brief Fixed-point alpha-beta-gamma estimator of the velocity and the acceleration from timestamped positions
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <velocity_estimator.h>
+#include <math.h>
+
+#define VELOCITY_ESTIMATOR_PI   3.14159265359
+
+/*
+ * x scaled by 2^shift and rounded
+ */
+static long long velocity_estimator_fixed(double x, int shift)
+{
+    return (long long) floor((x * pow(2.00, (double)shift)) + 0.50);
+}
+
+int velocity_estimator_init(int bandwidth, int resolution, int T_s, VelocityEstimatorParam * param)
+{
+    double omega_T, theta, alpha, beta, gamma;
+
+    if (bandwidth <= 0 || resolution <= 0 || T_s < 10)
+        return -1;
+
+    omega_T = (2.00 * VELOCITY_ESTIMATOR_PI * ((double)bandwidth) * ((double)T_s)) / 1000000.00;
+    if (omega_T > 1.00)
+        return -1;
+
+    // triple pole of the estimation error at theta
+    theta = exp(-omega_T);
+    alpha = 1.00 - (theta * theta * theta);
+    beta  = 1.50 * (1.00 - theta) * (1.00 - theta) * (1.00 + theta);
+    gamma = 0.50 * (1.00 - theta) * (1.00 - theta) * (1.00 - theta);
+
+    param->gain_position = (int) velocity_estimator_fixed(alpha, 30);
+    param->gain_velocity = (int) velocity_estimator_fixed(beta / ((double)T_s), 30);
+    param->gain_acceleration = velocity_estimator_fixed((2.00 * gamma) / (((double)T_s) * ((double)T_s)), 40);
+
+    // rpm = ticks/us * 60e6/resolution, rpm/s = ticks/us^2 * 60e12/resolution
+    param->velocity_scale = velocity_estimator_fixed(60000000.00 / ((double)resolution), 16);
+    param->acceleration_scale = velocity_estimator_fixed(60000000000000.00 / ((double)resolution), 0);
+
+    param->resolution = resolution;
+    param->max_dt = VELOCITY_ESTIMATOR_MAX_GAP * T_s;
+    param->gain_torque = 0;
+    param->torque = 0;
+
+    velocity_estimator_reset(param);
+
+    return 0;
+}
+
+void velocity_estimator_set_inertia(int moment_of_inertia, VelocityEstimatorParam * param)
+{
+    long long gain_torque = 0;
+
+    // 1 mNm accelerates J [g cm^2] = J*1e-7 kg m^2 by 1e4/J rad/s^2
+    if (moment_of_inertia > 0)
+        gain_torque = velocity_estimator_fixed(((10000.00 / ((double)moment_of_inertia)) * ((double)param->resolution))
+                / (2.00 * VELOCITY_ESTIMATOR_PI * 1000000000000.00), 48);
+
+    //the estimated acceleration does not jump
+    param->acceleration += (param->gain_torque - gain_torque) * param->torque;
+    param->gain_torque = gain_torque;
+}
+
+void velocity_estimator_reset(VelocityEstimatorParam * param)
+{
+    param->position = 0;
+    param->velocity = 0;
+    param->acceleration = 0;
+    param->timestamp = 0;
+    param->started = 0;
+}
+
+int velocity_estimator_update(int position, unsigned int timestamp, int torque, int velocity, VelocityEstimatorParam * param)
+{
+    long long measured = ((long long)position) * (1LL << 16);
+    long long acceleration, velocity_change, error;
+    int dt = (int)(timestamp - param->timestamp);
+
+    if (!param->started || dt < 0 || dt > param->max_dt)
+    {
+        param->position = measured;
+        //rpm to Q24 [ticks/us], then to Q32
+        param->velocity = ((((long long)velocity) * (1LL << 40)) / param->velocity_scale) * (1LL << 8);
+        param->acceleration = 0;
+        param->started = 1;
+    }
+    else if (dt > 0)
+    {
+        //prediction with the torque of the last period and the estimated disturbance acceleration
+        acceleration = param->acceleration + (param->gain_torque * torque);
+        velocity_change = (acceleration * dt) >> 16;
+        param->position += ((param->velocity + (velocity_change >> 1)) * dt) >> 16;
+        param->velocity += velocity_change;
+
+        //correction, a jump of the position is taken over and the velocity is kept
+        error = measured - param->position;
+        if (error > (((long long)VELOCITY_ESTIMATOR_MAX_ERROR) << 16) || error < -(((long long)VELOCITY_ESTIMATOR_MAX_ERROR) << 16))
+        {
+            param->position = measured;
+        }
+        else
+        {
+            param->position += (error * param->gain_position) >> 30;
+            param->velocity += (error * param->gain_velocity) >> 14;
+            param->acceleration += (error * param->gain_acceleration) >> 8;
+        }
+    }
+
+    param->timestamp = timestamp;
+    param->torque = torque;
+
+    return velocity_estimator_get_velocity(param);
+}
+
+int velocity_estimator_get_velocity(VelocityEstimatorParam * param)
+{
+    return (int)((((param->velocity >> 8) * param->velocity_scale) + (1LL << 39)) >> 40);
+}
+
+int velocity_estimator_get_acceleration(VelocityEstimatorParam * param)
+{
+    long long acceleration = param->acceleration + (param->gain_torque * param->torque);
+
+    return (int)((((acceleration >> 12) * param->acceleration_scale) + (1LL << 35)) >> 36);
+}
@@ -147,6 +147,12 @@ extern int init_linear_profile(int target_value, int actual_value, int accelerat
  */
 extern int linear_profile_generate(int step);
 
+/*
+ * The functions above share one profile of each type per tile. The functions below
+ * keep the profile in a context passed by the caller, so any number of profiles
+ * (e.g. one per axis) can be generated independently and from the same task.
+ */
+
 typedef struct
 {
     float max_acceleration;     // max acceleration
@@ -251,6 +257,38 @@ int __initialize_velocity_profile( int target_velocity, int actual_velocity, int
 
 int __velocity_profile_generate_in_steps( int step, REFERENCE_PARAM(profile_velocity_param, profile_velocity_params) );
 
+typedef struct
+{
+    float qi;
+    float qf;                                   // user input variables
+    float ts;
+    float ci;                                   // motion profile constants
+    float tb, t_int;                            // motion profile params
+    float q;
+    float samp;
+    float cur_pos_s;
+    float acc;
+} profile_position_quick_stop_param;
+
+int __initialize_quick_stop_position_profile( int actual_velocity, int actual_position, int quick_stop_deceleration,
+                                              REFERENCE_PARAM(profile_position_quick_stop_param, pos_param_s) );
+
+int __quick_stop_position_profile_generate_in_steps( int steps, REFERENCE_PARAM(profile_position_quick_stop_param, pos_param_s) );
+
+typedef struct
+{
+    float u;                                    // initial velocity
+    float a_d;                                  // desired acceleration
+    float t;                                    // time
+    float T;                                    // total no. of Samples
+    float s_time;                               // sampling time
+} profile_velocity_quick_stop_param;
+
+int __initialize_quick_stop_velocity_profile( int actual_velocity, int quick_stop_deceleration,
+                                              REFERENCE_PARAM(profile_velocity_quick_stop_param, qstop_vel_params) );
+
+int __quick_stop_velocity_profile_generate_in_steps( int step, REFERENCE_PARAM(profile_velocity_quick_stop_param, qstop_vel_params) );
+
 
 /**
  * @brief Structure type to set the parameters of position reference profiler.
@@ -262,8 +300,18 @@ typedef struct {
     double acceleration_max;        //maximum acceleration  [rpm/s]
     double deceleration_max;        //maximum deceleration  [rpm/s]
     double torque_rate_max;         //torque rate   [mNm/s]
+    double jerk_max;                //maximum jerk  [rpm/s^2], 0 selects the trapezoidal position profiler
 } ProfilerParam;
 
+/**
+ * @brief Structure type to keep the state of the jerk limited position reference profiler.
+ */
+typedef struct {
+    double position;                //profiled position     [ticks]
+    double velocity;                //profiled velocity     [ticks/s]
+    double acceleration;            //profiled acceleration [ticks/s^2]
+} ScurveProfilerState;
+
 /**
  * @brief sign function.
  * @param output, sign of the number
@@ -306,3 +354,149 @@ double velocity_profiler(double velocity_ref, double velocity_ref_in_k_1n, doubl
  * @return  profiled position calculated for the next step
  */
 float pos_profiler(double pos_target, double pos_k_1n, double pos_k_2n, double pos_k_3n, ProfilerParam pos_profiler_param);
+
+/**
+ * @brief initializing the jerk limited position reference profiler
+ * @param   position, position to start from
+ * @param   velocity, velocity to start from [ticks/s]
+ * @param   state, state of the jerk limited position reference profiler
+ */
+void scurve_profiler_init(double position, double velocity, REFERENCE_PARAM(ScurveProfilerState, state));
+
+/**
+ * @brief updating the jerk limited (S-curve) position reference profiler
+ *      Velocity, acceleration, deceleration and jerk of the profiled position stay inside
+ *      the limits of pos_profiler_param and the target is reached without overshoot.
+ *      The target can be changed at any step.
+ * @param   pos_target, target position
+ * @param   pos_profiler_param parameters of the position reference profiler, jerk_max has to be positive
+ * @param   state, state of the jerk limited position reference profiler
+ *
+ * @return  profiled position calculated for the next step
+ */
+double scurve_pos_profiler(double pos_target, ProfilerParam pos_profiler_param, REFERENCE_PARAM(ScurveProfilerState, state));
+
+/**
+ * @brief Maximum decimation of a profile table, every 2^PROFILE_TABLE_MAX_LOG2_DECIMATION-th step is stored.
+ */
+#define PROFILE_TABLE_MAX_LOG2_DECIMATION   8
+
+/**
+ * @brief Entry of a profile table followed by a 32 bit delta in two entries, high half first.
+ */
+#define PROFILE_TABLE_ESCAPE                (-32768)
+
+/**
+ * @brief Largest deviation of a played profile table from its profile accepted by set_profile_position_table(),
+ *        resolution/PROFILE_TABLE_MAX_ERROR_DIVISOR ticks.
+ */
+#define PROFILE_TABLE_MAX_ERROR_DIVISOR     1000
+
+/**
+ * @brief Structure type of a precomputed profile table. The table itself is a caller provided
+ *        buffer of 16 bit entries with one position delta for every 2^log2_decimation steps of the profile.
+ *        An entry is the change of the delta to the previous one, or PROFILE_TABLE_ESCAPE followed by the
+ *        delta itself if the change does not fit into 16 bit.
+ */
+typedef struct {
+    int start_position;             //position before the first step           [ticks]
+    int log2_decimation;            //steps between two stored deltas = 2^log2_decimation
+    int length;                     //number of entries in the table
+    int steps;                      //number of steps of the profile
+    int max_error;                  //largest deviation of the played steps from the profile, set by the builders [ticks]
+    int position;                   //position of the last stored or played delta [ticks]
+    int delta;                      //last stored or played delta [ticks]
+    int index;                      //entry to be played
+    int step;                       //step inside the delta
+} ProfileTable;
+
+/**
+ * @brief initializing an empty profile table
+ * @param   start_position, position before the first step
+ * @param   log2_decimation, only every 2^log2_decimation-th step is stored, range [0 - PROFILE_TABLE_MAX_LOG2_DECIMATION]
+ * @param   table, profile table
+ */
+void profile_table_init(int start_position, int log2_decimation, REFERENCE_PARAM(ProfileTable, table));
+
+/**
+ * @brief appending the next step of a profile to a profile table
+ * @param   position, position of the step
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ * @param   buffer_size, size of buffer
+ *
+ * @return  0 if the step was appended, -1 if the buffer is full or the negated delta does not fit into an int
+ */
+int profile_table_append(int position, REFERENCE_PARAM(ProfileTable, table), short buffer[], int buffer_size);
+
+/**
+ * @brief completing the last delta of a profile table with the final position and rewinding it
+ * @param   final_position, position the profile ends at
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ * @param   buffer_size, size of buffer
+ *
+ * @return  number of entries in the table, -1 if the buffer is full
+ */
+int profile_table_finish(int final_position, REFERENCE_PARAM(ProfileTable, table), short buffer[], int buffer_size);
+
+/**
+ * @brief rewinding a profile table to its first step
+ * @param   table, profile table
+ */
+void profile_table_rewind(REFERENCE_PARAM(ProfileTable, table));
+
+/**
+ * @brief negating a profile table in place for the inverted polarity and rewinding it
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ */
+void profile_table_negate(REFERENCE_PARAM(ProfileTable, table), short buffer[]);
+
+/**
+ * @brief playing the next step of a profile table, uses integer arithmetic only
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ *
+ * @return  position of the step, the final position once the table is done
+ */
+int profile_table_next(REFERENCE_PARAM(ProfileTable, table), short buffer[]);
+
+/**
+ * @brief checking if all steps of a profile table were played
+ * @param   table, profile table
+ *
+ * @return  1 if the table is done, 0 otherwise
+ */
+int profile_table_done(REFERENCE_PARAM(ProfileTable, table));
+
+/**
+ * @brief evaluating a position profile (Linear Function with Parabolic Blends) into a profile table
+ * @param   profile, position profile initialized with __initialize_position_profile()
+ * @param   delta_T, period of the steps [s]
+ * @param   log2_decimation, only every 2^log2_decimation-th step is stored
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ * @param   buffer_size, size of buffer
+ *
+ * @return  number of entries in the table, -1 if the profile does not fit into the buffer,
+ *          table.max_error is the interpolation error
+ */
+int profile_table_build_lfpb(REFERENCE_PARAM(profile_position_param, profile), double delta_T, int log2_decimation,
+        REFERENCE_PARAM(ProfileTable, table), short buffer[], int buffer_size);
+
+/**
+ * @brief evaluating a jerk limited position profile into a profile table
+ * @param   pos_target, target position
+ * @param   pos_profiler_param parameters of the position reference profiler
+ * @param   state, state of the jerk limited position reference profiler to start from, at the target afterwards
+ * @param   log2_decimation, only every 2^log2_decimation-th step is stored
+ * @param   table, profile table
+ * @param   buffer, entries of the profile table
+ * @param   buffer_size, size of buffer
+ *
+ * @return  number of entries in the table, -1 if the profile does not fit into the buffer,
+ *          table.max_error is the interpolation error
+ */
+int profile_table_build_scurve(double pos_target, ProfilerParam pos_profiler_param, REFERENCE_PARAM(ScurveProfilerState, state),
+        int log2_decimation, REFERENCE_PARAM(ProfileTable, table), short buffer[], int buffer_size);
@@ -81,6 +81,28 @@ void init_position_profiler(ProfilerConfig profile_position_config);
 void set_profile_position( DownstreamControlData &downstream_control_data, int velocity, int acceleration, int deceleration,
                            interface MotionControlInterface client i_motion_control );
 
+/**
+ * @brief Evaluates a profile ramp from the current position to the defined target position once
+ *        into a profile table and sends it to the Position Control Service, which plays one step of
+ *        the table per control period. Returns without waiting for the end of the profile.
+ *        A profile longer than POSITION_PROFILE_TABLE_SIZE entries at the maximum decimation, or whose
+ *        interpolation deviates by more than 1/PROFILE_TABLE_MAX_ERROR_DIVISOR turn, is sent with
+ *        set_profile_position() instead, which returns at the end of the profile.
+ *        The table is built in a static buffer, so only one task may call it.
+ *
+ * @param profile_position_config Configuration for the Position Profiler.
+ * @param downstream_control_data position_cmd is the new target position in [INT_MIN:INT_MAX].
+ * @param velocity in [RPM].
+ * @param acceleration in [RPM/s].
+ * @param deceleration [RPM/s].
+ * @param i_motion_control Communication interface to the Position Control Service.
+ *
+ * @return number of control periods of the profile, 0 if it was sent with set_profile_position().
+ */
+int set_profile_position_table( ProfilerConfig profile_position_config, DownstreamControlData &downstream_control_data,
+                                int velocity, int acceleration, int deceleration,
+                                interface MotionControlInterface client i_motion_control );
+
 /**
  * @brief Set profile velocity with Velocity Control loop
  *
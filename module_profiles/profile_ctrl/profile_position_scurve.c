@@ -0,0 +1,165 @@
+/**
+ * @file profile_position_scurve.c
+ * @brief Jerk limited (S-curve) online position profiler
+ *      The profiler keeps its own position, velocity and acceleration. Every step it
+ *      applies the highest jerk from which the target can still be reached without
+ *      overshoot, so the target may be changed at any time.
+ * @author Synapticon GmbH <support@synapticon.com>
+*/
+
+#include <profile.h>
+
+static double scurve_sign(double x)
+{
+    if (x < 0)
+        return -1.00;
+    else
+        return 1.00;
+}
+
+/*
+ * integrates the state for a time t with a constant jerk j
+ */
+static void scurve_integrate(double *p, double *v, double *a, double j, double t)
+{
+    *p += ((*v) * t) + ((*a) * t * t / 2.00) + (j * t * t * t / 6.00);
+    *v += ((*a) * t) + (j * t * t / 2.00);
+    *a += j * t;
+}
+
+/*
+ * distance needed to bring velocity and acceleration to zero with the shortest braking,
+ * which ramps the acceleration to the peak deceleration, holds it and ramps it back to zero
+ */
+static double scurve_stop_distance(double v, double a, double d_max, double j_max)
+{
+    double direction, a_peak, t_ramp, t_hold = 0.00, p = 0.00;
+
+    // direction of the motion once the acceleration is ramped to zero
+    direction = scurve_sign(v + ((a * fabs(a)) / (2.00 * j_max)));
+    v *= direction;
+    a *= direction;
+
+    a_peak = sqrt((j_max * v) + ((a * a) / 2.00));
+    if (a_peak > d_max)
+    {
+        a_peak = d_max;
+        t_hold = (v + ((a * a) / (2.00 * j_max)) - ((d_max * d_max) / j_max)) / d_max;
+    }
+
+    t_ramp = (a + a_peak) / j_max;
+    if (t_ramp < 0)
+        t_ramp = 0;
+
+    scurve_integrate(&p, &v, &a, -j_max, t_ramp);
+    scurve_integrate(&p, &v, &a, 0.00, t_hold);
+    scurve_integrate(&p, &v, &a, j_max, a_peak / j_max);
+
+    return direction * p;
+}
+
+/*
+ * distance to the target left after braking, if jerk j is applied during the next step.
+ * A negative value means the target would be overshot.
+ */
+static double scurve_margin(double pos_target, double direction, ScurveProfilerState *state, double j,
+        double d_max, double j_max, double delta_T)
+{
+    double p = state->position, v = state->velocity, a = state->acceleration;
+
+    scurve_integrate(&p, &v, &a, j, delta_T);
+
+    return direction * (pos_target - (p + scurve_stop_distance(v, a, d_max, j_max)));
+}
+
+void scurve_profiler_init(double position, double velocity, ScurveProfilerState *state)
+{
+    state->position = position;
+    state->velocity = velocity;
+    state->acceleration = 0.00;
+}
+
+double scurve_pos_profiler(double pos_target, ProfilerParam pos_profiler_param, ScurveProfilerState *state)
+{
+    double v_max, a_max, d_max, j_max, a_limit, delta_T;
+    double error, direction, v_braked, dv, a_desired, j, j_low, j_high, j_brake, margin, margin_brake;
+
+    delta_T = pos_profiler_param.delta_T;
+    v_max = (pos_profiler_param.v_max * pos_profiler_param.resolution) / 60.00;
+    a_max = (pos_profiler_param.acceleration_max * pos_profiler_param.resolution) / 60.00;
+    d_max = (pos_profiler_param.deceleration_max * pos_profiler_param.resolution) / 60.00;
+    j_max = (pos_profiler_param.jerk_max * pos_profiler_param.resolution) / 60.00;
+
+    if (v_max <= 0 || a_max <= 0 || d_max <= 0 || j_max <= 0)
+    {
+        scurve_profiler_init(pos_target, 0.00, state);
+        return pos_target;
+    }
+
+    error = pos_target - state->position;
+    direction = scurve_sign(error);
+
+    //settled, snap to the target
+    if ((fabs(error) < 0.50) && (fabs(state->velocity) < (2.00 * j_max * delta_T * delta_T)) && (fabs(state->acceleration) < (j_max * delta_T)))
+    {
+        scurve_profiler_init(pos_target, 0.00, state);
+        return pos_target;
+    }
+
+    //jerk limits of this step keeping the acceleration inside its limits
+    a_limit = (a_max > d_max) ? a_max : d_max;
+    j_low = (-a_limit - state->acceleration) / delta_T;
+    j_high = (a_limit - state->acceleration) / delta_T;
+    if (j_low < -j_max)
+        j_low = -j_max;
+    if (j_high > j_max)
+        j_high = j_max;
+
+    //jerk to reach the maximum velocity towards the target
+    v_braked = state->velocity + ((state->acceleration * fabs(state->acceleration)) / (2.00 * j_max));
+    dv = (direction * v_max) - v_braked;
+    a_desired = scurve_sign(dv) * (sqrt((2.00 * j_max * fabs(dv)) + (j_max * j_max * delta_T * delta_T / 4.00)) - (j_max * delta_T / 2.00));
+    if (a_desired > a_max)
+        a_desired = a_max;
+    if (a_desired < -a_max)
+        a_desired = -a_max;
+
+    j = (a_desired - state->acceleration) / delta_T;
+    if (j > j_high)
+        j = j_high;
+    if (j < j_low)
+        j = j_low;
+
+    //brake as little as possible if the target would be overshot
+    margin = scurve_margin(pos_target, direction, state, j, d_max, j_max, delta_T);
+    if (margin < 0)
+    {
+        j_brake = (direction > 0) ? j_low : j_high;
+        margin_brake = scurve_margin(pos_target, direction, state, j_brake, d_max, j_max, delta_T);
+
+        if (margin_brake > 0)
+        {
+            for (int i = 0; i < 2; i++)
+            {
+                double j_test = j_brake + (((j - j_brake) * margin_brake) / (margin_brake - margin));
+                double margin_test = scurve_margin(pos_target, direction, state, j_test, d_max, j_max, delta_T);
+
+                if (margin_test >= 0)
+                {
+                    j_brake = j_test;
+                    margin_brake = margin_test;
+                }
+                else
+                {
+                    j = j_test;
+                    margin = margin_test;
+                }
+            }
+        }
+        j = j_brake;
+    }
+
+    scurve_integrate(&state->position, &state->velocity, &state->acceleration, j, delta_T);
+
+    return state->position;
+}
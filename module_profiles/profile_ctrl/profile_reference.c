@@ -0,0 +1,189 @@
+/**
+ * @file profile_reference.c
+ * @brief Online reference profilers of the motion control loop
+ *      Limit the rate of change of the position, velocity and torque references,
+ *      one step per control period. Plain C, so they are shared with host builds.
+ * @author Synapticon GmbH <support@synapticon.com>
+*/
+
+#include <profile.h>
+
+/**
+ * @brief sign function.
+ * @param output, sign of the number
+ * @param input, number
+ */
+int sign_function(float a)
+{
+    if (a < 0)
+        return -1;
+    else
+        return 1;
+}
+
+/**
+ * @brief updating the position reference profiler
+ * @param   pos_target, target position
+ * @param   pos_k_1n, profiled position calculated in one step ago
+ * @param   pos_k_2n, profiled position calculated in two steps ago
+ * @param   pos_actual, profiled position calculated in three steps ago
+ * @param   pos_profiler_param parameters of the position reference profiler
+ *
+ * @return  profiled position calculated for the next step
+ */
+float pos_profiler(double pos_target, double pos_k_1n, double pos_k_2n, double pos_actual, ProfilerParam pos_profiler_param)
+{
+    double velocity_k_1n, temp, deceleration_distance, pos_deceleration, pos_k, pos_temp1, pos_temp2, v_max = 0.00, a_max = 0.00, d_max = 0.00;
+    int deceleration_flag = 0;
+
+    v_max = (((double)(pos_profiler_param.v_max)) * pos_profiler_param.resolution )/60.00;
+
+    velocity_k_1n = ((pos_k_1n - pos_k_2n) / pos_profiler_param.delta_T);
+    a_max = (((double)(pos_profiler_param.acceleration_max)) * pos_profiler_param.resolution )/60.00;
+    d_max = (((double)(pos_profiler_param.deceleration_max)) * pos_profiler_param.resolution )/60.00;
+
+    if (pos_target == pos_k_1n)
+        pos_k = pos_target;
+    else if (pos_target > pos_k_1n)
+    {
+        if (((pos_k_1n-pos_k_2n)==0) && (pos_target < (pos_k_1n+10)))
+            pos_k = pos_k_1n; //ignore the command
+        else
+        {
+            velocity_k_1n = ((pos_k_1n - pos_k_2n) / pos_profiler_param.delta_T);
+            deceleration_distance = (velocity_k_1n * velocity_k_1n) / (2 * d_max);
+            pos_deceleration = pos_target - deceleration_distance;
+            if ((pos_k_1n >= pos_deceleration) && (pos_k_1n > pos_k_2n))
+                deceleration_flag = 1;//we are getting close to the target, and we should decelerate now
+            temp = pos_profiler_param.delta_T * pos_profiler_param.delta_T * a_max;
+            if (deceleration_flag == 0)
+            {
+                pos_temp1 = temp + (2 * pos_k_1n) - pos_k_2n;
+                pos_temp2 = (pos_profiler_param.delta_T * v_max) + pos_k_1n;
+                if (pos_temp1 < pos_temp2)
+                    pos_k = pos_temp1;
+                else
+                    pos_k = pos_temp2;
+            }
+            else
+            {
+                temp = pos_profiler_param.delta_T * pos_profiler_param.delta_T * d_max;
+                pos_k = -temp + (2 * pos_k_1n) - pos_k_2n;
+            }
+            if (pos_k > pos_target)
+                pos_k = pos_target;
+            if ((pos_k < pos_target) && (sign_function(pos_k_1n-pos_k_2n) > sign_function(pos_k-pos_k_1n)))
+                pos_k = pos_target;
+        }
+    }
+    else
+    {
+        if (((pos_k_1n-pos_k_2n)==0) && (pos_target > (pos_k_1n-10)))
+            pos_k = pos_k_1n; //ignore the command
+        else
+        {
+            velocity_k_1n = ((pos_k_1n - pos_k_2n) / pos_profiler_param.delta_T);
+            deceleration_distance = (velocity_k_1n * velocity_k_1n) / (2 * d_max);
+            pos_deceleration = pos_target + deceleration_distance;
+            if ((pos_k_1n <= pos_deceleration) && (pos_k_1n < pos_k_2n))
+                deceleration_flag = 1;
+            temp = pos_profiler_param.delta_T * pos_profiler_param.delta_T * a_max;
+            if (deceleration_flag == 0)
+            {
+                pos_temp1 = -temp + (2 * pos_k_1n) - pos_k_2n;
+                pos_temp2 = -(pos_profiler_param.delta_T * v_max) + pos_k_1n;
+                if (pos_temp1 > pos_temp2)
+                    pos_k = pos_temp1;
+                else
+                    pos_k = pos_temp2;
+            }
+            else
+            {
+                temp = pos_profiler_param.delta_T * pos_profiler_param.delta_T * d_max;
+                pos_k = temp + (2 * pos_k_1n) - pos_k_2n;
+            }
+            if (pos_k < pos_target)
+                pos_k = pos_target;
+            if ((pos_k > pos_target) && (sign_function(pos_k_1n-pos_k_2n) < sign_function(pos_k-pos_k_1n)))
+                pos_k = pos_target;
+        }
+    }
+
+    return pos_k;
+}
+
+/**
+ * @brief updating the torque reference profiler
+ *
+ * @param   torque_ref, target torque
+ * @param   torque_ref_in_k_1n, profiled torque calculated in one step
+ * @param   profiler_param, structure containing the profiler parameters
+ * @param   torque_control_loop, the execution cycle of torque controller (us)
+ *
+ * @return  profiled torque calculated for the next step
+ */
+double torque_profiler(double torque_ref, double torque_ref_in_k_1n, ProfilerParam profiler_param, int position_control_loop)
+{
+
+    double torque_step=0.00, torque_ref_in_k=0.00;
+    double torque_error=0.00;
+
+    torque_step = (((double)(position_control_loop)) * profiler_param.torque_rate_max )/1000000.00;
+    //r_max [mNm/s] / 1000 [mNm/ms] * (position_control_loop/1000) mNm
+    if(torque_step<0) torque_step=-torque_step;
+
+    if(torque_ref_in_k_1n<torque_ref)
+    {
+        torque_ref_in_k = torque_ref_in_k_1n + torque_step;
+    }
+    else if (torque_ref_in_k_1n>torque_ref)
+    {
+        torque_ref_in_k = torque_ref_in_k_1n - torque_step;
+    }
+
+    torque_error = torque_ref - torque_ref_in_k_1n;
+    if( (-torque_step)<torque_error  && torque_error<torque_step)
+        torque_ref_in_k = torque_ref;
+
+    return torque_ref_in_k;
+}
+
+/**
+ * @brief updating the velocity reference profiler
+ *
+ * @param   velocity_ref, target velocity
+ * @param   velocity_ref_in_k_1n, profiled velocity calculated in one step
+ * @param   velocity_actual, actual value of velocity
+ * @param   profiler_param, structure containing the profiler parameters
+ * @param   velocity_control_loop, the execution cycle of velocity controller (us)
+ *
+ * @return  profiled velocity calculated for the next step
+ */
+double velocity_profiler(double velocity_ref, double velocity_ref_in_k_1n, double velocity_actual, ProfilerParam profiler_param, int position_control_loop)
+{
+
+    double velocity_step=0.00, velocity_ref_in_k=0.00;
+    double velocity_error=0.00;
+
+    if(velocity_ref>velocity_actual)
+        velocity_step = (((double)(position_control_loop)) * profiler_param.acceleration_max )/1000000.00; //rpm/s
+    else
+        velocity_step = (((double)(position_control_loop)) * profiler_param.deceleration_max )/1000000.00; //rpm/s
+
+    if(velocity_step<0) velocity_step=-velocity_step;
+
+    if(velocity_ref_in_k_1n<velocity_ref)
+    {
+        velocity_ref_in_k = velocity_ref_in_k_1n + velocity_step;
+    }
+    else if (velocity_ref_in_k_1n>velocity_ref)
+    {
+        velocity_ref_in_k = velocity_ref_in_k_1n - velocity_step;
+    }
+
+    velocity_error = velocity_ref - velocity_ref_in_k_1n;
+    if( (-velocity_step)<velocity_error  && velocity_error<velocity_step)
+        velocity_ref_in_k = velocity_ref;
+
+    return velocity_ref_in_k;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file profile_table.c
+ * @brief Precomputed profile tables
+ *      A profile is evaluated once into a table of position deltas, taken every
+ *      2^log2_decimation steps. Each delta is stored as the 16 bit change to the previous
+ *      delta, or as PROFILE_TABLE_ESCAPE followed by the 32 bit delta in two entries if the
+ *      change does not fit. Playing the table back interpolates linearly between the stored
+ *      steps and needs integer arithmetic only.
+ * @author Synapticon GmbH <support@synapticon.com>
+*/
+
+#include <profile.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#define PROFILE_TABLE_CHANGE_MAX    32767   //largest change of the delta stored in one entry
+
+static int profile_table_escaped_delta(short buffer[], int index)
+{
+    return (int) ((((unsigned) (unsigned short) buffer[index + 1]) << 16) | ((unsigned) (unsigned short) buffer[index + 2]));
+}
+
+static void profile_table_escape_delta(int delta, short buffer[], int index)
+{
+    buffer[index] = PROFILE_TABLE_ESCAPE;
+    buffer[index + 1] = (short) (((unsigned) delta) >> 16);
+    buffer[index + 2] = (short) (((unsigned) delta) & 0xffff);
+}
+
+void profile_table_init(int start_position, int log2_decimation, ProfileTable *table)
+{
+    if (log2_decimation < 0)
+        log2_decimation = 0;
+    if (log2_decimation > PROFILE_TABLE_MAX_LOG2_DECIMATION)
+        log2_decimation = PROFILE_TABLE_MAX_LOG2_DECIMATION;
+
+    table->start_position = start_position;
+    table->log2_decimation = log2_decimation;
+    table->length = 0;
+    table->steps = 0;
+    table->max_error = 0;
+    table->position = start_position;
+    table->delta = 0;
+    table->index = 0;
+    table->step = 0;
+}
+
+int profile_table_append(int position, ProfileTable *table, short buffer[], int buffer_size)
+{
+    long long delta, change;
+
+    table->step++;
+    if (table->step < (1 << table->log2_decimation))
+    {
+        table->steps++;
+        return 0;
+    }
+
+    //-delta must fit as well, the table is negated for the inverted polarity
+    delta = ((long long) position) - table->position;
+    change = delta - table->delta;
+    if (delta > INT_MAX || delta < -INT_MAX)
+    {
+        table->step--;
+        return -1;
+    }
+
+    if (change <= PROFILE_TABLE_CHANGE_MAX && change >= -PROFILE_TABLE_CHANGE_MAX)
+    {
+        if (table->length >= buffer_size)
+        {
+            table->step--;
+            return -1;
+        }
+        buffer[table->length] = (short) change;
+        table->length++;
+    }
+    else
+    {
+        if (table->length + 3 > buffer_size)
+        {
+            table->step--;
+            return -1;
+        }
+        profile_table_escape_delta((int) delta, buffer, table->length);
+        table->length += 3;
+    }
+
+    table->steps++;
+    table->position = position;
+    table->delta = (int) delta;
+    table->step = 0;
+
+    return 0;
+}
+
+int profile_table_finish(int final_position, ProfileTable *table, short buffer[], int buffer_size)
+{
+    //hold the final position until the last delta is complete
+    while (table->step != 0)
+    {
+        if (profile_table_append(final_position, table, buffer, buffer_size) != 0)
+            return -1;
+    }
+
+    profile_table_rewind(table);
+
+    return table->length;
+}
+
+void profile_table_rewind(ProfileTable *table)
+{
+    table->position = table->start_position;
+    table->delta = 0;
+    table->index = 0;
+    table->step = 0;
+}
+
+void profile_table_negate(ProfileTable *table, short buffer[])
+{
+    int index = 0;
+
+    while (index < table->length)
+    {
+        if (buffer[index] == PROFILE_TABLE_ESCAPE)
+        {
+            profile_table_escape_delta(-profile_table_escaped_delta(buffer, index), buffer, index);
+            index += 3;
+        }
+        else
+        {
+            buffer[index] = -buffer[index];
+            index++;
+        }
+    }
+
+    table->start_position = -table->start_position;
+    profile_table_rewind(table);
+}
+
+int profile_table_next(ProfileTable *table, short buffer[])
+{
+    if (table->step == 0)
+    {
+        if (table->index >= table->length)
+            return table->position;
+
+        //start the next delta
+        if (buffer[table->index] == PROFILE_TABLE_ESCAPE)
+        {
+            table->delta = profile_table_escaped_delta(buffer, table->index);
+            table->index += 3;
+        }
+        else
+        {
+            table->delta += buffer[table->index];
+            table->index++;
+        }
+    }
+
+    table->step++;
+
+    if (table->step == (1 << table->log2_decimation))
+    {
+        table->position += table->delta;
+        table->step = 0;
+        return table->position;
+    }
+
+    return table->position + (int) (((((long long) table->delta) * table->step) + (1 << (table->log2_decimation - 1))) >> table->log2_decimation);
+}
+
+int profile_table_done(ProfileTable *table)
+{
+    return (table->index >= table->length && table->step == 0);
+}
+
+static void profile_table_check(int position, int expected, ProfileTable *table)
+{
+    int error = abs(position - expected);
+
+    if (error > table->max_error)
+        table->max_error = error;
+}
+
+int profile_table_build_lfpb(profile_position_param *profile, double delta_T, int log2_decimation,
+        ProfileTable *table, short buffer[], int buffer_size)
+{
+    int final_position = (int) round(profile->qf);
+    int steps = 0;
+    int length;
+
+    profile_table_init((int) round(profile->qi), log2_decimation, table);
+
+    if (profile->total_distance > 0 && profile->tf > 0)
+    {
+        //evaluate the profile at the period of the control loop instead of 1 ms
+        profile->s_time = (float) delta_T;
+        steps = (int) (profile->tf / delta_T);
+
+        for (int i = 1; i <= steps; i++)
+        {
+            if (profile_table_append(__position_profile_generate_in_steps(i, profile), table, buffer, buffer_size) != 0)
+                return -1;
+        }
+    }
+
+    if (profile_table_append(final_position, table, buffer, buffer_size) != 0)
+        return -1;
+
+    length = profile_table_finish(final_position, table, buffer, buffer_size);
+    if (length < 0)
+        return -1;
+
+    //play the table against the profile for the interpolation error
+    for (int i = 1; !profile_table_done(table); i++)
+        profile_table_check(profile_table_next(table, buffer), i <= steps ? __position_profile_generate_in_steps(i, profile) : final_position, table);
+    profile_table_rewind(table);
+
+    return length;
+}
+
+int profile_table_build_scurve(double pos_target, ProfilerParam pos_profiler_param, ScurveProfilerState *state,
+        int log2_decimation, ProfileTable *table, short buffer[], int buffer_size)
+{
+    ScurveProfilerState start_state = *state;
+    int final_position = (int) round(pos_target);
+    int length, done = 0;
+    double position;
+
+    profile_table_init((int) round(state->position), log2_decimation, table);
+
+    do {
+        position = scurve_pos_profiler(pos_target, pos_profiler_param, state);
+
+        if (profile_table_append((int) round(position), table, buffer, buffer_size) != 0)
+            return -1;
+    } while (position != pos_target || state->velocity != 0);
+
+    length = profile_table_finish(final_position, table, buffer, buffer_size);
+    if (length < 0)
+        return -1;
+
+    //play the table against the same profile for the interpolation error
+    while (!profile_table_done(table))
+    {
+        int expected = final_position;
+
+        if (!done)
+        {
+            position = scurve_pos_profiler(pos_target, pos_profiler_param, &start_state);
+            expected = (int) round(position);
+            done = (position == pos_target && start_state.velocity == 0);
+        }
+        profile_table_check(profile_table_next(table, buffer), expected, table);
+    }
+    profile_table_rewind(table);
+
+    return length;
+}
@@ -8,114 +8,32 @@
 #include <profile.h>
 #include <stdio.h>
 
-struct
-{
-    float max_acceleration, max_deceleration;   // max allowed acceleration & deceleration
-    float max_value;                            // max allowed value
-    int polarity;
-    float acc, dec;                             // acceleration & deceleration input
-    float u;                                    // initial value
-    float v_d;                                  // desired value
-    float a_d;                                  // desired acceleration
-    float t;                                    // time
-    float T;                                    // total no. of Samples
-    float s_time;                               // sampling time
-    int oldst;                                  // old state of acc/dec
-} profile_linear_params;
+/* context of the linear profile functions without context parameter */
+static profile_linear_param profile_linear_params;
+static float profile_linear_max_value;
+static int profile_linear_polarity;
 
 
 void init_linear_profile_limits(int max_value, int polarity){
 
-    profile_linear_params.polarity = polarity;
-    profile_linear_params.max_value = (float) max_value;
+    profile_linear_polarity = polarity;
+    profile_linear_max_value = (float) max_value;
 }
 
 int get_linear_profile_polarity(){
 
-    return profile_linear_params.polarity;
+    return profile_linear_polarity;
 }
 
 int init_linear_profile(int target_value, int actual_value, int acceleration, int deceleration)
 {
-    profile_linear_params.u = (float) actual_value;
-    profile_linear_params.acc = (float) acceleration;
-    profile_linear_params.dec = (float) deceleration;
-
-    if (target_value >=  profile_linear_params.max_value) {
-        target_value =  profile_linear_params.max_value;
-    } else if(target_value <= - profile_linear_params.max_value) {
-        target_value = 0- profile_linear_params.max_value;
-    }
-
-    profile_linear_params.v_d = (float) target_value;
-    //printf("srta");
-    //printf("\n%d\n",target_value);
-
-    if(profile_linear_params.u>=0 && profile_linear_params.v_d >=0) {
-        /* both initial and desired velocity - positive case */
-        if (profile_linear_params.v_d >= profile_linear_params.u) {
-            profile_linear_params.a_d = profile_linear_params.acc;
-            profile_linear_params.oldst= 1;
-        } else if (profile_linear_params.v_d < profile_linear_params.u) {
-            profile_linear_params.a_d = profile_linear_params.dec;
-            profile_linear_params.oldst= 2;
-        }
-    } else if(profile_linear_params.u<=0 && profile_linear_params.v_d <=0) {
-        /* both initial and desired velocity - negative case */
-        if (profile_linear_params.u==0) {
-            profile_linear_params.a_d = profile_linear_params.acc;
-            profile_linear_params.oldst= -1;
-        } else if(profile_linear_params.v_d==0) {
-            profile_linear_params.a_d = -profile_linear_params.dec;
-            profile_linear_params.oldst= -2;
-        } else {
-            if (profile_linear_params.v_d < profile_linear_params.u) {
-                profile_linear_params.a_d = -profile_linear_params.acc;
-                profile_linear_params.oldst= -1;
-            } else if (profile_linear_params.v_d > profile_linear_params.u) {
-                profile_linear_params.a_d = -profile_linear_params.dec;
-                profile_linear_params.oldst= -2;
-            }
-        }
-    } else if (profile_linear_params.u>0 && profile_linear_params.v_d<0) {
-        /* initial and desired velocity - transition from +ve to -ve case */
-        if (profile_linear_params.oldst==2 || profile_linear_params.oldst==-2) {
-            profile_linear_params.a_d = profile_linear_params.acc;
-            profile_linear_params.oldst= 1;
-        } else {
-            profile_linear_params.a_d = profile_linear_params.dec;
-            profile_linear_params.oldst= 2;
-        }
-    } else if(profile_linear_params.u<0 && profile_linear_params.v_d>0) {
-        /* initial and desired velocity - transition from -ve to +ve case */
-        if(profile_linear_params.oldst==-1) {
-            profile_linear_params.a_d = -profile_linear_params.dec;
-            profile_linear_params.oldst=-2;
-        } else {
-            profile_linear_params.a_d = -profile_linear_params.acc;
-            profile_linear_params.oldst= -1;
-        }
-    }
-
-    profile_linear_params.s_time = .001f;
-
-    // compute time needed
-    profile_linear_params.t = (profile_linear_params.v_d - profile_linear_params.u)/profile_linear_params.a_d;
-
-    profile_linear_params.T = profile_linear_params.t/profile_linear_params.s_time;
-
-    if (profile_linear_params.T<0)
-        profile_linear_params.T = -profile_linear_params.T;
-
-    //length = (int) round (T);
-    profile_linear_params.s_time = profile_linear_params.t/profile_linear_params.T;
-
-    return (int) round (profile_linear_params.T);
+    return __init_linear_profile_float((float) target_value, (float) actual_value, (float) acceleration,
+                                       (float) deceleration, profile_linear_max_value, &profile_linear_params);
 }
 
 int linear_profile_generate(int step)
 {
-    return (int) round( profile_linear_params.u + profile_linear_params.a_d * profile_linear_params.s_time * step);
+    return (int) round(__linear_profile_generate_float(step, &profile_linear_params));
 }
 
 int __init_linear_profile_float(float target_value, float actual_value, float acceleration,
@@ -37,7 +37,28 @@ unsigned long get_pwm_struct_address( // Converts PWM structure reference to add
 ); // Return address
 
 /**
- * @brief Convert all PWM pulse widths to pattern/time_offset port data
+ * @brief Initialize the dead-time compensation and clear the phase currents.
+ * The pulse of a phase is widened by width for a positive current (params.currents) and narrowed for a negative one,
+ * inside [-band, band] the correction is proportional to the current. The compensation fades out between the
+ * modulation depths DEADTIME_COMP_FADE_START and DEADTIME_COMP_FADE_END.
+ *
+ * @param pwm_comms_ps      Pointer to structure containing PWM communication data
+ * @param width             Compensation width (in clock ticks), 0 disables the compensation
+ * @param band              Half width of the zero crossing region (in units of the phase currents)
+ * @param pwm_max_value     Maximum pwm value which can be sent to pwm server (number of clock ticks)
+ *
+ * @return void
+ */
+void init_deadtime_compensation(
+	REFERENCE_PARAM( PWM_COMMS_TYP ,pwm_comms_ps),
+	int width,
+	int band,
+	unsigned int pwm_max_value
+);
+
+/**
+ * @brief Convert all PWM pulse widths to pattern/time_offset port data.
+ * The widths are compensated for the dead-time if enabled with init_deadtime_compensation.
  *
  * @param pwm_comms_ps      Pointer to structure containing PWM communication data
  * @param pwm_buf_ps        Pointer to Structure containing buffered PWM output data
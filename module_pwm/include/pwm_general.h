@@ -62,9 +62,32 @@ typedef enum PWM_PHASE_ETAG
 typedef struct PWM_PARAM_TAG
 {
 	unsigned widths[_NUM_PWM_PHASES]; // Array of PWM width values
+	int currents[_NUM_PWM_PHASES]; // Array of phase currents (or values of the same sign) for the dead-time compensation
 	int id; // Unique Motor identifier e.g. 0 or 1 (NB -1 used to signal termination)
 } PWM_PARAM_TYP;
 
+/**
+ * @brief Define Modulation depths [%] between which the dead-time compensation fades out
+ * The PWM service takes the sign of the phase currents from the phase voltages, which only holds at low speed where the
+ * power-factor angle is small. Below DEADTIME_COMP_FADE_START the compensation is applied fully, above DEADTIME_COMP_FADE_END
+ * it is off. 100% is a phase voltage amplitude of half the PWM period.
+ */
+#define DEADTIME_COMP_FADE_START 25
+#define DEADTIME_COMP_FADE_END   50
+
+/**
+ * @brief Structure containing the dead-time compensation parameters
+ */
+typedef struct PWM_DEADTIME_COMP_TAG
+{
+	int width; // Width added to the pulse of a phase with positive current, removed with negative current (0: disabled)
+	int band; // Half width of the zero crossing region of the current, inside it the compensation is linear
+	int slope; // width/band, Q16
+	int fade_start; // Phase voltage (3 x pulse width above the mean of the phases) where the fade-out starts
+	int fade_end; // Phase voltage where the compensation is off
+	int fade_slope; // 1/(fade_end - fade_start), Q24
+} PWM_DEADTIME_COMP_TYP;
+
 /**
  * @brief Structure containing pwm communication control data
  */
@@ -73,6 +96,7 @@ typedef struct PWM_COMMS_TAG
 	PWM_PARAM_TYP params; // Structure of PWM parameters (for Server)
 	int buf; 	// double-buffer identifier. e.g. 0 or 1
 	unsigned mem_addr; // Shared memory address (if used)
+	PWM_DEADTIME_COMP_TYP deadtime_comp; // Dead-time compensation parameters
 } PWM_COMMS_TYP;
 
 /**
@@ -112,6 +112,10 @@ void pwm_config(PwmPorts &ports);
  * @param duty_maintain_brake   PWM value which is used to maintain the electric brake
  * @param time_start_brake      Required time to start the brake (in milliseconds)
  * @param ifm_tile_usec         Reference clock frequency of IFM tile (in MHz)
+ * @param deadtime_compensation         Dead-time compensation of the power stage (in nanoseconds), 0 disables it.
+ *                                      The pulse of a phase is widened by it for a positive phase current and narrowed for a negative one.
+ * @param deadtime_compensation_band    Phase voltage (as pulse width in nanoseconds) below which the compensation fades out
+ *                                      linearly, where the sign of the phase current is uncertain
  *
  * @return void
  */
@@ -120,7 +124,9 @@ void pwm_service_task( // Implementation of the Centre-aligned, High-Low pair, P
         PwmPorts &ports,
         server interface UpdatePWM i_update_pwm,
         server interface UpdateBrake i_update_brake,
-        int ifm_tile_usec
+        int ifm_tile_usec,
+        int deadtime_compensation,
+        int deadtime_compensation_band
 );
 
 
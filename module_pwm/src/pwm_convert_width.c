@@ -12,6 +12,8 @@
  * copyright notice above.
  **/
 
+#include <stdint.h>
+
 #include "pwm_convert_width.h"
 
 /**
@@ -105,15 +107,100 @@ static void convert_pulse_width(
 } // convert_pulse_width
 
 
+/**
+ * @brief Initialize the dead-time compensation and clear the phase currents.
+ *
+ * @param pwm_comms_ps          Pointer to structure containing PWM communication data
+ * @param width                 Compensation width (in clock ticks), 0 disables the compensation
+ * @param band                  Half width of the zero crossing region (in units of the phase currents)
+ * @param pwm_max_value         PWM maximum value
+ *
+ * @return void
+ */
+void init_deadtime_compensation( // Initialize the dead-time compensation
+	PWM_COMMS_TYP * pwm_comms_ps, // Pointer to structure containing PWM communication data
+	int width,
+	int band,
+	unsigned int pwm_max_value
+)
+{
+	if (width < 0) width = 0;
+	if (band < 0) band = 0;
+
+	pwm_comms_ps->deadtime_comp.width = width;
+	pwm_comms_ps->deadtime_comp.band = band;
+	pwm_comms_ps->deadtime_comp.slope = (band > 0) ? ((width << 16) / band) : 0; // Q16, avoids a divide per phase
+
+	// Full modulation is a phase voltage of 3 x pwm_max_value/2 in units of the phase voltages of convert_all_pulse_widths
+	pwm_comms_ps->deadtime_comp.fade_start = (3 * (int)pwm_max_value * DEADTIME_COMP_FADE_START) / 200;
+	pwm_comms_ps->deadtime_comp.fade_end = (3 * (int)pwm_max_value * DEADTIME_COMP_FADE_END) / 200;
+	pwm_comms_ps->deadtime_comp.fade_slope = (1 << 24) / (pwm_comms_ps->deadtime_comp.fade_end - pwm_comms_ps->deadtime_comp.fade_start); // Q24, avoids a divide per period
+
+	for (int phase_cnt = 0; phase_cnt < _NUM_PWM_PHASES; phase_cnt++)
+	{
+		pwm_comms_ps->params.currents[phase_cnt] = 0;
+	} // for phase_cnt
+} // init_deadtime_compensation
+
+
+/**
+ * @brief Compensate the dead-time voltage error of one phase.
+ * During the dead-time both legs are off and the freewheeling diodes clamp the phase: to V- for a positive
+ * current (flowing into the motor), to V+ for a negative current. The pulse is widened for a positive current and
+ * narrowed for a negative one. Inside the zero crossing band the sign is uncertain (current ripple, noise),
+ * there the correction is proportional to the current.
+ *
+ * @param deadtime_comp_ps      Pointer to dead-time compensation parameters
+ * @param hi_wid                PWM pulse-width value for Hi-leg
+ * @param current               Phase current (or a value of the same sign)
+ * @param pwm_max_value         PWM maximum value
+ * @param pwm_deadtime          deadtime value (in clock ticks)
+ *
+ * @return compensated PWM pulse-width value for Hi-leg
+ */
+static unsigned compensate_deadtime(
+	PWM_DEADTIME_COMP_TYP * deadtime_comp_ps,
+	unsigned hi_wid,
+	int current,
+	unsigned int pwm_max_value,
+	unsigned int pwm_deadtime
+)
+{
+	int wid = (int)hi_wid;
+	int max_wid = (int)(pwm_max_value - pwm_deadtime) - 1; // Widest Hi-leg pulse, Low-leg pulse must stay inside PWM period
+
+
+	if (current >= deadtime_comp_ps->band)
+	{ // Positive current: phase at V- during dead-time
+		wid += deadtime_comp_ps->width;
+	} // if (current >= band)
+	else if (current <= -deadtime_comp_ps->band)
+	{ // Negative current: phase at V+ during dead-time
+		wid -= deadtime_comp_ps->width;
+	} // if (current <= -band)
+	else
+	{ // Zero crossing: correction proportional to current
+		wid += (deadtime_comp_ps->slope * current) >> 16;
+	} // else !(|current| >= band)
+
+	if (wid < 0) wid = 0;
+	if (wid > max_wid) wid = max_wid;
+
+	return (unsigned)wid;
+} // compensate_deadtime
+
+
 /**
  * @brief Convert PWM pulse widths for current phase to pattern/time_offset port data.
  * WARNING: Both legs of the balanced line must NOT be switched at the same time. Safety Critical.
  * Calculate PWM Pulse data for low leg (V+) of balanced line
  *
  * @param pwm_comms_ps          Pointer to structure containing PWM communication data
+ * @param deadtime_comp_ps      Pointer to dead-time compensation parameters, faded out with the modulation depth
  * @param rise_port_data_ps     Pointer to PWM output data structure for rising edge of current phase
  * @param fall_port_data_ps     Pointer to PWM output data structure for falling edge of current phase
  * @param inp_wid               PWM pulse-width value for Hi-leg
+ * @param current               Phase current (or a value of the same sign) for the dead-time compensation
  * @param pwm_max_value         PWM maximum value
  * @param pwm_deadtime          deadtime value (in clock ticks)
  *
@@ -121,15 +208,26 @@ static void convert_pulse_width(
  */
 static void convert_phase_pulse_widths(
 	PWM_COMMS_TYP * pwm_comms_ps,
+	PWM_DEADTIME_COMP_TYP * deadtime_comp_ps,
 	PWM_PHASE_TYP * rise_phase_data_ps,
 	PWM_PHASE_TYP * fall_phase_data_ps,
 	unsigned hi_wid,
+	int current,
 	unsigned int pwm_max_value,
 	unsigned int pwm_deadtime
 )
 
 {
-	unsigned lo_wid = (hi_wid + pwm_deadtime);
+	unsigned lo_wid;
+
+
+	// Compensate dead-time voltage error (if enabled)
+	if (deadtime_comp_ps->width)
+	{
+		hi_wid = compensate_deadtime( deadtime_comp_ps ,hi_wid ,current ,pwm_max_value ,pwm_deadtime );
+	} // if (deadtime_comp.width)
+
+	lo_wid = (hi_wid + pwm_deadtime);
 
 	assert(lo_wid < pwm_max_value); // Ensure Low-leg pulse NOT too wide
 
@@ -142,6 +240,57 @@ static void convert_phase_pulse_widths(
 } // convert_phase_pulse_widths
 
 
+/**
+ * @brief Fade the dead-time compensation out with the modulation depth.
+ * The sign of the phase currents may be taken from the phase voltages, the currents then lag behind by the power-factor
+ * angle, which grows with the speed and so with the modulation depth. A compensation with the wrong sign doubles the
+ * dead-time error instead of removing it. The depth is the largest phase voltage, 3 x the pulse width above the mean
+ * of the three phases, which removes the zero sequence.
+ *
+ * @param deadtime_comp_ps      Pointer to dead-time compensation parameters
+ * @param faded_comp_ps         Pointer to faded dead-time compensation parameters
+ * @param widths                PWM pulse-width values of all phases
+ *
+ * @return void
+ */
+static void fade_deadtime_compensation(
+	PWM_DEADTIME_COMP_TYP * deadtime_comp_ps,
+	PWM_DEADTIME_COMP_TYP * faded_comp_ps,
+	unsigned widths[]
+)
+{
+	int sum = (int)widths[0] + (int)widths[1] + (int)widths[2];
+	int depth = 0;
+	int scale; // Q16
+
+
+	*faded_comp_ps = *deadtime_comp_ps;
+
+	for (int phase_cnt = 0; phase_cnt < _NUM_PWM_PHASES; phase_cnt++)
+	{
+		int voltage = 3 * (int)widths[phase_cnt] - sum;
+
+		if (voltage < 0) voltage = -voltage;
+		if (voltage > depth) depth = voltage;
+	} // for phase_cnt
+
+	if (depth <= deadtime_comp_ps->fade_start)
+	{ // Low modulation: full compensation
+		return;
+	} // if (depth <= fade_start)
+
+	if (depth >= deadtime_comp_ps->fade_end)
+	{ // High modulation: no compensation
+		faded_comp_ps->width = 0;
+		return;
+	} // if (depth >= fade_end)
+
+	scale = ((deadtime_comp_ps->fade_end - depth) * deadtime_comp_ps->fade_slope) >> 8;
+	faded_comp_ps->width = (deadtime_comp_ps->width * scale) >> 16;
+	faded_comp_ps->slope = (int)(((long long)deadtime_comp_ps->slope * scale) >> 16);
+} // fade_deadtime_compensation
+
+
 /**
  * @brief Convert all PWM pulse widths to pattern/time_offset port data
  *
@@ -159,11 +308,19 @@ void convert_all_pulse_widths( // Convert all PWM pulse widths to pattern/time_o
 	unsigned int pwm_deadtime
 )
 {
+	PWM_DEADTIME_COMP_TYP deadtime_comp = pwm_comms_ps->deadtime_comp; // Dead-time compensation of this period
+
+
+	if (deadtime_comp.width)
+	{
+		fade_deadtime_compensation( &(pwm_comms_ps->deadtime_comp) ,&deadtime_comp ,pwm_comms_ps->params.widths );
+	} // if (deadtime_comp.width)
+
 	for (int phase_cnt = 0; phase_cnt < _NUM_PWM_PHASES; phase_cnt++)
 	{ // Convert PWM pulse widths for this phase to pattern/time_offset port data
 
-		convert_phase_pulse_widths( pwm_comms_ps ,&(pwm_buf_ps->rise_edg.phase_data[phase_cnt])
-			,&(pwm_buf_ps->fall_edg.phase_data[phase_cnt]) ,pwm_comms_ps->params.widths[phase_cnt], pwm_max_value, pwm_deadtime );
+		convert_phase_pulse_widths( pwm_comms_ps ,&deadtime_comp ,&(pwm_buf_ps->rise_edg.phase_data[phase_cnt])
+			,&(pwm_buf_ps->fall_edg.phase_data[phase_cnt]) ,pwm_comms_ps->params.widths[phase_cnt] ,pwm_comms_ps->params.currents[phase_cnt], pwm_max_value, pwm_deadtime );
 	} // for phase_cnt
 } // convert_all_pulse_widths
 
@@ -182,7 +339,7 @@ void convert_widths_in_shared_mem( // Converts PWM Pulse-width to port data in s
     unsigned int pwm_max_value,
     unsigned int pwm_deadtime)
 {	// Cast shared memory address pointer to PWM double-buffered data structure
-	PWM_ARRAY_TYP * pwm_ctrl_ps = (PWM_ARRAY_TYP *)pwm_comms_ps->mem_addr;
+	PWM_ARRAY_TYP * pwm_ctrl_ps = (PWM_ARRAY_TYP *)(uintptr_t)pwm_comms_ps->mem_addr;
 
 	// Convert widths and write to current PWM buffer
 	convert_all_pulse_widths( pwm_comms_ps ,&(pwm_ctrl_ps->buf_data[pwm_comms_ps->buf]), pwm_max_value, pwm_deadtime );
@@ -22,12 +22,14 @@
  * @param hall_enc_select_config config to select the mode (differential or not) of Hall/QEI/BiSS ports
  * @param position_feedback_config Configuration for the service.
  * @param i_shared_memory Client interface to write the position data to the shared memory.
+ * @param shared_memory_blocks Lock-free shared memory written directly instead of i_shared_memory, null to use i_shared_memory.
  * @param i_position_feedback Server interface used by clients for configuration and direct position read.
  * @param gpio_on Set to 1 to enable GPIO read/write.
  */
 void serial_encoder_service(QEIHallPort * qei_hall_port_1, QEIHallPort * qei_hall_port_2, HallEncSelectPort * hall_enc_select_port, SPIPorts * spi_ports, port * (&?gpio_ports)[4],
                 int hall_enc_select_config, PositionFeedbackConfig &position_feedback_config,
                 client interface shared_memory_interface ?i_shared_memory,
+                SharedMemoryBlocks * unsafe shared_memory_blocks,
                 interface PositionFeedbackInterface server i_position_feedback[3],
                 int gpio_on);
 #endif
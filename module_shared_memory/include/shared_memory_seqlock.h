@@ -0,0 +1,200 @@
+/**
+ * @file shared_memory_seqlock.h
+ * @brief Lock-free shared memory for tasks of the same tile
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+#include <motor_control_structures.h>
+#include <sample_ring.h>
+
+/**
+ * @brief Block of the electrical angle, written by the commutation sensor only.
+ */
+typedef struct {
+    unsigned int sequence;
+    unsigned int angle;
+    unsigned int hall_state;
+    int velocity;
+    SensorError sensor_error;
+    SensorError last_sensor_error;
+} SharedMemoryAngleBlock;
+
+/**
+ * @brief Block of a position feedback, written by one sensor only.
+ */
+typedef struct {
+    unsigned int sequence;
+    int position;
+    int velocity;
+    SensorError sensor_error;
+    SensorError last_sensor_error;
+    unsigned int timestamp;
+    SampleRing samples;         /**< Last timestamped positions, used for latency compensation */
+} SharedMemoryFeedbackBlock;
+
+/**
+ * @brief Block of the GPIO inputs, written by the GPIO owner only.
+ */
+typedef struct {
+    unsigned int sequence;
+    unsigned int gpio[4];
+} SharedMemoryGpioBlock;
+
+/**
+ * @brief Lock-free shared memory. Every writer owns its own block protected by a sequence counter,
+ *        so writers never wait and readers retry only if a block changed while it was copied.
+ *        Consistency is guaranteed per block, not across blocks.
+ */
+typedef struct {
+    SharedMemoryAngleBlock angle;
+    SharedMemoryFeedbackBlock primary;
+    SharedMemoryFeedbackBlock secondary;
+    SharedMemoryGpioBlock gpio_input;
+    unsigned int gpio_output;
+} SharedMemoryBlocks;
+
+/**
+ * @brief Clears all blocks of the shared memory.
+ *
+ * @param blocks Shared memory.
+ */
+void shared_memory_blocks_init(REFERENCE_PARAM(SharedMemoryBlocks, blocks));
+
+/**
+ * @brief Write electrical angle to shared memory.
+ *
+ * @param blocks Shared memory.
+ * @param angle Electrical angle.
+ * @param hall_state Hall state (in case HALL sensor is used).
+ * @param velocity Velocity.
+ * @param sensor_error the sensor error status.
+ * @param last_sensor_error the last non zero sensor error status.
+ */
+void shared_memory_write_angle(REFERENCE_PARAM(SharedMemoryBlocks, blocks), unsigned int angle, unsigned int hall_state, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error);
+
+/**
+ * @brief Write primary position feedback (used for motion control) to shared memory.
+ *
+ * @param blocks Shared memory.
+ * @param position Position.
+ * @param velocity Velocity.
+ * @param sensor_error the sensor error status.
+ * @param last_sensor_error the last non zero sensor error status.
+ * @param timestamp timestamp in microseconds of when the position data was read.
+ */
+void shared_memory_write_primary_feedback(REFERENCE_PARAM(SharedMemoryBlocks, blocks), int position, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp);
+
+/**
+ * @brief Write secondary position feedback (display only) to shared memory.
+ *
+ * @param blocks Shared memory.
+ * @param position Position.
+ * @param velocity Velocity.
+ * @param sensor_error the sensor error status.
+ * @param last_sensor_error the last non zero sensor error status.
+ * @param timestamp timestamp in microseconds of when the position data was read.
+ */
+void shared_memory_write_secondary_feedback(REFERENCE_PARAM(SharedMemoryBlocks, blocks), int position, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp);
+
+/**
+ * @brief Write GPIO inputs to shared memory.
+ *
+ * @param blocks Shared memory.
+ * @param gpio_input state of the GPIO inputs (rightmost bit is GPIO 1).
+ */
+void shared_memory_write_gpio_input(REFERENCE_PARAM(SharedMemoryBlocks, blocks), unsigned int gpio_input);
+
+/**
+ * @brief Write GPIO output to shared memory.
+ *
+ * @param blocks Shared memory.
+ * @param gpio_output value to ouput to the GPIO pins (rightmost bit is GPIO 1).
+ */
+void shared_memory_write_gpio_output(REFERENCE_PARAM(SharedMemoryBlocks, blocks), unsigned int gpio_output);
+
+/**
+ * @brief Getter for the GPIO output in shared memory.
+ *
+ * @param blocks Shared memory.
+ *
+ * @return value to ouput to the GPIO pins (rightmost bit is GPIO 1).
+ */
+unsigned int shared_memory_read_gpio_output(REFERENCE_PARAM(SharedMemoryBlocks, blocks));
+
+/**
+ * @brief Copies a consistent snapshot of the electrical angle block into UpstreamControlData
+ *        (angle, hall_state, angle_velocity and the angle sensor errors).
+ *
+ * @param blocks Shared memory.
+ * @param data UpstreamControlData to update.
+ */
+void shared_memory_read_angle(REFERENCE_PARAM(SharedMemoryBlocks, blocks), REFERENCE_PARAM(UpstreamControlData, data));
+
+/**
+ * @brief Copies a consistent snapshot of the primary position feedback block into UpstreamControlData
+ *        (position, velocity, sensor errors and sensor_timestamp).
+ *
+ * @param blocks Shared memory.
+ * @param data UpstreamControlData to update.
+ */
+void shared_memory_read_primary_feedback(REFERENCE_PARAM(SharedMemoryBlocks, blocks), REFERENCE_PARAM(UpstreamControlData, data));
+
+/**
+ * @brief Copies a consistent snapshot of the secondary position feedback block into UpstreamControlData
+ *        (the secondary_ fields).
+ *
+ * @param blocks Shared memory.
+ * @param data UpstreamControlData to update.
+ */
+void shared_memory_read_secondary_feedback(REFERENCE_PARAM(SharedMemoryBlocks, blocks), REFERENCE_PARAM(UpstreamControlData, data));
+
+/**
+ * @brief Copies a consistent snapshot of the GPIO inputs into UpstreamControlData.
+ *
+ * @param blocks Shared memory.
+ * @param data UpstreamControlData to update.
+ */
+void shared_memory_read_gpio_input(REFERENCE_PARAM(SharedMemoryBlocks, blocks), REFERENCE_PARAM(UpstreamControlData, data));
+
+/**
+ * @brief Copies a consistent snapshot of every block of the shared memory into UpstreamControlData,
+ *        one block after the other. Fields which are not part of the shared memory are left unchanged.
+ *
+ * @param blocks Shared memory.
+ * @param data UpstreamControlData to update.
+ */
+void shared_memory_read(REFERENCE_PARAM(SharedMemoryBlocks, blocks), REFERENCE_PARAM(UpstreamControlData, data));
+
+/**
+ * @brief Getter for the primary position extrapolated to the given time, which compensates the
+ *        age of the last sensor reading (see sample_ring_extrapolate()).
+ *
+ * @param blocks Shared memory.
+ * @param timestamp time to extrapolate the position to, same time base as the sensor timestamps [microseconds].
+ * @param max_horizon maximum extrapolation time [microseconds].
+ *
+ * @return extrapolated primary position.
+ */
+int shared_memory_read_position_extrapolated(REFERENCE_PARAM(SharedMemoryBlocks, blocks), unsigned int timestamp, int max_horizon);
+
+#ifdef __XC__
+#include <motor_control_interfaces.h>
+
+/**
+ * @brief Service serving the shared_memory_interface on top of the lock-free shared memory. Clients which
+ *        only support the interface (e.g. the torque control service) keep working, while tasks of the same
+ *        tile can access the blocks directly without any rendezvous.
+ *
+ * @param blocks Pointer to the shared memory.
+ * @param i_shared_memory Array of communication interfaces to handle n different clients
+ * @param n Number of supported client interfaces
+ */
+[[distributable]]
+void shared_memory_seqlock_service(SharedMemoryBlocks * unsafe blocks, server interface shared_memory_interface i_shared_memory[n], unsigned n);
+#endif
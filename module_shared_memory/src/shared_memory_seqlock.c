@@ -0,0 +1,203 @@
+/**
+ * @file shared_memory_seqlock.c
+ * @brief Lock-free shared memory for tasks of the same tile
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <shared_memory_seqlock.h>
+#include <string.h>
+
+/*
+ * The blocks are accessed by several cores of the same tile. The sequence counter is
+ * odd while a block is written. Compiler barriers keep the copies between the counter
+ * accesses, the cores of a tile see the memory accesses in program order. Other targets
+ * (host tests) need a memory fence.
+ */
+#ifdef __xcore__
+#define SEQLOCK_BARRIER()       asm volatile("" ::: "memory")
+#else
+#define SEQLOCK_BARRIER()       __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+#define SEQLOCK_LOAD(x)         (*(volatile unsigned int *)&(x))
+#define SEQLOCK_STORE(x, v)     (*(volatile unsigned int *)&(x) = (v))
+
+static void seqlock_write_begin(unsigned int * sequence)
+{
+    SEQLOCK_STORE(*sequence, SEQLOCK_LOAD(*sequence) + 1);
+    SEQLOCK_BARRIER();
+}
+
+static void seqlock_write_end(unsigned int * sequence)
+{
+    SEQLOCK_BARRIER();
+    SEQLOCK_STORE(*sequence, SEQLOCK_LOAD(*sequence) + 1);
+}
+
+static unsigned int seqlock_read_begin(unsigned int * sequence)
+{
+    unsigned int s;
+
+    do {
+        s = SEQLOCK_LOAD(*sequence);
+    } while (s & 1);
+    SEQLOCK_BARRIER();
+
+    return s;
+}
+
+static int seqlock_read_retry(unsigned int * sequence, unsigned int s)
+{
+    SEQLOCK_BARRIER();
+    return (SEQLOCK_LOAD(*sequence) != s);
+}
+
+void shared_memory_blocks_init(SharedMemoryBlocks * blocks)
+{
+    memset(blocks, 0, sizeof(SharedMemoryBlocks));
+    sample_ring_init(&blocks->primary.samples);
+    sample_ring_init(&blocks->secondary.samples);
+}
+
+void shared_memory_write_angle(SharedMemoryBlocks * blocks, unsigned int angle, unsigned int hall_state, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error)
+{
+    SharedMemoryAngleBlock * b = &blocks->angle;
+
+    seqlock_write_begin(&b->sequence);
+    b->angle = angle;
+    b->hall_state = hall_state;
+    b->velocity = velocity;
+    b->sensor_error = sensor_error;
+    b->last_sensor_error = last_sensor_error;
+    seqlock_write_end(&b->sequence);
+}
+
+static void shared_memory_write_feedback(SharedMemoryFeedbackBlock * b, int position, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp)
+{
+    seqlock_write_begin(&b->sequence);
+    b->position = position;
+    b->velocity = velocity;
+    b->sensor_error = sensor_error;
+    b->last_sensor_error = last_sensor_error;
+    b->timestamp = timestamp;
+    sample_ring_push(&b->samples, position, timestamp);
+    seqlock_write_end(&b->sequence);
+}
+
+void shared_memory_write_primary_feedback(SharedMemoryBlocks * blocks, int position, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp)
+{
+    shared_memory_write_feedback(&blocks->primary, position, velocity, sensor_error, last_sensor_error, timestamp);
+}
+
+void shared_memory_write_secondary_feedback(SharedMemoryBlocks * blocks, int position, int velocity,
+        SensorError sensor_error, SensorError last_sensor_error, unsigned int timestamp)
+{
+    shared_memory_write_feedback(&blocks->secondary, position, velocity, sensor_error, last_sensor_error, timestamp);
+}
+
+void shared_memory_write_gpio_input(SharedMemoryBlocks * blocks, unsigned int gpio_input)
+{
+    SharedMemoryGpioBlock * b = &blocks->gpio_input;
+
+    seqlock_write_begin(&b->sequence);
+    for (int i=0 ; i<4 ; i++) {
+        b->gpio[i] = (gpio_input>>i)&1;
+    }
+    seqlock_write_end(&b->sequence);
+}
+
+void shared_memory_write_gpio_output(SharedMemoryBlocks * blocks, unsigned int gpio_output)
+{
+    // a single word is written atomically
+    SEQLOCK_STORE(blocks->gpio_output, gpio_output);
+}
+
+unsigned int shared_memory_read_gpio_output(SharedMemoryBlocks * blocks)
+{
+    return SEQLOCK_LOAD(blocks->gpio_output);
+}
+
+/*
+ * The readers copy the fields they need inside the retry loop, not the whole block,
+ * so the sample ring of the feedback blocks is only copied for the extrapolation.
+ */
+void shared_memory_read_angle(SharedMemoryBlocks * blocks, UpstreamControlData * data)
+{
+    SharedMemoryAngleBlock * b = &blocks->angle;
+    unsigned int s;
+
+    do {
+        s = seqlock_read_begin(&b->sequence);
+        data->angle = b->angle;
+        data->hall_state = b->hall_state;
+        data->angle_velocity = b->velocity;
+        data->angle_sensor_error = b->sensor_error;
+        data->angle_last_sensor_error = b->last_sensor_error;
+    } while (seqlock_read_retry(&b->sequence, s));
+}
+
+void shared_memory_read_primary_feedback(SharedMemoryBlocks * blocks, UpstreamControlData * data)
+{
+    SharedMemoryFeedbackBlock * b = &blocks->primary;
+    unsigned int s;
+
+    do {
+        s = seqlock_read_begin(&b->sequence);
+        data->position = b->position;
+        data->velocity = b->velocity;
+        data->sensor_error = b->sensor_error;
+        data->last_sensor_error = b->last_sensor_error;
+        data->sensor_timestamp = b->timestamp;
+    } while (seqlock_read_retry(&b->sequence, s));
+}
+
+void shared_memory_read_secondary_feedback(SharedMemoryBlocks * blocks, UpstreamControlData * data)
+{
+    SharedMemoryFeedbackBlock * b = &blocks->secondary;
+    unsigned int s;
+
+    do {
+        s = seqlock_read_begin(&b->sequence);
+        data->secondary_position = b->position;
+        data->secondary_velocity = b->velocity;
+        data->secondary_sensor_error = b->sensor_error;
+        data->secondary_last_sensor_error = b->last_sensor_error;
+        data->secondary_sensor_timestamp = b->timestamp;
+    } while (seqlock_read_retry(&b->sequence, s));
+}
+
+void shared_memory_read_gpio_input(SharedMemoryBlocks * blocks, UpstreamControlData * data)
+{
+    SharedMemoryGpioBlock * b = &blocks->gpio_input;
+    unsigned int s;
+
+    do {
+        s = seqlock_read_begin(&b->sequence);
+        for (int i=0 ; i<4 ; i++) {
+            data->gpio[i] = b->gpio[i];
+        }
+    } while (seqlock_read_retry(&b->sequence, s));
+}
+
+void shared_memory_read(SharedMemoryBlocks * blocks, UpstreamControlData * data)
+{
+    shared_memory_read_angle(blocks, data);
+    shared_memory_read_primary_feedback(blocks, data);
+    shared_memory_read_secondary_feedback(blocks, data);
+    shared_memory_read_gpio_input(blocks, data);
+}
+
+int shared_memory_read_position_extrapolated(SharedMemoryBlocks * blocks, unsigned int timestamp, int max_horizon)
+{
+    SampleRing samples;
+    unsigned int s;
+
+    do {
+        s = seqlock_read_begin(&blocks->primary.sequence);
+        samples = blocks->primary.samples;
+    } while (seqlock_read_retry(&blocks->primary.sequence, s));
+
+    return sample_ring_extrapolate(&samples, timestamp, max_horizon);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file cyclic_interpolation.h
+ * @brief Interpolation of cyclic synchronous targets (CSP/CSV/CST) between master cycles
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Number of targets kept in the FIFO (power of two).
+ */
+#define CYCLIC_INTERPOLATION_FIFO_SIZE      8
+
+/**
+ * @brief Targets are used as they arrive.
+ */
+#define CYCLIC_INTERPOLATION_NONE           0
+
+/**
+ * @brief Linear interpolation between two targets, delays the targets by 1.5 master cycles.
+ */
+#define CYCLIC_INTERPOLATION_LINEAR         1
+
+/**
+ * @brief Cubic (Catmull-Rom) interpolation through four targets, delays the targets by 2.5 master cycles.
+ */
+#define CYCLIC_INTERPOLATION_CUBIC          2
+
+/**
+ * @brief The estimated master time follows the arrival times with a gain of 1/2^CYCLIC_INTERPOLATION_TIME_FILTER.
+ */
+#define CYCLIC_INTERPOLATION_TIME_FILTER    4
+
+/**
+ * @brief Structure type for one target of the master.
+ */
+typedef struct {
+    int value;                  /**< Position, velocity or torque target */
+    unsigned int timestamp;     /**< Estimated master time of the target [timer ticks] */
+} CyclicTarget;
+
+/**
+ * @brief Structure type for the FIFO of targets of the master and its time estimation.
+ */
+typedef struct {
+    CyclicTarget target[CYCLIC_INTERPOLATION_FIFO_SIZE];
+    unsigned int head;          /**< Index of the newest target */
+    unsigned int count;         /**< Number of valid targets */
+    int mode;                   /**< CYCLIC_INTERPOLATION_NONE, CYCLIC_INTERPOLATION_LINEAR or CYCLIC_INTERPOLATION_CUBIC */
+    int period;                 /**< Cycle time of the master [timer ticks] */
+    unsigned int master_time;   /**< Estimated master time of the newest target [timer ticks] */
+} CyclicInterpolator;
+
+/**
+ * @brief Clears the FIFO and sets the interpolation.
+ *
+ * @param interpolator  interpolator
+ * @param mode          CYCLIC_INTERPOLATION_NONE, CYCLIC_INTERPOLATION_LINEAR or CYCLIC_INTERPOLATION_CUBIC
+ * @param period        cycle time of the master [timer ticks]
+ *
+ * @return void
+ */
+void cyclic_interpolation_init(REFERENCE_PARAM(CyclicInterpolator, interpolator), int mode, int period);
+
+/**
+ * @brief Adds a new target of the master. The target is timestamped with the master time, which advances by
+ *        one period per target and slowly follows the arrival times, so the jitter of the master is filtered.
+ *        If the arrival time is more than two periods away from the master time (e.g. the master stopped
+ *        sending targets) the FIFO restarts.
+ *
+ * @param interpolator  interpolator
+ * @param value         position, velocity or torque target
+ * @param timestamp     arrival time of the target [timer ticks]
+ *
+ * @return void
+ */
+void cyclic_interpolation_push(REFERENCE_PARAM(CyclicInterpolator, interpolator), int value, unsigned int timestamp);
+
+/**
+ * @brief Interpolates the targets at the given time minus the delay of the interpolation.
+ *        The newest target is held if the FIFO runs empty, the oldest one if the time is before it.
+ *
+ * @param interpolator  interpolator
+ * @param timestamp     actual time [timer ticks]
+ *
+ * @return interpolated target, 0 if no target was received yet
+ */
+int cyclic_interpolation_get(REFERENCE_PARAM(CyclicInterpolator, interpolator), unsigned int timestamp);
@@ -0,0 +1,84 @@
+/**
+ * @file sample_ring.h
+ * @brief Ring of timestamped position samples with latency compensation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <xccompat.h>
+
+/**
+ * @brief Number of samples kept in the ring (power of two).
+ */
+#define SAMPLE_RING_SIZE    4
+
+/**
+ * @brief Structure type for one timestamped position sample.
+ */
+typedef struct {
+    int position;               /**< Position [ticks] */
+    unsigned int timestamp;     /**< Time at which the position was read [microseconds] */
+} TimestampedSample;
+
+/**
+ * @brief Structure type for a ring of the last SAMPLE_RING_SIZE timestamped samples.
+ */
+typedef struct {
+    TimestampedSample sample[SAMPLE_RING_SIZE];
+    unsigned int head;          /**< Index of the newest sample */
+    unsigned int count;         /**< Number of valid samples */
+} SampleRing;
+
+/**
+ * @brief Clears the ring.
+ *
+ * @param ring  ring of samples
+ *
+ * @return void
+ */
+void sample_ring_init(REFERENCE_PARAM(SampleRing, ring));
+
+/**
+ * @brief Adds a new sample to the ring. A sample with the timestamp of the newest one is ignored,
+ *        a sample older than the newest one (e.g. timestamp overflow) restarts the ring.
+ *
+ * @param ring      ring of samples
+ * @param position  position [ticks]
+ * @param timestamp time at which the position was read [microseconds]
+ *
+ * @return void
+ */
+void sample_ring_push(REFERENCE_PARAM(SampleRing, ring), int position, unsigned int timestamp);
+
+/**
+ * @brief Extrapolates the position to the given time with the mean velocity over the ring.
+ *        If there are not enough samples, or the time is before the newest sample or more than
+ *        max_horizon after it, the newest position is returned unchanged.
+ *
+ * @param ring          ring of samples
+ * @param timestamp     time to extrapolate the position to [microseconds]
+ * @param max_horizon   maximum extrapolation time [microseconds]
+ *
+ * @return extrapolated position [ticks]
+ */
+int sample_ring_extrapolate(REFERENCE_PARAM(SampleRing, ring), unsigned int timestamp, int max_horizon);
+
+/**
+ * @brief Adds the newest sensor sample to the ring and extrapolates it to the actual time of the reader.
+ *        The offset between the time base of the sensor and the one of the reader is estimated as the
+ *        smallest observed delay, so the extrapolation compensates the age of the sample beyond the minimal
+ *        transport delay (e.g. slow sensor reads). The offset is resynchronized if the delay decreases or
+ *        jumps by more than max_horizon (overflow of one of the time bases).
+ *
+ * @param ring              ring of samples
+ * @param clock_offset      estimated offset between the time bases, kept between the calls [microseconds]
+ * @param position          newest position [ticks]
+ * @param sensor_timestamp  time at which the position was read, time base of the sensor [microseconds]
+ * @param time_now          actual time, time base of the reader [microseconds]
+ * @param max_horizon       maximum extrapolation time [microseconds]
+ *
+ * @return position extrapolated to the actual time [ticks]
+ */
+int sample_ring_compensate_latency(REFERENCE_PARAM(SampleRing, ring), REFERENCE_PARAM(unsigned int, clock_offset),
+        int position, unsigned int sensor_timestamp, unsigned int time_now, int max_horizon);
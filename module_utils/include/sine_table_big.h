@@ -7,7 +7,64 @@
 #pragma once
 
 #include <stdint.h>
+#include <xccompat.h>
+
+/**
+ * @brief Number of bits of the quarter wave table of sine_cosine, the table has 2^SINE_TABLE_BITS+1 entries [4:12].
+ *        Define it for the whole application (e.g. -DSINE_TABLE_BITS=10 in XCC_FLAGS) to change the size.
+ */
+#ifndef SINE_TABLE_BITS
+#define SINE_TABLE_BITS             8
+#endif
+
+/**
+ * @brief Number of entries of a quarter wave, without the entry of pi/2.
+ */
+#define SINE_TABLE_SIZE             (1 << SINE_TABLE_BITS)
+
+/**
+ * @brief Scaling of the table entries. With SINE_TABLE_COMPACT defined the entries are 16 bit (Q14) instead of 32 bit (Q30).
+ */
+#ifdef SINE_TABLE_COMPACT
+#define SINE_TABLE_SHIFT            14
+#define SINE_TABLE_ENTRY_TYPE       short
+#else
+#define SINE_TABLE_SHIFT            30
+#define SINE_TABLE_ENTRY_TYPE       int
+#endif
+
+/**
+ * @brief Resolution of the angle of sine_cosine [bits/rotation].
+ */
+#define SINE_COSINE_ANGLE_BITS      16
+
+/**
+ * @brief Bits of the angle below the table index, which interpolate between two entries.
+ */
+#define SINE_COSINE_FRACTION_BITS   (SINE_COSINE_ANGLE_BITS - 2 - SINE_TABLE_BITS)
+
+/**
+ * @brief Scaling of the results of sine_cosine (Q14), as sine_table_expanded.
+ */
+#define SINE_COSINE_SHIFT           14
+
+/**
+ * @brief Quarter wave sine table of sine_cosine, generated at build time (see sine_table_generator.h).
+ */
+extern const SINE_TABLE_ENTRY_TYPE sine_quarter_table[SINE_TABLE_SIZE+1];
 
 int sine_third_expanded(int angle);
 
 int sine_table_expanded(int angle);
+
+/**
+ * @brief Sine and cosine of an angle from one fetch of the quarter wave table, linearly interpolated
+ *        with the bits of the angle below the table index.
+ *
+ * @param angle     angle [0:2^SINE_COSINE_ANGLE_BITS-1], higher bits are ignored
+ * @param sine      sine, Q14
+ * @param cosine    cosine, Q14
+ *
+ * @return void
+ */
+void sine_cosine(unsigned int angle, REFERENCE_PARAM(int, sine), REFERENCE_PARAM(int, cosine));
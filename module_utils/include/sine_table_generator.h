@@ -0,0 +1,45 @@
+/**
+ * @file sine_table_generator.h
+ * @brief Generation of quarter wave sine tables of any size by the preprocessor at build time
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+/* sin(x) for 0 <= x <= pi/2 by its Taylor series up to x^17 (error below 1e-13) in Horner form */
+#define SINE_TABLE_SERIES(x, x2)    ((x) * (1.0 - (x2) / 6.0 * (1.0 - (x2) / 20.0 * (1.0 - (x2) / 42.0 * (1.0 - (x2) / 72.0 * \
+                                    (1.0 - (x2) / 110.0 * (1.0 - (x2) / 156.0 * (1.0 - (x2) / 210.0 * (1.0 - (x2) / 272.0)))))))))
+
+/* angle of the entry i of a quarter wave of n entries */
+#define SINE_TABLE_ANGLE(i, n)      (((double)(i)) * (1.57079632679489661923 / ((double)(n))))
+
+#define SINE_TABLE_SINE(i, n)       SINE_TABLE_SERIES(SINE_TABLE_ANGLE(i, n), (SINE_TABLE_ANGLE(i, n) * SINE_TABLE_ANGLE(i, n)))
+
+/**
+ * @brief Entry i of a quarter wave of n entries, scaled by 2^shift and rounded.
+ */
+#define SINE_TABLE_ENTRY(i, n, shift)   ((int)((SINE_TABLE_SINE(i, n) * ((double)(1 << (shift)))) + 0.5))
+
+/* 2^bits consecutive entries starting at i, each followed by a comma */
+#define SINE_TABLE_REPEAT_0(i, n, shift)    SINE_TABLE_ENTRY(i, n, shift),
+#define SINE_TABLE_REPEAT_1(i, n, shift)    SINE_TABLE_REPEAT_0(i, n, shift)  SINE_TABLE_REPEAT_0((i)+1, n, shift)
+#define SINE_TABLE_REPEAT_2(i, n, shift)    SINE_TABLE_REPEAT_1(i, n, shift)  SINE_TABLE_REPEAT_1((i)+2, n, shift)
+#define SINE_TABLE_REPEAT_3(i, n, shift)    SINE_TABLE_REPEAT_2(i, n, shift)  SINE_TABLE_REPEAT_2((i)+4, n, shift)
+#define SINE_TABLE_REPEAT_4(i, n, shift)    SINE_TABLE_REPEAT_3(i, n, shift)  SINE_TABLE_REPEAT_3((i)+8, n, shift)
+#define SINE_TABLE_REPEAT_5(i, n, shift)    SINE_TABLE_REPEAT_4(i, n, shift)  SINE_TABLE_REPEAT_4((i)+16, n, shift)
+#define SINE_TABLE_REPEAT_6(i, n, shift)    SINE_TABLE_REPEAT_5(i, n, shift)  SINE_TABLE_REPEAT_5((i)+32, n, shift)
+#define SINE_TABLE_REPEAT_7(i, n, shift)    SINE_TABLE_REPEAT_6(i, n, shift)  SINE_TABLE_REPEAT_6((i)+64, n, shift)
+#define SINE_TABLE_REPEAT_8(i, n, shift)    SINE_TABLE_REPEAT_7(i, n, shift)  SINE_TABLE_REPEAT_7((i)+128, n, shift)
+#define SINE_TABLE_REPEAT_9(i, n, shift)    SINE_TABLE_REPEAT_8(i, n, shift)  SINE_TABLE_REPEAT_8((i)+256, n, shift)
+#define SINE_TABLE_REPEAT_10(i, n, shift)   SINE_TABLE_REPEAT_9(i, n, shift)  SINE_TABLE_REPEAT_9((i)+512, n, shift)
+#define SINE_TABLE_REPEAT_11(i, n, shift)   SINE_TABLE_REPEAT_10(i, n, shift) SINE_TABLE_REPEAT_10((i)+1024, n, shift)
+#define SINE_TABLE_REPEAT_12(i, n, shift)   SINE_TABLE_REPEAT_11(i, n, shift) SINE_TABLE_REPEAT_11((i)+2048, n, shift)
+
+#define SINE_TABLE_GENERATE_(bits, shift)   SINE_TABLE_REPEAT_##bits(0, (1 << (bits)), shift) SINE_TABLE_ENTRY((1 << (bits)), (1 << (bits)), shift)
+
+/**
+ * @brief Initializer of a quarter wave sine table with 2^bits+1 entries (0 to pi/2 inclusive) scaled by 2^shift.
+ *        bits has to be a literal from 0 to 12 or a macro expanding to one, e.g.
+ *        const int table[(1 << 10)+1] = { SINE_TABLE_GENERATE(10, 30) };
+ */
+#define SINE_TABLE_GENERATE(bits, shift)    SINE_TABLE_GENERATE_(bits, shift)
@@ -0,0 +1,106 @@
+/**
+ * @file cyclic_interpolation.c
+ * @brief Interpolation of cyclic synchronous targets (CSP/CSV/CST) between master cycles
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <cyclic_interpolation.h>
+
+/*
+ * target received age targets before the newest one
+ */
+static CyclicTarget cyclic_target(CyclicInterpolator * interpolator, unsigned int age)
+{
+    return interpolator->target[(interpolator->head - age) & (CYCLIC_INTERPOLATION_FIFO_SIZE - 1)];
+}
+
+void cyclic_interpolation_init(CyclicInterpolator * interpolator, int mode, int period)
+{
+    interpolator->head = 0;
+    interpolator->count = 0;
+    interpolator->mode = mode;
+    interpolator->period = period;
+    interpolator->master_time = 0;
+}
+
+void cyclic_interpolation_push(CyclicInterpolator * interpolator, int value, unsigned int timestamp)
+{
+    if (interpolator->count > 0)
+    {
+        int error;
+
+        interpolator->master_time += interpolator->period;
+        error = (int)(timestamp - interpolator->master_time);
+
+        if (error > 2*interpolator->period || error < -2*interpolator->period)
+            interpolator->count = 0;
+        else
+            interpolator->master_time += error / (1 << CYCLIC_INTERPOLATION_TIME_FILTER);
+    }
+
+    if (interpolator->count == 0)
+        interpolator->master_time = timestamp;
+
+    interpolator->head = (interpolator->head + 1) & (CYCLIC_INTERPOLATION_FIFO_SIZE - 1);
+    interpolator->target[interpolator->head].value = value;
+    interpolator->target[interpolator->head].timestamp = interpolator->master_time;
+    if (interpolator->count < CYCLIC_INTERPOLATION_FIFO_SIZE)
+        interpolator->count++;
+}
+
+int cyclic_interpolation_get(CyclicInterpolator * interpolator, unsigned int timestamp)
+{
+    CyclicTarget p0, p1, p2, p3;
+    unsigned int age;
+    long long u, result, b, c, d;
+    int span;
+
+    if (interpolator->count == 0)
+        return 0;
+
+    if (interpolator->mode == CYCLIC_INTERPOLATION_NONE || interpolator->period <= 0 || interpolator->count < 2)
+        return interpolator->target[interpolator->head].value;
+
+    //play the targets back with a delay of one period per interpolation order and half a period for the jitter
+    timestamp -= (interpolator->mode * interpolator->period) + (interpolator->period / 2);
+
+    //newest target p1 not after the time, p2 is the one following it
+    p1 = cyclic_target(interpolator, 0);
+    if ((int)(timestamp - p1.timestamp) >= 0)
+        return p1.value;
+
+    for (age = 1; age < interpolator->count; age++)
+    {
+        p1 = cyclic_target(interpolator, age);
+        if ((int)(timestamp - p1.timestamp) >= 0)
+            break;
+    }
+    if (age == interpolator->count)
+        return p1.value;
+
+    p2 = cyclic_target(interpolator, age-1);
+    span = (int)(p2.timestamp - p1.timestamp);
+    if (span <= 0)
+        return p2.value;
+
+    //position in the segment [1/65536]
+    u = (((long long)(int)(timestamp - p1.timestamp)) << 16) / span;
+
+    if (interpolator->mode == CYCLIC_INTERPOLATION_LINEAR)
+        return p1.value + (int)(((((long long)p2.value - p1.value) * u) + (1 << 15)) >> 16);
+
+    //repeat the end points if the neighbouring targets are missing
+    p0 = (age + 1 < interpolator->count) ? cyclic_target(interpolator, age+1) : p1;
+    p3 = (age >= 2) ? cyclic_target(interpolator, age-2) : p2;
+
+    b = (long long)p2.value - p0.value;
+    c = (2 * (long long)p0.value) - (5 * (long long)p1.value) + (4 * (long long)p2.value) - p3.value;
+    d = (3 * ((long long)p1.value - p2.value)) + p3.value - p0.value;
+
+    //2*p(u) = 2*p1 + b*u + c*u^2 + d*u^3, evaluated relative to p1 in Horner form
+    result = ((d * u) >> 16) + c;
+    result = ((result * u) >> 16) + b;
+    result = (result * u) >> 16;
+
+    return p1.value + (int)((result + 1) >> 1);
+}
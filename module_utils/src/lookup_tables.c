@@ -5,6 +5,8 @@
  */
 
 #include <stdint.h>
+#include <sine_table_big.h>
+#include <sine_table_generator.h>
 
 /* sin(x) + 1/3 * sin(3x), x=0..pi/2 */
 /* TODO: why is the scaling factor the way it is? it probably depends
@@ -80,3 +82,5 @@ uint16_t sine_table[257] = {
     16305, 16315, 16324, 16332, 16340, 16347, 16353, 16359,
     16364, 16369, 16373, 16376, 16379, 16381, 16383, 16384, 16384 };
 
+/* sin(x), x=0..pi/2 in 2^SINE_TABLE_BITS steps, generated for the configured size and scaling */
+const SINE_TABLE_ENTRY_TYPE sine_quarter_table[SINE_TABLE_SIZE+1] = { SINE_TABLE_GENERATE(SINE_TABLE_BITS, SINE_TABLE_SHIFT) };
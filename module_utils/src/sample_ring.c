@@ -0,0 +1,71 @@
+/**
+ * @file sample_ring.c
+ * @brief Ring of timestamped position samples with latency compensation
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <sample_ring.h>
+
+void sample_ring_init(SampleRing * ring)
+{
+    ring->head = 0;
+    ring->count = 0;
+}
+
+void sample_ring_push(SampleRing * ring, int position, unsigned int timestamp)
+{
+    if (ring->count > 0)
+    {
+        int dt = (int)(timestamp - ring->sample[ring->head].timestamp);
+
+        if (dt == 0)
+            return;
+        if (dt < 0)
+            ring->count = 0;
+    }
+
+    ring->head = (ring->head + 1) & (SAMPLE_RING_SIZE - 1);
+    ring->sample[ring->head].position = position;
+    ring->sample[ring->head].timestamp = timestamp;
+    if (ring->count < SAMPLE_RING_SIZE)
+        ring->count++;
+}
+
+int sample_ring_extrapolate(SampleRing * ring, unsigned int timestamp, int max_horizon)
+{
+    TimestampedSample newest, oldest;
+    int age, dt;
+
+    if (ring->count == 0)
+        return 0;
+
+    newest = ring->sample[ring->head];
+    if (ring->count < 2)
+        return newest.position;
+
+    age = (int)(timestamp - newest.timestamp);
+    if (age <= 0 || age > max_horizon)
+        return newest.position;
+
+    oldest = ring->sample[(ring->head - (ring->count - 1)) & (SAMPLE_RING_SIZE - 1)];
+    dt = (int)(newest.timestamp - oldest.timestamp);
+    if (dt <= 0)
+        return newest.position;
+
+    return newest.position + (int)((((long long)(newest.position - oldest.position)) * age) / dt);
+}
+
+int sample_ring_compensate_latency(SampleRing * ring, unsigned int * clock_offset,
+        int position, unsigned int sensor_timestamp, unsigned int time_now, int max_horizon)
+{
+    unsigned int offset = time_now - sensor_timestamp;
+    int offset_change = (int)(offset - *clock_offset);
+
+    //resync if the delay decreased or one of the time bases overflowed
+    if (offset_change < 0 || offset_change > max_horizon)
+        *clock_offset = offset;
+
+    sample_ring_push(ring, position, sensor_timestamp);
+
+    return sample_ring_extrapolate(ring, time_now - *clock_offset, max_horizon);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file sine_cosine.c
+ * @brief Interpolated sine and cosine from the quarter wave table
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <sine_table_big.h>
+
+/* sine and cosine from one quarter wave fetch: in the quarter the cosine is the
+   sine mirrored at pi/4, both are interpolated between two table entries */
+void sine_cosine(unsigned int angle, int * sine, int * cosine)
+{
+    unsigned int quarter = (angle >> (SINE_COSINE_ANGLE_BITS - 2)) & 3;
+    unsigned int index = (angle >> SINE_COSINE_FRACTION_BITS) & (SINE_TABLE_SIZE - 1);
+    int fraction = angle & ((1 << SINE_COSINE_FRACTION_BITS) - 1);
+    int s_0 = sine_quarter_table[index], s_1 = sine_quarter_table[index + 1];
+    int c_0 = sine_quarter_table[SINE_TABLE_SIZE - index], c_1 = sine_quarter_table[SINE_TABLE_SIZE - index - 1];
+    long long s, c;
+
+    s = (((long long)s_0) << SINE_COSINE_FRACTION_BITS) + ((long long)(s_1 - s_0)) * fraction;
+    c = (((long long)c_0) << SINE_COSINE_FRACTION_BITS) + ((long long)(c_1 - c_0)) * fraction;
+
+    // round to Q14
+    s = (s + (1LL << (SINE_COSINE_FRACTION_BITS + SINE_TABLE_SHIFT - SINE_COSINE_SHIFT - 1))) >> (SINE_COSINE_FRACTION_BITS + SINE_TABLE_SHIFT - SINE_COSINE_SHIFT);
+    c = (c + (1LL << (SINE_COSINE_FRACTION_BITS + SINE_TABLE_SHIFT - SINE_COSINE_SHIFT - 1))) >> (SINE_COSINE_FRACTION_BITS + SINE_TABLE_SHIFT - SINE_COSINE_SHIFT);
+
+    switch (quarter)
+    {
+    case 0:
+        *sine = s;
+        *cosine = c;
+        break;
+    case 1:
+        *sine = c;
+        *cosine = -s;
+        break;
+    case 2:
+        *sine = -s;
+        *cosine = -c;
+        break;
+    default:
+        *sine = -c;
+        *cosine = s;
+        break;
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file bench_controllers.cpp
+ * @brief Cost of one update of the controllers of module_controllers on the host.
+ *        The xCORE has no floating point unit, there the difference between the double
+ *        and the fixed-point controllers is much larger than on the host.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include "test.h"
+
+extern "C" {
+#include <controllers.h>
+}
+
+#define T_S         333
+#define N_CALLS     10000000
+#define N_INPUTS    1024
+
+static int inputs[N_INPUTS];
+
+int main(void)
+{
+    PIDparam pid;
+    PIDparamFixed pid_fixed;
+    PIDparam2DOF pid_2dof;
+    unsigned seed = 1;
+    double start, sum = 0;
+    int sum_fixed = 0;
+
+    for (int i=0; i<N_INPUTS; i++)
+        inputs[i] = test_random_range(seed, -2000, 2000);
+
+    pid_init(pid);
+    pid_set_parameters(1300000, 70000, 10000, 1000, T_S, pid);
+    pid_fixed_init(pid_fixed);
+    pid_fixed_set_parameters(1300000, 70000, 10000, 1000, T_S, pid_fixed);
+    pid_2dof_init(pid_2dof);
+    pid_2dof_set_parameters(1300000, 70000, 10000, 0.5, 0, 1000, 1000, T_S, pid_2dof);
+
+    printf("bench_controllers, %d calls\n", N_CALLS);
+
+    start = test_time_ns();
+    for (int k=0; k<N_CALLS; k++)
+        sum += pid_update(1000, inputs[k & (N_INPUTS-1)], T_S, pid);
+    bench_sink = sum;
+    printf("  pid_update        %6.2f ns/call\n", (test_time_ns() - start) / N_CALLS);
+
+    start = test_time_ns();
+    for (int k=0; k<N_CALLS; k++)
+        sum_fixed += pid_fixed_update(1000, inputs[k & (N_INPUTS-1)], T_S, pid_fixed);
+    bench_sink = sum_fixed;
+    printf("  pid_fixed_update  %6.2f ns/call\n", (test_time_ns() - start) / N_CALLS);
+
+    sum = 0;
+    start = test_time_ns();
+    for (int k=0; k<N_CALLS; k++)
+        sum += pid_2dof_update(1000, inputs[k & (N_INPUTS-1)], T_S, pid_2dof);
+    bench_sink = sum;
+    printf("  pid_2dof_update   %6.2f ns/call\n", (test_time_ns() - start) / N_CALLS);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file bench_filters.cpp
+ * @brief Cost of one sample of the moving average filters: filter() summing the whole buffer,
+ *        the running sum moving_average_filter_update() and the fixed length moving_average_filter_pow2().
+ *        The outputs of the three are checked to be equal.
+ *        Cost of one sample of the biquad cascade with 1 to BIQUAD_CASCADE_MAX_SECTIONS sections, per section,
+ *        against the double second order low pass filter.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include "test.h"
+
+extern "C" {
+#include <filters.h>
+#include <biquad.h>
+}
+
+#define N_SAMPLES   2000000
+#define T_S         333
+#define N_INPUTS    4096
+
+static int inputs[N_INPUTS];
+
+template <int log2_length> static void bench_length(void)
+{
+    const int length = 1 << log2_length;
+    int buffer[FILTER_SIZE_MAX], buffer_pow2[FILTER_SIZE_MAX];
+    int index = 0, index_pow2 = 0, sum_pow2 = 0, mismatches = 0;
+    MovingAverageFilterParam param;
+    double start, t_filter, t_update, t_pow2;
+    int sum = 0;
+
+    init_filter(buffer, index, length);
+    start = test_time_ns();
+    for (int k=0; k<N_SAMPLES; k++)
+        sum += filter(buffer, index, length, inputs[k & (N_INPUTS-1)]);
+    t_filter = (test_time_ns() - start) / N_SAMPLES;
+
+    moving_average_filter_init(length, param);
+    start = test_time_ns();
+    for (int k=0; k<N_SAMPLES; k++)
+        sum += moving_average_filter_update(inputs[k & (N_INPUTS-1)], param);
+    t_update = (test_time_ns() - start) / N_SAMPLES;
+
+    for (int i=0; i<length; i++)
+        buffer_pow2[i] = 0;
+    start = test_time_ns();
+    for (int k=0; k<N_SAMPLES; k++)
+        sum += moving_average_filter_pow2(buffer_pow2, index_pow2, sum_pow2, log2_length, inputs[k & (N_INPUTS-1)]);
+    t_pow2 = (test_time_ns() - start) / N_SAMPLES;
+    bench_sink = sum;
+
+    //same outputs
+    init_filter(buffer, index, length);
+    moving_average_filter_init(length, param);
+    for (int i=0; i<length; i++)
+        buffer_pow2[i] = 0;
+    index_pow2 = 0;
+    sum_pow2 = 0;
+    for (int k=0; k<N_INPUTS*4; k++)
+    {
+        int x = inputs[k & (N_INPUTS-1)];
+        int y = filter(buffer, index, length, x);
+        if (moving_average_filter_update(x, param) != y || moving_average_filter_pow2(buffer_pow2, index_pow2, sum_pow2, log2_length, x) != y)
+            mismatches++;
+    }
+
+    printf("  length %4d  filter %7.2f  moving_average_filter_update %6.2f  moving_average_filter_pow2 %6.2f ns/sample%s\n",
+            length, t_filter, t_update, t_pow2, mismatches ? "  OUTPUTS DIFFER" : "");
+    CHECK(mismatches == 0, "length %d: %d outputs differ", length, mismatches);
+}
+
+static void bench_biquad_cascade(void)
+{
+    BiquadCascadeConfig config;
+    BiquadCascadeParam cascade;
+    SecondOrderLPfilterParam second_order;
+    double start, t_second_order;
+    double sum = 0;
+
+    //low pass, two notches and a lead-lag, the cascades use the first n of them
+    config.section[0].type = BIQUAD_SECTION_LOW_PASS;
+    config.section[0].frequency = 400;
+    config.section[1].type = BIQUAD_SECTION_NOTCH;
+    config.section[1].frequency = 150;
+    config.section[1].width = 40;
+    config.section[1].depth = 20;
+    config.section[2].type = BIQUAD_SECTION_LEAD_LAG;
+    config.section[2].frequency = 50;
+    config.section[2].width = 80;
+    config.section[3].type = BIQUAD_SECTION_NOTCH;
+    config.section[3].frequency = 250;
+    config.section[3].width = 60;
+    config.section[3].depth = 30;
+
+    second_order_LP_filter_init(400, T_S, second_order);
+    start = test_time_ns();
+    for (int k=0; k<N_SAMPLES; k++)
+    {
+        double x = inputs[k & (N_INPUTS-1)];
+        sum += second_order_LP_filter_update(&x, second_order);
+    }
+    t_second_order = (test_time_ns() - start) / N_SAMPLES;
+    bench_sink = sum;
+    printf("  second_order_LP_filter_update (double)  %6.2f ns/sample\n", t_second_order);
+
+    for (int n=1; n<=BIQUAD_CASCADE_MAX_SECTIONS; n++)
+    {
+        int sum_cascade = 0;
+        double t_cascade;
+
+        config.n_sections = n;
+        biquad_cascade_init(cascade);
+        CHECK(biquad_cascade_design(config, T_S, cascade) == n, "%d sections not designed", n);
+
+        start = test_time_ns();
+        for (int k=0; k<N_SAMPLES; k++)
+            sum_cascade += biquad_cascade_update(inputs[k & (N_INPUTS-1)], cascade);
+        t_cascade = (test_time_ns() - start) / N_SAMPLES;
+        bench_sink = sum_cascade;
+
+        printf("  biquad_cascade_update %d section%s      %6.2f ns/sample, %6.2f ns/section\n",
+                n, n > 1 ? "s" : " ", t_cascade, t_cascade / n);
+    }
+}
+
+int main(void)
+{
+    unsigned seed = 7;
+
+    for (int i=0; i<N_INPUTS; i++)
+        inputs[i] = test_random_range(seed, -100000, 100000);
+
+    printf("bench_filters, %d samples\n", N_SAMPLES);
+    bench_length<3>();
+    bench_length<4>();
+    bench_length<5>();
+    bench_length<6>();
+    bench_length<7>();
+    bench_biquad_cascade();
+
+    return test_failures == 0 ? 0 : 1;
+}
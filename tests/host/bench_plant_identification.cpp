@@ -0,0 +1,82 @@
+/**
+ * @file bench_plant_identification.cpp
+ * @brief Cost of one control period of the plant identification on the host, with the rigid models
+ *        only and with the resonant model, against a rigid plant with velocity noise.
+ *        The best of N_RUNS identifications is taken. The identified model is printed to check that
+ *        the fit still converges.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <plant_identification.h>
+}
+
+#define T_S             333
+#define INERTIA         5.0e-4      //[kg m^2]
+#define FRICTION        2.0e-4      //viscous friction [Nm s/rad]
+#define NOISE           0.3         //velocity noise [rpm]
+#define TWO_PI          6.28318530718
+#define N_RUNS          5
+
+static double run(int resonance, PlantIdentificationParam &param, int &periods)
+{
+    unsigned seed = 3;
+    double omega = 0, torque = 0, start, excitation_ns = 0;
+    int excitation_periods = 0;
+
+    periods = 0;
+
+    CHECK(plant_identification_init(200, 100, 50, resonance, 65536, T_S, param) == 0, "not started");
+
+    while (param.step != PLANT_ID_DONE && param.step != PLANT_ID_FAILED && periods < 100000)
+    {
+        double velocity = omega * 60.00 / TWO_PI + NOISE * (test_random_range(seed, -1000, 1000) / 1000.00);
+        int exciting = param.step == PLANT_ID_EXCITING;
+
+        start = test_time_ns();
+        torque = plant_identification_update(velocity, param);
+        if (exciting)
+        {
+            excitation_ns += test_time_ns() - start;
+            excitation_periods++;
+        }
+        periods++;
+
+        omega += (((torque / 1000.00) - (FRICTION * omega)) / INERTIA) * (T_S / 1000000.00);
+    }
+
+    return excitation_ns / excitation_periods;
+}
+
+static void bench(int resonance)
+{
+    PlantIdentificationParam param;
+    double best = 1.0e9;
+    int periods;
+
+    for (int i=0; i<N_RUNS; i++)
+    {
+        double ns = run(resonance, param, periods);
+        if (ns < best)
+            best = ns;
+    }
+
+    printf("  %-9s %6d periods, %6.0f ns/period while exciting, J %d g cm^2 (%d), B %d uNm/rpm (%d)\n",
+            resonance ? "resonant" : "rigid", periods, best,
+            param.model.moment_of_inertia, (int)lround(INERTIA * 1.0e7),
+            param.model.viscous_friction, (int)lround(FRICTION * 1.0e6 * TWO_PI / 60.00));
+    CHECK(param.step == PLANT_ID_DONE, "%s: identification failed", resonance ? "resonant" : "rigid");
+}
+
+int main(void)
+{
+    printf("bench_plant_identification, period %d us\n", T_S);
+
+    bench(0);
+    bench(1);
+
+    return test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file bench_scurve_profiler.cpp
+ * @brief Cost of one step of the jerk limited position profiler on the host and settle time of its moves,
+ *        checking that velocity, acceleration and jerk stay inside their limits and that no move overshoots,
+ *        also if the target changes during the move. The best of N_RUNS passes is taken for the cost.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <string.h>
+#include "test.h"
+
+extern "C" {
+#include <profile.h>
+}
+
+#define T_S             333
+#define RESOLUTION      65536
+#define V_MAX           1.0e6       //[ticks/s]
+#define A_MAX           1.0e7       //[ticks/s^2]
+#define J_MAX           2.0e8       //[ticks/s^3]
+#define TO_RPM(x)       ((x) * 60.00 / RESOLUTION)
+#define LIMIT_TOLERANCE 1.0e-5      //relative, the discrete approach of the velocity limit exceeds it by a few ppm
+#define SETTLE_TAIL     0.040       //settle time over the ideal one [s], the braking is searched conservatively
+#define MAX_STEPS       30000
+#define N_RUNS          5
+
+struct Move {
+    double distance;            //[ticks]
+    double retarget_time;       //[s], negative for none
+    double retarget_distance;   //new target from the start [ticks]
+};
+
+struct Result {
+    int steps;                  //until the profiler snaps to the target
+    double overshoot;           //[ticks]
+    double velocity;            //peak [ticks/s]
+    double acceleration;        //peak [ticks/s^2]
+    double jerk;                //peak [ticks/s^3]
+};
+
+static ProfilerParam profiler_param(void)
+{
+    ProfilerParam param;
+
+    memset(&param, 0, sizeof(param));
+    param.delta_T = T_S / 1000000.00;
+    param.resolution = RESOLUTION;
+    param.v_max = TO_RPM(V_MAX);
+    param.acceleration_max = TO_RPM(A_MAX);
+    param.deceleration_max = TO_RPM(A_MAX);
+    param.jerk_max = TO_RPM(J_MAX);
+
+    return param;
+}
+
+static Result run(const Move &move)
+{
+    ProfilerParam param = profiler_param();
+    ScurveProfilerState state;
+    Result result = { -1, 0, 0, 0, 0 };
+    double target = move.distance, direction = (move.distance >= 0) ? 1 : -1, acceleration_1n = 0;
+
+    scurve_profiler_init(0, 0, state);
+
+    for (int k=1; k<=MAX_STEPS; k++)
+    {
+        double position;
+
+        if (move.retarget_time >= 0 && k == (int)(move.retarget_time / param.delta_T))
+        {
+            target = move.retarget_distance;
+            direction = (target >= state.position) ? 1 : -1;
+        }
+
+        position = scurve_pos_profiler(target, param, state);
+
+        if (direction * (position - target) > result.overshoot)
+            result.overshoot = direction * (position - target);
+        if (fabs(state.velocity) > result.velocity)
+            result.velocity = fabs(state.velocity);
+        if (fabs(state.acceleration) > result.acceleration)
+            result.acceleration = fabs(state.acceleration);
+        //the step snapping to the target sets the acceleration to 0 and is no jerk of the profile
+        if (position != target && fabs(state.acceleration - acceleration_1n) / param.delta_T > result.jerk)
+            result.jerk = fabs(state.acceleration - acceleration_1n) / param.delta_T;
+        acceleration_1n = state.acceleration;
+
+        if (position == target && state.velocity == 0)
+        {
+            result.steps = k;
+            break;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Shortest duration of a move from standstill to standstill with the limits [s].
+ */
+static double ideal_time(double distance)
+{
+    double v = V_MAX, a = A_MAX, t_a;
+
+    distance = fabs(distance);
+
+    //the acceleration does not reach A_MAX or the velocity does not reach V_MAX
+    if (a * a / J_MAX > v)
+        a = sqrt(v * J_MAX);
+    if (distance < v * ((v / a) + (a / J_MAX)))
+    {
+        //no constant velocity: solve distance = v * (v/a + a/j) for v with the same shape
+        double v_low = 0, v_high = v;
+        for (int i=0; i<60; i++)
+        {
+            double v_test = (v_low + v_high) / 2, a_test = (a * a / J_MAX > v_test) ? sqrt(v_test * J_MAX) : a;
+            if (v_test * ((v_test / a_test) + (a_test / J_MAX)) > distance)
+                v_high = v_test;
+            else
+                v_low = v_test;
+        }
+        v = v_low;
+        if (a * a / J_MAX > v)
+            a = sqrt(v * J_MAX);
+    }
+    t_a = (v / a) + (a / J_MAX);
+
+    return t_a + (distance / v);
+}
+
+static void check_move(const Move &move)
+{
+    Result result = run(move);
+    double time = result.steps * (T_S / 1000000.00);
+
+    if (move.retarget_time < 0)
+        printf("  %8.0f ticks:                 %5.3f s (ideal %5.3f s)", move.distance, time, ideal_time(move.distance));
+    else
+        printf("  %8.0f ticks, %8.0f at %.2f s: %5.3f s              ", move.distance, move.retarget_distance, move.retarget_time, time);
+    printf(", overshoot %.2f ticks, peak v %.4f a %.4f j %.4f of the limits\n", result.overshoot,
+            result.velocity / V_MAX, result.acceleration / A_MAX, result.jerk / J_MAX);
+
+    CHECK(result.steps > 0, "%.0f ticks: not settled", move.distance);
+    CHECK(result.overshoot <= 0.50, "%.0f ticks: overshoot %.2f ticks", move.distance, result.overshoot);
+    CHECK(result.velocity <= V_MAX * (1.00 + LIMIT_TOLERANCE), "%.0f ticks: velocity %.0f ticks/s", move.distance, result.velocity);
+    CHECK(result.acceleration <= A_MAX * (1.00 + LIMIT_TOLERANCE), "%.0f ticks: acceleration %.0f ticks/s^2", move.distance, result.acceleration);
+    CHECK(result.jerk <= J_MAX * (1.00 + LIMIT_TOLERANCE), "%.0f ticks: jerk %.0f ticks/s^3", move.distance, result.jerk);
+    if (move.retarget_time < 0)
+        CHECK(time <= ideal_time(move.distance) + SETTLE_TAIL, "%.0f ticks: %.3f s", move.distance, time);
+}
+
+/**
+ * @brief Mean cost of a step over a whole move, best of N_RUNS.
+ */
+static void bench_step(double distance)
+{
+    ProfilerParam param = profiler_param();
+    ScurveProfilerState state;
+    double best = 1.0e9;
+
+    for (int run=0; run<N_RUNS; run++)
+    {
+        double start, ns;
+        int steps = 0;
+
+        scurve_profiler_init(0, 0, state);
+        start = test_time_ns();
+        while (steps < MAX_STEPS && (state.position != distance || state.velocity != 0))
+        {
+            bench_sink = scurve_pos_profiler(distance, param, state);
+            steps++;
+        }
+        ns = (test_time_ns() - start) / steps;
+        if (ns < best)
+            best = ns;
+    }
+
+    printf("  cost: %.0f ns per step over a %.0f tick move\n", best, distance);
+}
+
+int main(void)
+{
+    Move moves[] = {
+        { 1, -1, 0 }, { 10, -1, 0 }, { 1000, -1, 0 }, { 1.0e5, -1, 0 }, { 1.0e6, -1, 0 }, { 3.0e6, -1, 0 }, { -1.0e6, -1, 0 },
+        { 1.0e6, 0.30, 2.0e6 },     //further in the same direction
+        { 1.0e6, 0.30, 1.0e5 },     //behind the position, reverses
+        { 1.0e6, 0.10, -5.0e5 },    //reverses while accelerating
+    };
+
+    printf("bench_scurve_profiler, period %d us, %.0e ticks/s, %.0e ticks/s^2, %.0e ticks/s^3\n", T_S, V_MAX, A_MAX, J_MAX);
+
+    for (unsigned i=0; i<sizeof(moves)/sizeof(moves[0]); i++)
+        check_move(moves[i]);
+
+    bench_step(1.0e6);
+
+    return test_failures == 0 ? 0 : 1;
+}
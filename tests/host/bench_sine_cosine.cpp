@@ -0,0 +1,79 @@
+/**
+ * @file bench_sine_cosine.cpp
+ * @brief Accuracy and cost of sine_cosine() on the host for the table configured by SINE_TABLE_BITS and
+ *        SINE_TABLE_COMPACT ("make sine_tables" runs all of them). The error over all angles against libm
+ *        must stay below the rounding of the result, the rounding of compact entries and the error of the
+ *        linear interpolation, h^2/8 for the step h of the table. The best of N_RUNS passes is taken for the cost.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <sine_table_big.h>
+}
+
+#define N_ANGLES        (1 << SINE_COSINE_ANGLE_BITS)
+#define SCALE           ((double)(1 << SINE_COSINE_SHIFT))
+#define TWO_PI          6.28318530718
+#define N_RUNS          5
+
+#ifdef SINE_TABLE_COMPACT
+#define ENTRY_ROUNDING  0.50        //[LSB of the result]
+#else
+#define ENTRY_ROUNDING  0.00
+#endif
+
+int main(void)
+{
+    double step = (TWO_PI / 4.00) / SINE_TABLE_SIZE;
+    double interpolation = SCALE * step * step / 8.00;
+    double max_limit = 0.50 + ENTRY_ROUNDING + interpolation + 0.01;
+    //uniform rounding errors and the parabolic interpolation error (rms of 4u(1-u) is sqrt(8/15))
+    double rms_limit = sqrt((1.00 / 12.00) + ((ENTRY_ROUNDING > 0) ? (1.00 / 12.00) : 0.00) +
+            (8.00 / 15.00) * interpolation * interpolation) + 0.01;
+    double max_error = 0, sum_square = 0, best_ns = 1.0e9;
+
+    for (int angle=0; angle<N_ANGLES; angle++)
+    {
+        int sine, cosine;
+        double error_s, error_c;
+
+        sine_cosine(angle, sine, cosine);
+        error_s = fabs(sine - SCALE * sin((TWO_PI * angle) / N_ANGLES));
+        error_c = fabs(cosine - SCALE * cos((TWO_PI * angle) / N_ANGLES));
+        sum_square += (error_s * error_s) + (error_c * error_c);
+        if (error_s > max_error)
+            max_error = error_s;
+        if (error_c > max_error)
+            max_error = error_c;
+    }
+
+    for (int run=0; run<N_RUNS; run++)
+    {
+        double start = test_time_ns(), ns;
+        int sum = 0;
+
+        for (int angle=0; angle<N_ANGLES; angle++)
+        {
+            int sine, cosine;
+
+            sine_cosine(angle * 40503u, sine, cosine);
+            sum += sine + cosine;
+        }
+        ns = (test_time_ns() - start) / N_ANGLES;
+        bench_sink = sum;
+        if (ns < best_ns)
+            best_ns = ns;
+    }
+
+    printf("bench_sine_cosine, %2d bit %s table, %5u bytes: max error %6.3f LSB (limit %6.3f), rms %6.3f LSB (limit %6.3f), %.1f ns\n",
+            SINE_TABLE_BITS, (sizeof(SINE_TABLE_ENTRY_TYPE) == 2) ? "Q14" : "Q30", (unsigned)sizeof(sine_quarter_table),
+            max_error, max_limit, sqrt(sum_square / (2.00 * N_ANGLES)), rms_limit, best_ns);
+
+    CHECK(max_error <= max_limit, "max error %.3f LSB", max_error);
+    CHECK(sqrt(sum_square / (2.00 * N_ANGLES)) <= rms_limit, "rms error %.3f LSB", sqrt(sum_square / (2.00 * N_ANGLES)));
+
+    return test_failures == 0 ? 0 : 1;
+}
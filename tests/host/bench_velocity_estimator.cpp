@@ -0,0 +1,178 @@
+/**
+ * @file bench_velocity_estimator.cpp
+ * @brief Noise and lag of the velocity of the alpha-beta-gamma estimator against the position difference
+ *        of the sensor services, on synthetic traces of a REM 16MT and of an 18 bit BiSS encoder: quantized
+ *        positions with noise, read at jittering instants with exact timestamps, of a motor that holds its
+ *        speed, accelerates with a constant torque and holds again. The velocities are evaluated at 3 kHz as
+ *        in motion_control_service(). The lag is the mean error during the acceleration divided by it.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <velocity_estimator.h>
+#include <filters.h>
+}
+
+#define CONTROL_PERIOD      333         //[us]
+#define INERTIA             200         //[g cm^2]
+#define START_VELOCITY      1000        //[rpm]
+#define TORQUE              42          //[mNm], about 20000 rpm/s
+#define ACCELERATION_START  0.20        //[s]
+#define ACCELERATION_END    0.30        //[s]
+#define DURATION            0.45        //[s]
+#define JITTER              3           //read instants [us]
+#define TWO_PI              6.28318530718
+
+enum Method { DIFFERENCE, DIFFERENCE_MA8, ESTIMATOR, ESTIMATOR_TORQUE };
+
+struct Sensor {
+    const char *name;
+    int resolution;         //[ticks/rotation]
+    int read_period;        //[us]
+    int compute_period;     //velocity compute period of the difference [us]
+    int noise;              //position noise [ticks]
+};
+
+struct Result {
+    double constant;        //rms error at constant speed, after the start and after the acceleration [rpm]
+    double acceleration;    //rms error during the acceleration, after its first 20 ms [rpm]
+    double lag;             //[us]
+};
+
+/**
+ * @brief Velocity of the motor [rpm] and its position [rotations] at time t [s].
+ */
+static void motion(double t, double &velocity, double &position)
+{
+    double acceleration = ((TORQUE * 1.0e-3) / (INERTIA * 1.0e-7)) * (60.00 / TWO_PI);   //[rpm/s]
+    double t_a = (t < ACCELERATION_START) ? 0 : ((t < ACCELERATION_END) ? t - ACCELERATION_START : ACCELERATION_END - ACCELERATION_START);
+
+    velocity = START_VELOCITY + acceleration * t_a;
+    position = ((START_VELOCITY * t) + (acceleration * t_a * t_a / 2.00) + (acceleration * t_a * (t - ACCELERATION_START - t_a))) / 60.00;
+}
+
+static Result run(const Sensor &sensor, Method method, int bandwidth, int inertia)
+{
+    VelocityEstimatorParam estimator;
+    Result result = { 0, 0, 0 };
+    unsigned seed = 17;
+    int velocity = 0, buffer[8] = { 0 }, index = 0, sum = 0, old_count = 0, time_since_compute = 0, last_read = 0;
+    int n_constant = 0, n_acceleration = 0, next_control = CONTROL_PERIOD, torque = 0;
+    double sum_constant = 0, sum_acceleration = 0, sum_error = 0;
+    double acceleration = ((TORQUE * 1.0e-3) / (INERTIA * 1.0e-7)) * (60.00 / TWO_PI);
+
+    velocity_estimator_init(bandwidth, sensor.resolution, sensor.read_period, estimator);
+    velocity_estimator_set_inertia(method == ESTIMATOR_TORQUE ? inertia : 0, estimator);
+
+    for (int read=0; ; read+=sensor.read_period)
+    {
+        int t_read = read + test_random_range(seed, -JITTER, JITTER);
+        double v_true, p_true;
+        int count;
+
+        if (t_read < 0)
+            t_read = 0;
+        if (t_read > DURATION * 1.0e6)
+            break;
+
+        //the control periods before this read see the velocity of the last read
+        while (next_control <= t_read)
+        {
+            double t = next_control * 1.0e-6, error;
+
+            motion(t, v_true, p_true);
+            error = v_true - velocity;
+            if ((t >= 0.10 && t < ACCELERATION_START) || t >= ACCELERATION_END + 0.05)
+            {
+                sum_constant += error * error;
+                n_constant++;
+            }
+            else if (t >= ACCELERATION_START + 0.02 && t < ACCELERATION_END)
+            {
+                sum_acceleration += error * error;
+                sum_error += error;
+                n_acceleration++;
+            }
+            //torque reference of the last control period, known to motion_control_service
+            torque = (t >= ACCELERATION_START && t < ACCELERATION_END) ? TORQUE : 0;
+            next_control += CONTROL_PERIOD;
+        }
+
+        motion(t_read * 1.0e-6, v_true, p_true);
+        count = (int)floor(p_true * sensor.resolution) + test_random_range(seed, -sensor.noise, sensor.noise);
+
+        if (method == ESTIMATOR || method == ESTIMATOR_TORQUE)
+            velocity = velocity_estimator_update(count, t_read, torque, START_VELOCITY, estimator);
+        else
+        {
+            //the difference of the serial encoder service, every compute period rounded up to the reads
+            time_since_compute += t_read - last_read;
+            if (read == 0)
+            {
+                old_count = count;
+                time_since_compute = 0;
+            }
+            else if (time_since_compute >= sensor.compute_period)
+            {
+                velocity = (int)((((long long)(count - old_count)) * (60000000 / time_since_compute)) / sensor.resolution);
+                if (method == DIFFERENCE_MA8)
+                    velocity = moving_average_filter_pow2(buffer, index, sum, 3, velocity);
+                old_count = count;
+                time_since_compute = 0;
+            }
+        }
+        last_read = t_read;
+    }
+
+    result.constant = sqrt(sum_constant / n_constant);
+    result.acceleration = sqrt(sum_acceleration / n_acceleration);
+    result.lag = ((sum_error / n_acceleration) / acceleration) * 1.0e6;
+
+    return result;
+}
+
+static Result report(const Sensor &sensor, const char *name, Method method, int bandwidth, int inertia)
+{
+    Result result = run(sensor, method, bandwidth, inertia);
+
+    printf("  %-9s %-26s constant %5.2f rpm, acceleration %6.1f rpm, lag %6.0f us\n", sensor.name, name,
+            result.constant, result.acceleration, result.lag);
+
+    return result;
+}
+
+int main(void)
+{
+    Sensor rem_16mt = { "REM 16MT", 65536, 53, 400, 2 };
+    Sensor biss = { "BiSS", 262144, 40, 100, 2 };
+    Result difference, estimator, torque, torque_wrong;
+
+    printf("bench_velocity_estimator, %d rpm, then %d mNm on %d g cm^2 for %.0f ms, evaluated every %d us\n",
+            START_VELOCITY, TORQUE, INERTIA, (ACCELERATION_END - ACCELERATION_START) * 1000, CONTROL_PERIOD);
+
+    difference = report(rem_16mt, "difference + MA8", DIFFERENCE_MA8, 0, 0);
+    estimator = report(rem_16mt, "alpha-beta-gamma 100 Hz", ESTIMATOR, 100, 0);
+    torque = report(rem_16mt, "alpha-beta-gamma 50 Hz + T", ESTIMATOR_TORQUE, 50, INERTIA);
+    torque_wrong = report(rem_16mt, "  with J off by 30%", ESTIMATOR_TORQUE, 50, (INERTIA * 13) / 10);
+
+    CHECK(estimator.constant < difference.constant && fabs(estimator.lag) < fabs(difference.lag),
+            "REM 16MT: estimator %.2f rpm / %.0f us against difference %.2f rpm / %.0f us",
+            estimator.constant, estimator.lag, difference.constant, difference.lag);
+    CHECK(torque.constant < estimator.constant && fabs(torque.lag) <= fabs(estimator.lag),
+            "REM 16MT: torque input %.2f rpm / %.0f us against %.2f rpm / %.0f us",
+            torque.constant, torque.lag, estimator.constant, estimator.lag);
+    CHECK(torque_wrong.acceleration < difference.acceleration,
+            "REM 16MT: J off by 30%%, %.1f rpm against %.1f rpm of the difference", torque_wrong.acceleration, difference.acceleration);
+
+    difference = report(biss, "difference", DIFFERENCE, 0, 0);
+    estimator = report(biss, "alpha-beta-gamma 200 Hz", ESTIMATOR, 200, 0);
+
+    CHECK(estimator.constant < difference.constant && fabs(estimator.lag) < fabs(difference.lag),
+            "BiSS: estimator %.2f rpm / %.0f us against difference %.2f rpm / %.0f us",
+            estimator.constant, estimator.lag, difference.constant, difference.lag);
+
+    return test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,596 @@
+/**
+ * @file simulate_motion_control.cpp
+ * @brief Host build of the cascaded motion control loop closed over the plant model.
+ *        Runs scenario files faster than real time and reports the following error and
+ *        the cost of the control tick. The control law of each period is the one of
+ *        motion_control_service(): the functions of motion_control_loop.h called in the same
+ *        order, with the velocity estimator, the gain schedules, the load torque observer,
+ *        the feed-forward, the torque filters and the interpolation of cyclic targets.
+ *        Tuning, brake handling and the limited torque position controller are not simulated.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <time.h>
+
+extern "C" {
+#include <plant_model.h>
+#include <motion_control_loop.h>
+}
+
+#define CONTROL_PERIOD          POSITION_CONTROL_LOOP_PERIOD    // period of the control loop [microseconds]
+#define PLANT_SUBSTEPS          9       // integration steps of the plant per control period
+#define MAX_STEPS               64
+
+/**
+ * @brief steps of a scenario, same meaning as SimulationStep of plant_simulator_service.h
+ */
+typedef enum {
+    STEP_POSITION = 1,
+    STEP_POSITION_RAMP,
+    STEP_VELOCITY,
+    STEP_VELOCITY_RAMP,
+    STEP_TORQUE,
+    STEP_REVERSAL,
+    STEP_LOAD_TORQUE,
+    STEP_BRAKE_RELEASE,
+    STEP_HOLD
+} StepType;
+
+typedef enum {
+    MODE_DISABLED = 0,
+    MODE_POSITION,
+    MODE_VELOCITY,
+    MODE_TORQUE
+} Mode;
+
+typedef struct {
+    int type;
+    int value;
+    int duration;       // [ms]
+    int max_error;      // limit of the following error, 0 for no limit
+} Step;
+
+/**
+ * @brief configuration of the simulated plant and controller, with working example gains
+ *        for the default plant. Every field can be set from the scenario file.
+ */
+typedef struct {
+    PlantModelConfig plant;
+    MotionControlConfig motion;
+    int control_moment_of_inertia;      // moment of inertia known to the controller [g cm^2], 0 for the one of the plant
+    GainSchedule velocity_gain_schedule;
+    GainSchedule position_gain_schedule;
+} SimulationConfig;
+
+static SimulationConfig default_config(void)
+{
+    /* resolution, J [g cm^2], viscous [uNm/rpm], coulomb, static [mNm], tau [us], max torque [mNm], brake [ms], brake [mNm] */
+    PlantModelConfig plant = { 65536, 200, 50, 20, 30, 200, 1000, 50, 2000 };
+    SimulationConfig config;
+
+    memset(&config, 0, sizeof(config));
+    config.plant = plant;
+    config.motion.position_control_strategy = POS_PID_VELOCITY_CASCADED_CONTROLLER;
+    config.motion.min_pos_range_limit = -0x7fffffff;
+    config.motion.max_pos_range_limit = 0x7fffffff;
+    /* position: about 20 Hz bandwidth, output in rpm */
+    config.motion.position_kp = 114000;
+    config.motion.position_integral_limit = 12000;
+    /* velocity: about 100 Hz bandwidth, output in mNm */
+    config.motion.velocity_kp = 1300000;
+    config.motion.velocity_ki = 70000;
+    config.motion.velocity_integral_limit = 1000;
+    config.motion.max_motor_speed = 5000;
+    config.motion.max_torque = 1000;
+    config.motion.enable_profiler = 1;
+    config.motion.max_speed_profiler = 2000;
+    config.motion.max_acceleration_profiler = 10000;
+    config.motion.max_deceleration_profiler = 10000;
+    config.motion.max_torque_rate_profiler = 10000;
+    config.motion.filter = 1000;
+    config.motion.adaptive_notch_width = 50;
+    config.motion.adaptive_notch_threshold = 20;
+    config.motion.cyclic_master_period = 1000;  //the scenario targets change every millisecond
+    gain_schedule_init(config.velocity_gain_schedule);
+    gain_schedule_init(config.position_gain_schedule);
+
+    return config;
+}
+
+typedef struct {
+    const char *name;
+    size_t offset;
+} ConfigKey;
+
+#define CONFIG_KEY(field)   { #field, offsetof(SimulationConfig, field) }
+#define PLANT_KEY(field)    { #field, offsetof(SimulationConfig, plant) + offsetof(PlantModelConfig, field) }
+#define MOTION_KEY(field)   { #field, offsetof(SimulationConfig, motion) + offsetof(MotionControlConfig, field) }
+
+static const ConfigKey config_keys[] = {
+    PLANT_KEY(resolution), PLANT_KEY(moment_of_inertia), PLANT_KEY(viscous_friction), PLANT_KEY(coulomb_friction),
+    PLANT_KEY(static_friction), PLANT_KEY(torque_time_constant), PLANT_KEY(brake_release_time), PLANT_KEY(brake_holding_torque),
+    CONFIG_KEY(control_moment_of_inertia), MOTION_KEY(position_control_strategy),
+    MOTION_KEY(position_kp), MOTION_KEY(position_ki), MOTION_KEY(position_kd), MOTION_KEY(position_integral_limit),
+    MOTION_KEY(velocity_kp), MOTION_KEY(velocity_ki), MOTION_KEY(velocity_kd), MOTION_KEY(velocity_integral_limit),
+    MOTION_KEY(max_motor_speed), MOTION_KEY(max_torque), MOTION_KEY(enable_profiler), MOTION_KEY(max_speed_profiler),
+    MOTION_KEY(max_acceleration_profiler), MOTION_KEY(max_deceleration_profiler), MOTION_KEY(max_torque_rate_profiler),
+    MOTION_KEY(max_jerk_profiler), MOTION_KEY(filter), MOTION_KEY(velocity_feedforward), MOTION_KEY(acceleration_feedforward),
+    MOTION_KEY(disturbance_observer_bandwidth), MOTION_KEY(velocity_estimator_bandwidth), MOTION_KEY(adaptive_notch),
+    MOTION_KEY(adaptive_notch_width), MOTION_KEY(adaptive_notch_threshold), MOTION_KEY(cyclic_interpolation)
+};
+
+static const char *step_names[] = {
+    "", "position", "position_ramp", "velocity", "velocity_ramp", "torque", "reversal", "load_torque", "brake_release", "hold"
+};
+
+/**
+ * @brief Reads a scenario file. Lines are either "<config key> <value>",
+ *        "step <type> <value> <duration ms> [max error]" or
+ *        "schedule <velocity|position> <input> <breakpoint> <kp> <ki> <kd>", # starts a comment.
+ *
+ * @return number of steps, -1 on error
+ */
+static int read_scenario(const char *file_name, SimulationConfig &config, Step steps[])
+{
+    FILE *f = fopen(file_name, "r");
+    char line[256], word[64], type[64];
+    int n_steps = 0, line_number = 0;
+
+    if (f == NULL)
+    {
+        printf("cannot open %s\n", file_name);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        char *comment = strchr(line, '#');
+        int value, found = 0;
+
+        line_number++;
+        if (comment)
+            *comment = 0;
+        if (sscanf(line, "%63s", word) != 1)
+            continue;
+
+        if (strcmp(word, "step") == 0)
+        {
+            Step step = {0, 0, 0, 0};
+            if (n_steps >= MAX_STEPS || sscanf(line, "%*s %63s %d %d %d", type, &step.value, &step.duration, &step.max_error) < 3)
+            {
+                printf("%s:%d: bad step\n", file_name, line_number);
+                fclose(f);
+                return -1;
+            }
+            for (int t=STEP_POSITION; t<=STEP_HOLD; t++)
+                if (strcmp(type, step_names[t]) == 0)
+                    step.type = t;
+            if (step.type == 0)
+            {
+                printf("%s:%d: unknown step type %s\n", file_name, line_number, type);
+                fclose(f);
+                return -1;
+            }
+            steps[n_steps++] = step;
+            continue;
+        }
+
+        if (strcmp(word, "schedule") == 0)
+        {
+            int input, breakpoint, kp, ki, kd;
+            GainSchedule *schedule = NULL;
+            if (sscanf(line, "%*s %63s %d %d %d %d %d", type, &input, &breakpoint, &kp, &ki, &kd) == 6)
+            {
+                if (strcmp(type, "velocity") == 0)
+                    schedule = &config.velocity_gain_schedule;
+                else if (strcmp(type, "position") == 0)
+                    schedule = &config.position_gain_schedule;
+            }
+            if (schedule == NULL || schedule->length >= GAIN_SCHEDULE_MAX_POINTS)
+            {
+                printf("%s:%d: bad schedule\n", file_name, line_number);
+                fclose(f);
+                return -1;
+            }
+            schedule->input = (GainScheduleInput) input;
+            schedule->breakpoint[schedule->length] = breakpoint;
+            schedule->kp[schedule->length] = kp;
+            schedule->ki[schedule->length] = ki;
+            schedule->kd[schedule->length] = kd;
+            schedule->length++;
+            continue;
+        }
+
+        for (unsigned k=0; k<sizeof(config_keys)/sizeof(config_keys[0]); k++)
+        {
+            if (strcmp(word, config_keys[k].name) == 0 && sscanf(line, "%*s %d", &value) == 1)
+            {
+                *(int *)(((char *)&config) + config_keys[k].offset) = value;
+                found = 1;
+            }
+        }
+        if (!found)
+        {
+            printf("%s:%d: unknown setting %s\n", file_name, line_number, word);
+            fclose(f);
+            return -1;
+        }
+    }
+
+    fclose(f);
+    config.plant.max_torque = config.motion.max_torque;
+    config.motion.resolution = config.plant.resolution;
+    config.motion.moment_of_inertia = config.control_moment_of_inertia > 0 ? config.control_moment_of_inertia : config.plant.moment_of_inertia;
+    if (!gain_schedule_check(config.velocity_gain_schedule) || !gain_schedule_check(config.position_gain_schedule))
+    {
+        printf("%s: bad gain schedule\n", file_name);
+        return -1;
+    }
+    return n_steps;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec) * 1.0e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief State of the simulated motion control loop, the variables of motion_control_service().
+ */
+typedef struct {
+    Mode mode;
+    MotionControlConfig motion_ctrl_config;
+    DownstreamControlData downstream_control_data;
+
+    PIDparam position_control_pid_param;
+    PIDparam velocity_control_pid_param;
+    GainSchedule velocity_gain_schedule, position_gain_schedule;
+    ProfilerParam profiler_param;
+    ScurveProfilerState scurve_profiler_state;
+    ProfileTable position_profile_table;
+    int position_profile_table_active;
+    CyclicInterpolator cyclic_targets;
+    DisturbanceObserverParam disturbance_observer;
+    VelocityEstimatorParam velocity_estimator;
+    int velocity_estimator_enabled;
+
+    BiquadFilterParam torque_filter_param;
+    BiquadCascadeParam torque_filter_chain;
+    int torque_filter_chain_input;
+    AdaptiveNotchParam adaptive_notch_param;
+
+    double position_ref_in_k, position_ref_in_k_1n, position_ref_in_k_2n, position_ref_in_k_3n;
+    double position_k, position_k_1;
+    double velocity_ref_k, velocity_ref_in_k, velocity_ref_in_k_1n;
+    double torque_ref_in_k_1n;
+    int filter_output;
+} Controller;
+
+static void controller_init(const SimulationConfig &config, Controller &c)
+{
+    memset(&c, 0, sizeof(c));
+    c.motion_ctrl_config = config.motion;
+    MotionControlConfig &motion_ctrl_config = c.motion_ctrl_config;
+
+    pid_init(c.velocity_control_pid_param);
+    pid_set_parameters(motion_ctrl_config.velocity_kp, motion_ctrl_config.velocity_ki, motion_ctrl_config.velocity_kd,
+            motion_ctrl_config.velocity_integral_limit, CONTROL_PERIOD, c.velocity_control_pid_param);
+    pid_init(c.position_control_pid_param);
+    pid_set_parameters(motion_ctrl_config.position_kp, motion_ctrl_config.position_ki, motion_ctrl_config.position_kd,
+            motion_ctrl_config.position_integral_limit, CONTROL_PERIOD, c.position_control_pid_param);
+    c.velocity_gain_schedule = config.velocity_gain_schedule;
+    c.position_gain_schedule = config.position_gain_schedule;
+
+    c.profiler_param.delta_T = ((double)CONTROL_PERIOD)/1000000.00;
+    c.profiler_param.v_max = motion_ctrl_config.max_speed_profiler;
+    c.profiler_param.acceleration_max = motion_ctrl_config.max_acceleration_profiler;
+    c.profiler_param.deceleration_max = motion_ctrl_config.max_deceleration_profiler;
+    c.profiler_param.torque_rate_max = motion_ctrl_config.max_torque_rate_profiler;
+    c.profiler_param.resolution = motion_ctrl_config.resolution;
+    c.profiler_param.jerk_max = motion_ctrl_config.max_jerk_profiler;
+    scurve_profiler_init(0.00, 0.00, c.scurve_profiler_state);
+    profile_table_init(0, 0, c.position_profile_table);
+
+    disturbance_observer_init(c.disturbance_observer);
+    disturbance_observer_set_parameters(motion_ctrl_config.moment_of_inertia, motion_ctrl_config.disturbance_observer_bandwidth,
+            CONTROL_PERIOD, c.disturbance_observer);
+    c.velocity_estimator_enabled = init_motion_velocity_estimator(motion_ctrl_config, c.velocity_estimator);
+
+    //one timer tick per microsecond
+    cyclic_interpolation_init(c.cyclic_targets, motion_ctrl_config.cyclic_interpolation, motion_ctrl_config.cyclic_master_period);
+
+    biquad_second_order_LP_filter_init(motion_ctrl_config.filter, CONTROL_PERIOD, c.torque_filter_param);
+    biquad_cascade_init(c.torque_filter_chain);
+    adaptive_notch_init(motion_ctrl_config.adaptive_notch_width, motion_ctrl_config.adaptive_notch_threshold, CONTROL_PERIOD, c.adaptive_notch_param);
+    adaptive_notch_set_mode(motion_ctrl_config.adaptive_notch, c.adaptive_notch_param);
+}
+
+/**
+ * @brief Switches the control mode like the enable calls of the motion control service,
+ *        the position control starts at the actual position.
+ */
+static void controller_enable(Mode mode, int position, Controller &c)
+{
+    MotionControlConfig &motion_ctrl_config = c.motion_ctrl_config;
+
+    if (mode == c.mode)
+        return;
+
+    c.position_profile_table_active = 0;
+    cyclic_interpolation_init(c.cyclic_targets, motion_ctrl_config.cyclic_interpolation, motion_ctrl_config.cyclic_master_period);
+    c.downstream_control_data.offset_torque = 0;
+
+    if (mode == MODE_POSITION)
+    {
+        c.downstream_control_data.position_cmd = position;
+        c.position_k = position;
+        c.position_ref_in_k_1n = position;
+        c.position_ref_in_k_2n = position;
+        scurve_profiler_init(position, 0.00, c.scurve_profiler_state);
+        pid_reset(c.position_control_pid_param);
+        disturbance_observer_reset(c.disturbance_observer);
+    }
+    else if (mode == MODE_VELOCITY)
+    {
+        c.downstream_control_data.velocity_cmd = 0;
+        pid_reset(c.velocity_control_pid_param);
+        disturbance_observer_reset(c.disturbance_observer);
+    }
+    else if (mode == MODE_TORQUE)
+    {
+        c.downstream_control_data.torque_cmd = 0;
+    }
+    c.mode = mode;
+}
+
+/**
+ * @brief Command of the master, queued for the interpolation in the cyclic synchronous modes like update_control_data().
+ */
+static void controller_command(int command, unsigned int time, Controller &c)
+{
+    if (c.mode == MODE_POSITION)
+        c.downstream_control_data.position_cmd = command;
+    else if (c.mode == MODE_VELOCITY)
+        c.downstream_control_data.velocity_cmd = command;
+    else if (c.mode == MODE_TORQUE)
+        c.downstream_control_data.torque_cmd = command;
+
+    if (c.motion_ctrl_config.cyclic_interpolation != CYCLIC_INTERPOLATION_NONE && c.mode != MODE_DISABLED)
+        cyclic_interpolation_push(c.cyclic_targets, command, time);
+}
+
+/**
+ * @brief One period of the control loop, in the order of motion_control_service().
+ *
+ * @param position, position of the sensor [ticks]
+ * @param velocity, velocity of the sensor [rpm]
+ * @param computed_torque, torque of the torque controller [mNm]
+ * @param time, time of the period and of the sensor reading [us]
+ *
+ * @return torque command [mNm]
+ */
+static int controller_update(int position, int velocity, int computed_torque, unsigned int time, Controller &c)
+{
+    MotionControlConfig &motion_ctrl_config = c.motion_ctrl_config;
+    int velocity_enable_flag = (c.mode == MODE_VELOCITY), position_enable_flag = (c.mode == MODE_POSITION);
+    int torque_ref_k = 0;
+    double load_torque_k, velocity_k;
+
+    if (c.velocity_estimator_enabled)
+        velocity = velocity_estimator_update(position, time, c.filter_output, velocity, c.velocity_estimator);
+
+    motion_control_gain_schedules(c.velocity_gain_schedule, c.position_gain_schedule,
+            velocity_enable_flag, position_enable_flag, motion_ctrl_config.position_control_strategy,
+            velocity, position, 0, motion_ctrl_config.polarity,
+            c.velocity_ref_in_k, c.position_ref_in_k, c.velocity_ref_k,
+            c.velocity_control_pid_param, c.position_control_pid_param);
+
+    c.velocity_ref_k = c.downstream_control_data.velocity_cmd;
+    velocity_k = velocity;
+
+    load_torque_k = disturbance_observer_update(computed_torque, velocity, c.disturbance_observer);
+
+    if (c.mode == MODE_TORQUE)
+    {
+        torque_ref_k = motion_control_torque_reference(c.downstream_control_data.torque_cmd, time,
+                motion_ctrl_config.enable_profiler, c.profiler_param, c.cyclic_targets, c.torque_ref_in_k_1n);
+    }
+    else if (c.mode == MODE_VELOCITY)
+    {
+        torque_ref_k = motion_control_velocity(c.velocity_ref_k, velocity_k, 0.00, time,
+                motion_ctrl_config.enable_profiler, c.profiler_param, c.cyclic_targets,
+                c.velocity_ref_in_k, c.velocity_ref_in_k_1n, c.velocity_control_pid_param);
+    }
+    else if (c.mode == MODE_POSITION)
+    {
+        c.position_ref_in_k = motion_control_position_reference(c.downstream_control_data.position_cmd, c.position_k, time,
+                motion_ctrl_config.enable_profiler, c.profiler_param, c.scurve_profiler_state,
+                c.position_profile_table, NULL, c.position_profile_table_active,
+                c.cyclic_targets, motion_ctrl_config.min_pos_range_limit, motion_ctrl_config.max_pos_range_limit,
+                c.position_ref_in_k_1n, c.position_ref_in_k_2n, c.position_ref_in_k_3n);
+        c.position_k_1 = c.position_k;
+        c.position_k = position;
+
+        if (motion_ctrl_config.position_control_strategy == POS_PID_CONTROLLER)
+        {
+            torque_ref_k = pid_update(c.position_ref_in_k, c.position_k, CONTROL_PERIOD, c.position_control_pid_param);
+        }
+        else
+        {
+            torque_ref_k = motion_control_cascaded_position(c.position_ref_in_k, c.position_ref_in_k_1n, c.position_ref_in_k_2n,
+                    c.position_ref_in_k_3n, c.position_k, velocity_k, motion_ctrl_config,
+                    c.position_control_pid_param, c.velocity_control_pid_param, c.velocity_ref_k);
+        }
+    }
+
+    //compensate the estimated load torque
+    if (velocity_enable_flag == 1 || position_enable_flag == 1)
+        torque_ref_k += load_torque_k;
+
+    torque_ref_k += (double)(c.downstream_control_data.offset_torque);
+
+    c.filter_output = motion_control_torque_output(torque_ref_k, motion_ctrl_config.max_torque, motion_ctrl_config.filter,
+            c.torque_filter_param, c.torque_filter_chain, c.torque_filter_chain_input, c.adaptive_notch_param);
+
+    return c.filter_output;
+}
+
+/**
+ * @brief Runs a scenario like run_simulation_scenario(), the targets change every millisecond.
+ *
+ * @return number of steps exceeding their error limit
+ */
+static int run_scenario(const char *name, const SimulationConfig &config, Step steps[], int n_steps)
+{
+    PlantModelState plant;
+    Controller c;
+    int target = 0, step_start_target = 0, command = 0, torque_cmd = 0, failures = 0;
+    long long ticks_total = 0;
+    double cost_total = 0, wall_start = now_ns();
+    int time_us = 0, next_tick = 0;
+
+    plant_model_init(config.plant, plant);
+    controller_init(config, c);
+
+    printf(">>   SIMULATION SCENARIO %s: %d steps\n", name, n_steps);
+    printf("step type           value  duration[ms]  max_error  rms_error  loop_cost_avg[ns]  loop_cost_max[ns]\n");
+
+    for (int s=0; s<n_steps; s++)
+    {
+        Step &step = steps[s];
+        int position = plant_model_get_position(plant);
+        int error = 0, error_max = 0, ticks = 0;
+        double error_square_sum = 0, cost, cost_sum = 0, cost_max = 0;
+
+        switch (step.type)
+        {
+        case STEP_POSITION:
+        case STEP_POSITION_RAMP:
+            if (c.mode != MODE_POSITION)
+            {
+                controller_enable(MODE_POSITION, position, c);
+                plant_model_set_brake(plant, 1);
+                target = position;
+            }
+            break;
+        case STEP_VELOCITY:
+        case STEP_VELOCITY_RAMP:
+            if (c.mode != MODE_VELOCITY)
+            {
+                controller_enable(MODE_VELOCITY, position, c);
+                plant_model_set_brake(plant, 1);
+                target = 0;
+            }
+            break;
+        case STEP_TORQUE:
+            if (c.mode != MODE_TORQUE)
+            {
+                controller_enable(MODE_TORQUE, position, c);
+                plant_model_set_brake(plant, 1);
+            }
+            break;
+        case STEP_BRAKE_RELEASE:
+            //close the brake and restart position control, which releases the brake again
+            controller_enable(MODE_DISABLED, position, c);
+            plant_model_set_brake(plant, 0);
+            controller_enable(MODE_POSITION, position, c);
+            plant_model_set_brake(plant, 1);
+            target = position;
+            break;
+        case STEP_LOAD_TORQUE:
+            plant_model_set_load_torque(plant, step.value);
+            break;
+        default:
+            break;
+        }
+
+        step_start_target = target;
+        if (step.type == STEP_REVERSAL)
+            target = -target;
+        else if (step.type == STEP_POSITION || step.type == STEP_VELOCITY || step.type == STEP_TORQUE)
+            target = step.value;
+
+        for (int k=1; k<=step.duration; k++)
+        {
+            if (step.type == STEP_POSITION_RAMP || step.type == STEP_VELOCITY_RAMP)
+                target = step_start_target + (int)((((long long)step.value - step_start_target) * k) / step.duration);
+            command = target;
+            controller_command(command, time_us, c);
+
+            //one millisecond of control ticks and plant integration
+            for (int end = time_us + 1000; time_us < end; time_us += CONTROL_PERIOD/PLANT_SUBSTEPS)
+            {
+                if (time_us >= next_tick)
+                {
+                    double start = now_ns();
+                    torque_cmd = controller_update(plant_model_get_position(plant), plant_model_get_velocity(plant),
+                            plant_model_get_torque(plant), time_us, c);
+                    cost = now_ns() - start;
+                    cost_sum += cost;
+                    if (cost > cost_max) cost_max = cost;
+                    ticks++;
+                    next_tick += CONTROL_PERIOD;
+                }
+                plant_model_update(plant, c.mode == MODE_DISABLED ? 0 : torque_cmd, CONTROL_PERIOD/PLANT_SUBSTEPS);
+            }
+
+            if (c.mode == MODE_POSITION)
+                error = command - plant_model_get_position(plant);
+            else if (c.mode == MODE_VELOCITY)
+                error = command - plant_model_get_velocity(plant);
+            else if (c.mode == MODE_TORQUE)
+                error = command - plant_model_get_torque(plant);
+            else
+                error = 0;
+
+            if (error < 0) error = -error;
+            if (error > error_max) error_max = error;
+            error_square_sum += ((double)error) * ((double)error);
+        }
+
+        cost_total += cost_sum;
+        ticks_total += ticks;
+
+        printf("%4d %-13s %7d %13d %10d %10d %18d %18d%s\n", s, step_names[step.type], step.value, step.duration,
+                error_max, (int)sqrt(error_square_sum/(double)(step.duration > 0 ? step.duration : 1)),
+                (int)(ticks > 0 ? cost_sum/ticks : 0), (int)cost_max,
+                (step.max_error > 0 && error_max > step.max_error) ? "  <- above limit" : "");
+        if (step.max_error > 0 && error_max > step.max_error)
+            failures++;
+    }
+
+    printf(">>   %.1f s simulated in %.3f s, control tick %.0f ns on average\n", time_us / 1.0e6,
+            (now_ns() - wall_start) / 1.0e9, ticks_total > 0 ? cost_total / ticks_total : 0.0);
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    int failures = 0;
+
+    if (argc < 2)
+    {
+        printf("usage: %s scenario_file...\n", argv[0]);
+        return 2;
+    }
+
+    for (int i=1; i<argc; i++)
+    {
+        SimulationConfig config = default_config();
+        Step steps[MAX_STEPS];
+        int n_steps = read_scenario(argv[i], config, steps);
+
+        if (n_steps < 0)
+            return 2;
+        failures += run_scenario(argv[i], config, steps, n_steps);
+    }
+
+    return failures > 0 ? 1 : 0;
+}
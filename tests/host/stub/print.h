@@ -0,0 +1,6 @@
+/**
+ * @file print.h
+ * @brief Host stand-in of the XMOS print.h, nothing of it is used by the host build
+ */
+
+#pragma once
@@ -0,0 +1,25 @@
+/**
+ * @file xccompat.h
+ * @brief Host stand-in of the XMOS xccompat.h. XC references are passed as pointers in C,
+ *        the host tests are C++ and call the XC sources with references, like XC does.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+#define REFERENCE_PARAM(type, name) type &name
+#define NULLABLE_REFERENCE_PARAM(type, name) type *name
+#else
+#define REFERENCE_PARAM(type, name) type *name
+#define NULLABLE_REFERENCE_PARAM(type, name) type *name
+#endif
+
+#define NULLABLE_ARRAY_OF(type, name) type *name
+#define CLIENT_INTERFACE(type, name) unsigned name
+#define SERVER_INTERFACE(type, name) unsigned name
+#define CHANEND_PARAM(type, name) unsigned name
+#define streaming_chanend unsigned
+
+typedef unsigned chanend;
+typedef unsigned port;
+typedef unsigned timer;
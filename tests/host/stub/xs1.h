@@ -0,0 +1,6 @@
+/**
+ * @file xs1.h
+ * @brief Host stand-in of the XMOS xs1.h, nothing of it is used by the host build
+ */
+
+#pragma once
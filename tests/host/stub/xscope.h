@@ -0,0 +1,6 @@
+/**
+ * @file xscope.h
+ * @brief Host stand-in of the XMOS xscope.h, nothing of it is used by the host build
+ */
+
+#pragma once
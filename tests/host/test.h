@@ -0,0 +1,62 @@
+/**
+ * @file test.h
+ * @brief Checks and timing of the host tests and benchmarks
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <time.h>
+
+static int test_failures = 0;
+
+/**
+ * @brief Counts and prints a failed check, the test goes on.
+ */
+#define CHECK(condition, ...) do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #condition); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            test_failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Prints the result of a test, to be returned from main().
+ */
+static inline int test_result(const char *name)
+{
+    printf("%s: %s\n", name, test_failures == 0 ? "passed" : "FAILED");
+    return test_failures == 0 ? 0 : 1;
+}
+
+static inline double test_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec) * 1.0e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Deterministic pseudo random numbers, the tests are repeatable.
+ */
+static inline unsigned test_random(unsigned &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * @brief Pseudo random integer in [min, max].
+ */
+static inline int test_random_range(unsigned &state, int min, int max)
+{
+    return min + (int)(test_random(state) % (unsigned)(max - min + 1));
+}
+
+/**
+ * @brief Keeps a computed value alive so the benchmarked code is not optimized away.
+ */
+static volatile double bench_sink;
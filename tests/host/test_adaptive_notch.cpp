@@ -0,0 +1,162 @@
+/**
+ * @file test_adaptive_notch.cpp
+ * @brief Adaptive notch in the torque reference of a velocity loop on a two-mass plant whose resonance
+ *        drifts from 600 Hz to 800 Hz: the notch must lock within a second, follow the drift and keep
+ *        the torque at the noise floor, also once frozen. Without the notch the loop oscillates.
+ *        The notch only adapts while the signal above ADAPTIVE_NOTCH_MIN_FREQUENCY exceeds the threshold:
+ *        with the velocity noise of a 14 bit encoder differentiated at 3 kHz (about 11 rpm) it follows
+ *        the drift closely, with little noise it holds until the resonance shows up again.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <adaptive_notch.h>
+}
+
+#define T_S                 333
+#define MOTOR_INERTIA       1.0e-4      //[kg m^2]
+#define LOAD_INERTIA        2.0e-4      //[kg m^2]
+#define DAMPING_RATIO       0.02        //of the resonance
+#define KP                  8.3         //[mNm/rpm], 42 Hz bandwidth
+#define KI                  0.174       //[mNm/rpm per period], integrator corner at 10 Hz
+#define TORQUE_LIMIT        3000        //[mNm]
+#define VELOCITY            100         //[rpm]
+#define NOTCH_WIDTH         100         //[Hz]
+#define NOTCH_THRESHOLD     30          //[mNm]
+#define START_FREQUENCY     600.0       //[Hz]
+#define END_FREQUENCY       800.0       //[Hz]
+#define DRIFT_TIME          8.0         //[s]
+#define FROZEN_TIME         2.0         //[s]
+#define LOCK_TOLERANCE      50          //[Hz]
+#define SUBSTEPS            32
+#define TWO_PI              6.28318530718
+
+struct Result {
+    double lock_time;           //first time the notch is within LOCK_TOLERANCE of the resonance [s]
+    double max_tracking_error;  //largest distance of the notch to the resonance one second after the start [Hz]
+    double torque_drift;        //rms of the torque reference above 100 Hz during the drift, after one second [mNm]
+    double torque_frozen;       //the same while frozen [mNm]
+    int frozen_frequency_change;
+};
+
+/**
+ * @brief Velocity PI at 3 kHz, the torque acts one period later on the motor, which is coupled to the
+ *        load by a spring. The stiffness follows the resonance frequency.
+ */
+static Result run(int mode, double noise)
+{
+    AdaptiveNotchParam notch;
+    Result result = { -1, 0, 0, 0, 0 };
+    unsigned seed = 21;
+    double motor = 0, load = 0, twist = 0, integral = 0, torque_1n = 0, low_pass = 0;
+    double sum_drift = 0, sum_frozen = 0, h = (T_S / 1000000.00) / SUBSTEPS;
+    double low_pass_alpha = (TWO_PI * 100 * (T_S / 1000000.00)) / (1.00 + (TWO_PI * 100 * (T_S / 1000000.00)));
+    int n_drift = 0, n_frozen = 0, frozen_frequency = 0;
+    int n_periods = (int)((DRIFT_TIME + FROZEN_TIME) / (T_S / 1000000.00));
+
+    adaptive_notch_init(NOTCH_WIDTH, NOTCH_THRESHOLD, T_S, notch);
+    adaptive_notch_set_mode(mode, notch);
+
+    for (int k=0; k<n_periods; k++)
+    {
+        double t = k * (T_S / 1000000.00);
+        double resonance = t < DRIFT_TIME ? START_FREQUENCY + (END_FREQUENCY - START_FREQUENCY) * (t / DRIFT_TIME) : END_FREQUENCY;
+        //resonance of the two masses: w^2 = stiffness * (1/J_motor + 1/J_load)
+        double stiffness = (TWO_PI * resonance) * (TWO_PI * resonance) / ((1.00 / MOTOR_INERTIA) + (1.00 / LOAD_INERTIA));
+        double damping = 2.00 * DAMPING_RATIO * sqrt(stiffness / ((1.00 / MOTOR_INERTIA) + (1.00 / LOAD_INERTIA)));
+        double velocity = motor * 60.00 / TWO_PI + noise * (test_random_range(seed, -1000, 1000) / 1000.00);
+        double error = VELOCITY - (int)lround(velocity);
+        double torque, high_pass;
+
+        integral += KI * error;
+        if (integral > TORQUE_LIMIT) integral = TORQUE_LIMIT;
+        if (integral < -TORQUE_LIMIT) integral = -TORQUE_LIMIT;
+        torque = (KP * error) + integral;
+        if (torque > TORQUE_LIMIT) torque = TORQUE_LIMIT;
+        if (torque < -TORQUE_LIMIT) torque = -TORQUE_LIMIT;
+        torque = adaptive_notch_update((int)lround(torque), notch);
+
+        if (mode == ADAPTIVE_NOTCH_LEARNING && t >= DRIFT_TIME && notch.mode == ADAPTIVE_NOTCH_LEARNING)
+        {
+            adaptive_notch_set_mode(ADAPTIVE_NOTCH_FROZEN, notch);
+            frozen_frequency = adaptive_notch_frequency(notch);
+        }
+
+        //torque reference above 100 Hz
+        low_pass += low_pass_alpha * (torque - low_pass);
+        high_pass = torque - low_pass;
+        if (t >= 1.00 && t < DRIFT_TIME)
+        {
+            sum_drift += high_pass * high_pass;
+            n_drift++;
+        }
+        else if (t >= DRIFT_TIME)
+        {
+            sum_frozen += high_pass * high_pass;
+            n_frozen++;
+        }
+
+        if (mode != ADAPTIVE_NOTCH_OFF && t < DRIFT_TIME)
+        {
+            double distance = fabs(adaptive_notch_frequency(notch) - resonance);
+
+            if (result.lock_time < 0 && distance < LOCK_TOLERANCE)
+                result.lock_time = t;
+            if (t >= 1.00 && distance > result.max_tracking_error)
+                result.max_tracking_error = distance;
+        }
+
+        for (int i=0; i<SUBSTEPS; i++)
+        {
+            double coupling = (stiffness * twist) + (damping * (motor - load));
+
+            motor += (((torque_1n / 1000.00) - coupling) / MOTOR_INERTIA) * h;
+            load += (coupling / LOAD_INERTIA) * h;
+            twist += (motor - load) * h;
+        }
+        torque_1n = torque;
+    }
+
+    if (mode == ADAPTIVE_NOTCH_LEARNING)
+        result.frozen_frequency_change = adaptive_notch_frequency(notch) - frozen_frequency;
+    result.torque_drift = sqrt(sum_drift / n_drift);
+    result.torque_frozen = sqrt(sum_frozen / n_frozen);
+    return result;
+}
+
+/**
+ * @brief max_tracking_error < 0 skips the check of the tracking.
+ */
+static void test_noise(double noise, double max_tracking_error)
+{
+    Result off = run(ADAPTIVE_NOTCH_OFF, noise);
+    Result learning = run(ADAPTIVE_NOTCH_LEARNING, noise);
+
+    printf("  velocity noise %4.1f rpm, without notch: torque above 100 Hz %7.1f mNm rms\n", noise, off.torque_drift);
+    printf("    adaptive notch: locked after %.3f s, max tracking error %5.1f Hz, torque above 100 Hz %5.1f mNm rms\n",
+            learning.lock_time, learning.max_tracking_error, learning.torque_drift);
+    printf("    frozen notch  : torque above 100 Hz %5.1f mNm rms, frequency change %d Hz\n",
+            learning.torque_frozen, learning.frozen_frequency_change);
+
+    CHECK(off.torque_drift > 1000, "no oscillation without the notch: %.1f mNm", off.torque_drift);
+    CHECK(learning.lock_time >= 0 && learning.lock_time < 1.00, "lock time %.3f s", learning.lock_time);
+    if (max_tracking_error > 0)
+        CHECK(learning.max_tracking_error < max_tracking_error, "tracking error %.1f Hz", learning.max_tracking_error);
+    CHECK(learning.torque_drift * 20 < off.torque_drift, "torque %.1f mNm with the notch", learning.torque_drift);
+    CHECK(learning.torque_frozen < 1.5 * learning.torque_drift, "torque %.1f mNm frozen", learning.torque_frozen);
+    CHECK(learning.frozen_frequency_change == 0, "frozen notch moved by %d Hz", learning.frozen_frequency_change);
+}
+
+int main(void)
+{
+    printf("test_adaptive_notch, resonance drifting from %.0f to %.0f Hz in %.0f s, notch %d Hz wide\n",
+            START_FREQUENCY, END_FREQUENCY, DRIFT_TIME, NOTCH_WIDTH);
+
+    test_noise(10.0, 30);
+    test_noise(1.0, -1);
+
+    return test_result("test_adaptive_notch");
+}
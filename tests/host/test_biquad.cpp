@@ -0,0 +1,140 @@
+/**
+ * @file test_biquad.cpp
+ * @brief Frequency response of the fixed-point biquad low pass filters against the double
+ *        filters of filters.xc they replace, including the factoring of the third order filter
+ *        into a first and a second order section.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <complex>
+#include "test.h"
+
+extern "C" {
+#include <filters.h>
+#include <biquad.h>
+}
+
+#define T_S             333
+#define AMPLITUDE       20000.00
+#define TWO_PI          6.28318530718
+
+typedef std::complex<double> Complex;
+
+/**
+ * @brief Gain of a filter at one frequency, from the correlation of the output with the input
+ *        over whole periods after the transient.
+ */
+template <typename Filter> static Complex measure_response(Filter filter, double f)
+{
+    double fs = 1000000.00 / T_S;
+    int period = (int)ceil(fs / f);
+    int settle = 20 * period > 6000 ? 20 * period : 6000;
+    int n = 10 * period;
+    double phase_step = TWO_PI * f / fs;
+    Complex sum = 0;
+    int k;
+
+    for (k=0; k<settle; k++)
+        filter(AMPLITUDE * sin(phase_step * k));
+
+    //round the measurement to whole periods of the frequency
+    n = (int)(floor((n * f) / fs) * fs / f + 0.5);
+    for (int i=0; i<n; i++, k++)
+    {
+        double y = filter(AMPLITUDE * sin(phase_step * k));
+        sum += y * Complex(sin(phase_step * k), cos(phase_step * k));
+    }
+
+    return sum * (2.00 / (n * AMPLITUDE));
+}
+
+static double db(Complex h)
+{
+    return 20.00 * log10(abs(h));
+}
+
+/**
+ * @brief Compares the responses and prints them, the difference must be below 0.05 dB and 0.5 degree
+ *        where the gain is above -40 dB and below 1e-3 of the input where the gain is lower.
+ */
+static void compare(const char *name, int f_c, Complex h_double, Complex h_biquad, double f)
+{
+    double phase_difference = fabs(arg(h_biquad / h_double)) * 360.00 / TWO_PI;
+
+    printf("  %-12s f_c %4d Hz  f %7.1f Hz  double %7.2f dB %7.1f deg  biquad %7.2f dB %7.1f deg\n", name, f_c, f,
+            db(h_double), arg(h_double) * 360.00 / TWO_PI, db(h_biquad), arg(h_biquad) * 360.00 / TWO_PI);
+
+    if (db(h_double) > -40.00)
+    {
+        CHECK(fabs(db(h_biquad) - db(h_double)) < 0.05, "%s f_c %d at %.1f Hz: %.3f dB", name, f_c, f, db(h_biquad) - db(h_double));
+        CHECK(phase_difference < 0.50, "%s f_c %d at %.1f Hz: %.2f deg", name, f_c, f, phase_difference);
+    }
+    else
+        CHECK(abs(h_biquad - h_double) < 1.0e-3, "%s f_c %d at %.1f Hz: %g", name, f_c, f, abs(h_biquad - h_double));
+}
+
+static const double frequencies[] = { 5, 10, 20, 50, 100, 200, 300, 500, 700, 1000, 1300, 1450 };
+
+int main(void)
+{
+    const int cutoffs[] = { 20, 100, 300, 1000 };
+
+    printf("test_biquad\n");
+
+    for (unsigned c=0; c<sizeof(cutoffs)/sizeof(cutoffs[0]); c++)
+    {
+        int f_c = cutoffs[c];
+
+        for (unsigned i=0; i<sizeof(frequencies)/sizeof(frequencies[0]); i++)
+        {
+            double f = frequencies[i];
+            FirstOrderLPfilterParam first;
+            SecondOrderLPfilterParam second;
+            ThirdOrderLPfilterParam third;
+            BiquadFilterParam biquad;
+            BiquadCascadeParam cascade;
+            Complex h_double, h_biquad;
+
+            first_order_LP_filter_init(f_c, T_S, first);
+            biquad_first_order_LP_filter_init(f_c, T_S, biquad);
+            h_double = measure_response([&](double x) { return first_order_LP_filter_update(&x, first); }, f);
+            h_biquad = measure_response([&](double x) { return (double)biquad_update((int)lround(x), biquad); }, f);
+            compare("first order", f_c, h_double, h_biquad, f);
+
+            second_order_LP_filter_init(f_c, T_S, second);
+            biquad_second_order_LP_filter_init(f_c, T_S, biquad);
+            h_double = measure_response([&](double x) { return second_order_LP_filter_update(&x, second); }, f);
+            h_biquad = measure_response([&](double x) { return (double)biquad_update((int)lround(x), biquad); }, f);
+            compare("second order", f_c, h_double, h_biquad, f);
+
+            third_order_LP_filter_init(f_c, T_S, third);
+            biquad_third_order_LP_filter_init(f_c, T_S, cascade);
+            h_double = measure_response([&](double x) { return third_order_LP_filter_update(&x, third); }, f);
+            h_biquad = measure_response([&](double x) { return (double)biquad_cascade_update((int)lround(x), cascade); }, f);
+            compare("third order", f_c, h_double, h_biquad, f);
+        }
+    }
+
+    //the step responses agree within 0.2% of the step
+    for (unsigned c=0; c<sizeof(cutoffs)/sizeof(cutoffs[0]); c++)
+    {
+        ThirdOrderLPfilterParam third;
+        BiquadCascadeParam cascade;
+        double max_difference = 0;
+
+        third_order_LP_filter_init(cutoffs[c], T_S, third);
+        biquad_third_order_LP_filter_init(cutoffs[c], T_S, cascade);
+        for (int k=0; k<3000; k++)
+        {
+            double x = 1000.00;
+            double difference = fabs(third_order_LP_filter_update(&x, third) - biquad_cascade_update(1000, cascade));
+            if (difference > max_difference)
+                max_difference = difference;
+        }
+        printf("  third order  f_c %4d Hz  step 1000: max difference %.3f\n", cutoffs[c], max_difference);
+        CHECK(max_difference <= 2.00, "f_c %d: %.3f", cutoffs[c], max_difference);
+    }
+
+    return test_result("test_biquad");
+}
@@ -0,0 +1,115 @@
+/**
+ * @file test_cyclic_interpolation.cpp
+ * @brief Interpolation of the targets of a master whose cycles arrive with jitter, against the
+ *        trajectory of the master delayed by the interpolation. The trace crosses the overflow of
+ *        the timer and the master drops a cycle once.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <cyclic_interpolation.h>
+}
+
+#define USEC            100                 //timer ticks per microsecond
+#define MASTER_PERIOD   (1000 * USEC)       //cycle time of the master [timer ticks]
+#define LOOP_PERIOD     (250 * USEC)        //period of the control loop [timer ticks]
+#define JITTER          (200 * USEC)        //arrival jitter of the targets, +- [timer ticks]
+#define N_CYCLES        4000
+#define DROPPED_CYCLE   2500
+#define START_TIME      (4294967296.00 - 1000.00 * MASTER_PERIOD)   //the timer overflows after 1000 cycles
+#define TWO_PI          6.28318530718
+
+static double trajectory(double t)
+{
+    return 200000.00 * sin(TWO_PI * 1.50 * t / (1.0e6 * USEC));
+}
+
+struct Result {
+    double rms;
+    double max;
+    double max_acceleration;        //largest second difference of the output [ticks per loop period^2]
+};
+
+static Result run(int mode)
+{
+    CyclicInterpolator interpolator;
+    unsigned seed = 11;
+    double square_sum = 0, max = 0, max_acceleration = 0;
+    double delay = mode == CYCLIC_INTERPOLATION_NONE ? 0 : (mode * MASTER_PERIOD) + (MASTER_PERIOD / 2);
+    double next_arrival = 0;
+    int cycle = 0, n = 0, output_1 = 0, output_2 = 0;
+
+    cyclic_interpolation_init(interpolator, mode, MASTER_PERIOD);
+
+    for (double t = 0; t < N_CYCLES * (double)MASTER_PERIOD; t += LOOP_PERIOD)
+    {
+        //targets of the master cycles which arrived until now
+        while (next_arrival <= t)
+        {
+            if (cycle != DROPPED_CYCLE)
+                cyclic_interpolation_push(interpolator, (int)lround(trajectory(cycle * (double)MASTER_PERIOD)),
+                        (unsigned int)(unsigned long long)(START_TIME + next_arrival));
+            cycle++;
+            next_arrival = cycle * (double)MASTER_PERIOD + test_random_range(seed, -JITTER, JITTER);
+        }
+
+        int output = cyclic_interpolation_get(interpolator, (unsigned int)(unsigned long long)(START_TIME + t));
+
+        //after the start and away from the dropped cycle
+        if (t > 10.0 * MASTER_PERIOD && fabs(t - DROPPED_CYCLE * (double)MASTER_PERIOD) > 5.0 * MASTER_PERIOD)
+        {
+            double error = output - trajectory(t - delay);
+            double acceleration = fabs((double)output - 2.0 * output_1 + output_2);
+
+            square_sum += error * error;
+            n++;
+            if (fabs(error) > max)
+                max = fabs(error);
+            if (acceleration > max_acceleration)
+                max_acceleration = acceleration;
+        }
+        output_2 = output_1;
+        output_1 = output;
+    }
+
+    Result result = { sqrt(square_sum / n), max, max_acceleration };
+    return result;
+}
+
+int main(void)
+{
+    const char *names[] = { "none", "linear", "cubic" };
+    Result results[3];
+    CyclicInterpolator interpolator;
+
+    printf("test_cyclic_interpolation, jitter +-%d%% of the master cycle\n", (100 * JITTER) / MASTER_PERIOD);
+
+    for (int mode = CYCLIC_INTERPOLATION_NONE; mode <= CYCLIC_INTERPOLATION_CUBIC; mode++)
+    {
+        results[mode] = run(mode);
+        printf("  %-6s error to the delayed trajectory: rms %7.1f ticks, max %7.1f ticks, largest acceleration step %7.1f ticks\n",
+                names[mode], results[mode].rms, results[mode].max, results[mode].max_acceleration);
+    }
+
+    //the interpolated targets follow the trajectory and remove the steps of the master cycles
+    CHECK(results[CYCLIC_INTERPOLATION_LINEAR].rms < 0.10 * results[CYCLIC_INTERPOLATION_NONE].rms, "linear rms %.1f", results[CYCLIC_INTERPOLATION_LINEAR].rms);
+    CHECK(results[CYCLIC_INTERPOLATION_CUBIC].rms < 0.10 * results[CYCLIC_INTERPOLATION_NONE].rms, "cubic rms %.1f", results[CYCLIC_INTERPOLATION_CUBIC].rms);
+    CHECK(results[CYCLIC_INTERPOLATION_LINEAR].max_acceleration < 0.25 * results[CYCLIC_INTERPOLATION_NONE].max_acceleration,
+            "linear acceleration %.1f", results[CYCLIC_INTERPOLATION_LINEAR].max_acceleration);
+    CHECK(results[CYCLIC_INTERPOLATION_CUBIC].max_acceleration < results[CYCLIC_INTERPOLATION_LINEAR].max_acceleration,
+            "cubic acceleration %.1f", results[CYCLIC_INTERPOLATION_CUBIC].max_acceleration);
+
+    //the difference of the targets does not fit into an int
+    cyclic_interpolation_init(interpolator, CYCLIC_INTERPOLATION_LINEAR, MASTER_PERIOD);
+    cyclic_interpolation_push(interpolator, -2000000000, 0);
+    cyclic_interpolation_push(interpolator, 2000000000, MASTER_PERIOD);
+    //half a cycle after the first target plus the delay of 1.5 cycles
+    int middle = cyclic_interpolation_get(interpolator, MASTER_PERIOD / 2 + MASTER_PERIOD + MASTER_PERIOD / 2);
+    printf("  linear between -2000000000 and 2000000000 at half the cycle: %d\n", middle);
+    CHECK(middle == 0, "%d", middle);
+
+    return test_result("test_cyclic_interpolation");
+}
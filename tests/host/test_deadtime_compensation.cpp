@@ -0,0 +1,241 @@
+/**
+ * @file test_deadtime_compensation.cpp
+ * @brief Dead-time compensation of the pulse widths with the phase voltages as sign of the phase currents, as
+ *        the PWM service passes them: full at low modulation depth, faded out linearly between
+ *        DEADTIME_COMP_FADE_START and DEADTIME_COMP_FADE_END, off above.
+ *        A model of the power stage converts the port data back into the average phase voltages: the FETs
+ *        follow the port patterns tick by tick, while both are off the diodes clamp the phase according to
+ *        the sign of the current of a star-connected RL motor. The voltage error and the current distortion
+ *        must drop with the compensation.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <pwm_convert_width.h>
+}
+
+#define PWM_MAX_VALUE   16384
+#define PWM_DEADTIME    1500
+#define WIDTH           750         //3000 ns at 250 ticks/us
+#define BAND            (3 * 62)    //250 ns at 250 ticks/us, in units of the phase voltages
+#define VDC             48.0        //[V]
+#define PWM_FREQUENCY   (250.0e6 / PWM_MAX_VALUE)
+#define CYCLE_PERIODS   3052        //PWM periods per electrical cycle, about 5 Hz
+#define N_HARMONICS     20
+#define TWO_PI          6.28318530718
+
+/**
+ * @brief Width of a mid-range pulse of the high leg from its port data.
+ */
+static int hi_width(const PWM_BUFFER_TYP &buffer, int phase)
+{
+    return buffer.fall_edg.phase_data[phase].hi.time_off - buffer.rise_edg.phase_data[phase].hi.time_off;
+}
+
+/**
+ * @brief Phase A at amplitude above the mean, B and C at half of it below. Returns the compensation of phase A,
+ *        B and C must be compensated by the same width in the other direction.
+ */
+static int compensation(int amplitude)
+{
+    PWM_COMMS_TYP comms;
+    PWM_BUFFER_TYP buffer;
+    int sum;
+
+    init_deadtime_compensation(comms, WIDTH, BAND, PWM_MAX_VALUE);
+    comms.params.widths[0] = (PWM_MAX_VALUE / 2) + amplitude;
+    comms.params.widths[1] = (PWM_MAX_VALUE / 2) - (amplitude / 2);
+    comms.params.widths[2] = (PWM_MAX_VALUE / 2) - (amplitude / 2);
+    sum = comms.params.widths[0] + comms.params.widths[1] + comms.params.widths[2];
+    for (int i=0; i<_NUM_PWM_PHASES; i++)
+        comms.params.currents[i] = 3 * (int)comms.params.widths[i] - sum;
+
+    convert_all_pulse_widths(comms, buffer, PWM_MAX_VALUE, PWM_DEADTIME);
+
+    for (int i=1; i<_NUM_PWM_PHASES; i++)
+    {
+        int other = hi_width(buffer, i) - (int)comms.params.widths[i];
+        CHECK(other == -(hi_width(buffer, 0) - (int)comms.params.widths[0]), "amplitude %d: phase %d compensated by %d", amplitude, i, other);
+    }
+
+    return hi_width(buffer, 0) - (int)comms.params.widths[0];
+}
+
+static void test_fade_out(void)
+{
+    const int amplitudes[] = { 500, 1000, 2048, 2500, 3072, 3500, 4096, 6000 };
+
+    for (unsigned i=0; i<sizeof(amplitudes)/sizeof(amplitudes[0]); i++)
+    {
+        double depth = (100.00 * amplitudes[i]) / (PWM_MAX_VALUE / 2);
+        double fade = (DEADTIME_COMP_FADE_END - depth) / (DEADTIME_COMP_FADE_END - DEADTIME_COMP_FADE_START);
+        int expected = (int)lround(WIDTH * (fade > 1 ? 1 : (fade < 0 ? 0 : fade)));
+        int width = compensation(amplitudes[i]);
+
+        printf("  modulation depth %5.1f%%: compensation %4d ticks, expected %4d\n", depth, width, expected);
+        CHECK(abs(width - expected) <= 2, "depth %.1f%%: compensation %d, expected %d", depth, width, expected);
+    }
+}
+
+/**
+ * @brief Output of a buffered 1 bit port at tick t of the PWM period (0 is the reference time). The patterns
+ *        are shifted out LSB first from their time offsets on, the last bit is held. A later output replaces
+ *        an earlier one.
+ */
+static int port_value(const PWM_PORT_TYP &rise, const PWM_PORT_TYP &fall, int t)
+{
+    if (t >= fall.time_off)
+        return t < fall.time_off + _PWM_PORT_WID ? (fall.pattern >> (t - fall.time_off)) & 1 : fall.pattern >> 31;
+    if (t >= rise.time_off)
+        return t < rise.time_off + _PWM_PORT_WID ? (rise.pattern >> (t - rise.time_off)) & 1 : rise.pattern >> 31;
+    return fall.pattern >> 31;
+}
+
+/**
+ * @brief Switch states of one phase over a PWM period. The high leg port switches the high-side FET on, the
+ *        low leg port switches the low-side FET off. The states only change at the bits of the patterns.
+ */
+static void switch_times(const PWM_PHASE_TYP &rise, const PWM_PHASE_TYP &fall,
+        int &high_side_ticks, int &freewheeling_ticks, int &shoot_through_ticks)
+{
+    int points[4 * (_PWM_PORT_WID + 1) + 2];
+    const PWM_PORT_TYP *ports[4] = { &rise.hi, &fall.hi, &rise.lo, &fall.lo };
+    int n = 0, half = PWM_MAX_VALUE / 2;
+
+    points[n++] = -half;
+    for (int p=0; p<4; p++)
+        for (int k=0; k<=_PWM_PORT_WID; k++)
+            if (ports[p]->time_off + k > -half && ports[p]->time_off + k < half)
+                points[n++] = ports[p]->time_off + k;
+    std::sort(points, points + n);
+    n = std::unique(points, points + n) - points;
+    points[n] = half;
+
+    high_side_ticks = freewheeling_ticks = shoot_through_ticks = 0;
+    for (int j=0; j<n; j++)
+    {
+        int high = port_value(rise.hi, fall.hi, points[j]);
+        int low_off = port_value(rise.lo, fall.lo, points[j]);
+        int ticks = points[j+1] - points[j];
+
+        if (high && low_off) high_side_ticks += ticks;
+        else if (high) shoot_through_ticks += ticks;
+        else if (low_off) freewheeling_ticks += ticks;
+    }
+}
+
+struct Distortion {
+    double voltage_error;       //rms error of the average phase voltage [V]
+    double thd;                 //total harmonic distortion of the phase current [%]
+};
+
+/**
+ * @brief Open loop sine modulation at about 5 Hz of a star-connected RL motor, one cycle to settle and one
+ *        measured. The widths are converted with pwm_convert_width.c as in the PWM service.
+ */
+static Distortion run_motor(double resistance, double inductance, double amplitude, int compensate)
+{
+    PWM_COMMS_TYP comms;
+    PWM_BUFFER_TYP buffer;
+    double current[_NUM_PWM_PHASES] = { 0, 0, 0 };
+    double error_sum = 0, harmonic_re[N_HARMONICS + 1] = { 0 }, harmonic_im[N_HARMONICS + 1] = { 0 };
+    double harmonics = 0;
+    int width = (int)lround(amplitude * PWM_MAX_VALUE / VDC);
+    Distortion distortion;
+
+    init_deadtime_compensation(comms, compensate ? WIDTH : 0, BAND, PWM_MAX_VALUE);
+
+    for (int k=0; k<2 * CYCLE_PERIODS; k++)
+    {
+        double angle = (TWO_PI * k) / CYCLE_PERIODS;
+        double pole[_NUM_PWM_PHASES], commanded[_NUM_PWM_PHASES], pole_mean = 0, commanded_mean = 0;
+        int sum = 0;
+
+        for (int i=0; i<_NUM_PWM_PHASES; i++)
+        {
+            comms.params.widths[i] = (PWM_MAX_VALUE / 2) + (int)lround(width * sin(angle - (i * TWO_PI) / 3));
+            sum += comms.params.widths[i];
+        }
+        for (int i=0; i<_NUM_PWM_PHASES; i++)
+            comms.params.currents[i] = 3 * (int)comms.params.widths[i] - sum;
+
+        convert_all_pulse_widths(comms, buffer, PWM_MAX_VALUE, PWM_DEADTIME);
+
+        for (int i=0; i<_NUM_PWM_PHASES; i++)
+        {
+            int high_side, freewheeling, shoot_through;
+
+            switch_times(buffer.rise_edg.phase_data[i], buffer.fall_edg.phase_data[i], high_side, freewheeling, shoot_through);
+            CHECK(shoot_through == 0, "phase %d: shoot-through for %d ticks", i, shoot_through);
+
+            pole[i] = (VDC * (high_side + (current[i] < 0 ? freewheeling : 0))) / PWM_MAX_VALUE;
+            commanded[i] = (VDC * (int)comms.params.widths[i]) / PWM_MAX_VALUE;
+            pole_mean += pole[i] / _NUM_PWM_PHASES;
+            commanded_mean += commanded[i] / _NUM_PWM_PHASES;
+        }
+
+        for (int i=0; i<_NUM_PWM_PHASES; i++)
+        {
+            double voltage = pole[i] - pole_mean;
+
+            if (k >= CYCLE_PERIODS)
+                error_sum += (voltage - (commanded[i] - commanded_mean)) * (voltage - (commanded[i] - commanded_mean));
+            current[i] += ((voltage - (resistance * current[i])) / inductance) / PWM_FREQUENCY;
+        }
+
+        if (k >= CYCLE_PERIODS)
+            for (int h=1; h<=N_HARMONICS; h++)
+            {
+                harmonic_re[h] += current[0] * cos(h * angle);
+                harmonic_im[h] += current[0] * sin(h * angle);
+            }
+    }
+
+    for (int h=2; h<=N_HARMONICS; h++)
+        harmonics += harmonic_re[h] * harmonic_re[h] + harmonic_im[h] * harmonic_im[h];
+    distortion.voltage_error = sqrt(error_sum / (_NUM_PWM_PHASES * CYCLE_PERIODS));
+    distortion.thd = 100.00 * sqrt(harmonics / (harmonic_re[1] * harmonic_re[1] + harmonic_im[1] * harmonic_im[1]));
+    return distortion;
+}
+
+/**
+ * @brief Voltage error and current distortion without and with the compensation. Below the fade-out both
+ *        must drop, above DEADTIME_COMP_FADE_END the conversion is the same as without the compensation.
+ *        The remaining error comes mostly from the zero crossing band, which is wide at small phase voltages.
+ */
+static void test_distortion(double resistance, double inductance, double current, double min_voltage_reduction, double min_thd_reduction)
+{
+    double amplitude = resistance * current;
+    double depth = (100.00 * amplitude) / (VDC / 2);
+    Distortion off = run_motor(resistance, inductance, amplitude, 0);
+    Distortion on = run_motor(resistance, inductance, amplitude, 1);
+
+    printf("  %.1f ohm %.1f mH %4.1f A (depth %4.1f%%): voltage error %.3f -> %.3f V, current THD %6.2f -> %5.2f%%\n",
+            resistance, inductance * 1000, current, depth, off.voltage_error, on.voltage_error, off.thd, on.thd);
+    if (min_voltage_reduction > 0)
+    {
+        CHECK(on.voltage_error * min_voltage_reduction < off.voltage_error, "%.1f A: voltage error %.3f, %.3f without compensation", current, on.voltage_error, off.voltage_error);
+        CHECK(on.thd * min_thd_reduction < off.thd, "%.1f A: THD %.2f%%, %.2f%% without compensation", current, on.thd, off.thd);
+    }
+    else
+        CHECK(on.voltage_error == off.voltage_error, "%.1f A above the fade-out: voltage error %.3f, %.3f without compensation", current, on.voltage_error, off.voltage_error);
+}
+
+int main(void)
+{
+    printf("test_deadtime_compensation, width %d ticks, fade-out from %d%% to %d%% modulation depth\n",
+            WIDTH, DEADTIME_COMP_FADE_START, DEADTIME_COMP_FADE_END);
+
+    test_fade_out();
+    test_distortion(1.0, 1.0e-3, 1.0, 4, 1.5);
+    test_distortion(1.0, 1.0e-3, 3.0, 5, 10);
+    test_distortion(0.3, 0.3e-3, 3.0, 3.5, 3);
+    test_distortion(1.0, 1.0e-3, 15.0, 0, 0);
+
+    return test_result("test_deadtime_compensation");
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_disturbance_observer.cpp
+ * @brief Load torque disturbance observer of motion_control_service() in a velocity loop on the plant
+ *        model: with a load torque step and a sinusoidal load the peak velocity error must drop against
+ *        the same loop without the observer, and the estimate must settle at the load plus the friction.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <plant_model.h>
+#include <controllers.h>
+}
+
+#define PERIOD              333         //[us]
+#define PLANT_SUBSTEPS      9
+#define INERTIA             200         //[g cm^2]
+#define VELOCITY_KP         1300000     //about 100 Hz bandwidth
+#define VELOCITY_KI         70000
+#define INTEGRAL_LIMIT      1000
+#define MAX_TORQUE          1000        //[mNm]
+#define VELOCITY            1000        //[rpm]
+#define NOISE               1           //velocity noise [rpm]
+#define LOAD_STEP           200         //[mNm]
+#define LOAD_SINE           100         //amplitude [mNm]
+#define LOAD_FREQUENCY      20          //[Hz]
+#define LOAD_START          0.5         //[s]
+#define DURATION            1.5         //[s]
+#define TWO_PI              6.28318530718
+
+/**
+ * @brief Holds VELOCITY, applies the load from LOAD_START and returns the peak velocity error after it [rpm].
+ *        The observer sees the torque of the motor and its estimate is added to the torque reference,
+ *        as in motion_control_service().
+ */
+static double run(int bandwidth, int sine, double &estimate_error)
+{
+    PlantModelConfig config = { 65536, INERTIA, 50, 20, 30, 200, MAX_TORQUE, 50, 2000 };
+    PlantModelState plant;
+    PIDparam velocity_pid;
+    DisturbanceObserverParam observer;
+    unsigned seed = 11;
+    double peak = 0, load_torque = 0;
+    int n_periods = (int)(DURATION / (PERIOD / 1000000.00));
+
+    plant_model_init(config, plant);
+    plant_model_set_brake(plant, 1);
+    for (int i=0; i<(int)((config.brake_release_time * 1000) / PERIOD) + 1; i++)
+        plant_model_update(plant, 0, PERIOD);
+
+    pid_init(velocity_pid);
+    pid_set_parameters(VELOCITY_KP, VELOCITY_KI, 0, INTEGRAL_LIMIT, PERIOD, velocity_pid);
+    disturbance_observer_init(observer);
+    disturbance_observer_set_parameters(INERTIA, bandwidth, PERIOD, observer);
+
+    for (int k=0; k<n_periods; k++)
+    {
+        double t = k * (PERIOD / 1000000.00);
+        int velocity = plant_model_get_velocity(plant) + test_random_range(seed, -NOISE, NOISE);
+        double torque;
+        int load = 0;
+
+        if (t >= LOAD_START)
+            load = sine ? (int)lround(LOAD_SINE * sin(TWO_PI * LOAD_FREQUENCY * (t - LOAD_START))) : LOAD_STEP;
+        plant_model_set_load_torque(plant, load);
+
+        load_torque = disturbance_observer_update(plant_model_get_torque(plant), velocity, observer);
+        torque = pid_update(VELOCITY, velocity, PERIOD, velocity_pid) + load_torque;
+        if (torque > MAX_TORQUE) torque = MAX_TORQUE;
+        if (torque < -MAX_TORQUE) torque = -MAX_TORQUE;
+
+        for (int i=0; i<PLANT_SUBSTEPS; i++)
+            plant_model_update(plant, (int)lround(torque), PERIOD / PLANT_SUBSTEPS);
+
+        if (t >= LOAD_START && fabs(VELOCITY - velocity) > peak)
+            peak = fabs(VELOCITY - velocity);
+    }
+
+    //load, viscous and Coulomb friction at VELOCITY
+    estimate_error = load_torque - (LOAD_STEP + (50 * VELOCITY) / 1000.00 + 20);
+
+    return peak;
+}
+
+static void test_load(int sine, double max_ratio)
+{
+    double estimate_error, off = run(0, sine, estimate_error);
+
+    printf("  %s: peak velocity error %.0f rpm without the observer", sine ? "20 Hz sine load" : "load step      ", off);
+    for (int bandwidth=200; bandwidth<=400; bandwidth+=200)
+    {
+        double on = run(bandwidth, sine, estimate_error);
+
+        printf(", %.0f rpm at %d Hz", on, bandwidth);
+        CHECK(on <= max_ratio * off, "%s, %d Hz: %.0f rpm against %.0f rpm", sine ? "sine" : "step", bandwidth, on, off);
+        if (!sine)
+            CHECK(fabs(estimate_error) < 5, "%d Hz: estimate off by %.1f mNm", bandwidth, estimate_error);
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    printf("test_disturbance_observer, J %d g cm^2, %d rpm, load step %d mNm, sine %d mNm at %d Hz\n",
+            INERTIA, VELOCITY, LOAD_STEP, LOAD_SINE, LOAD_FREQUENCY);
+
+    test_load(0, 0.60);
+    test_load(1, 0.30);
+
+    return test_result("test_disturbance_observer");
+}
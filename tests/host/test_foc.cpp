@@ -0,0 +1,219 @@
+/**
+ * @file test_foc.cpp
+ * @brief Fixed-point current loop of module_foc at 16 kHz against a dq model of a PMSM driven by the
+ *        averaged phase voltages of the duties: rise time and steady state error of a q current step,
+ *        the d current excursion of a q current reversal at speed with and without the decoupling, and
+ *        the cost of foc_update on the host. The duties of the whole run are hashed and compared with a
+ *        reference, "make reference" builds the test with -O0 and -O3 to check that the kernels are bit exact.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <foc.h>
+}
+
+#define T_S                 62          //[us], 16 kHz
+#define PWM_MAX_VALUE       16384
+#define PWM_LIMIT           250
+#define DC_BUS_VOLTAGE      48000       //[mV]
+#define RESISTANCE          0.5         //phase resistance [Ohm]
+#define INDUCTANCE          500         //phase inductance [uH]
+#define POLE_PAIRS          4
+#define FLUX                0.01        //flux linkage of the magnets [Vs]
+#define KP                  3142        //[mV/A], L*2*pi*1 kHz
+#define KI                  3142        //[mV/(A*ms)], R*2*pi*1 kHz
+#define CURRENT             5000        //q current reference [mA]
+#define SUBSTEPS            16
+#define TWO_PI              6.28318530718
+#define DURATION            0.8         //[s]
+#define STEP_TIME           0.010       //q current step at standstill [s]
+#define REVERSAL_TIME       0.400       //q current reversal at REVERSAL_VELOCITY [s]
+#define REVERSAL_VELOCITY   3000        //[rpm]
+#define LIMITED_TIME        0.500       //q current back to CURRENT, the velocity ramps into the voltage limit [s]
+#define LIMITED_VELOCITY    6500        //[rpm]
+#define N_RUNS              5
+
+/**
+ * @brief FNV-1a hash of the duties of the run with the decoupling, the same with gcc at -O0, -O2 and -O3.
+ *        The interpolated sine (FOC_INTERPOLATED_SINE) uses the full resolution of the angle.
+ */
+#ifdef FOC_INTERPOLATED_SINE
+#define DUTY_HASH           0x9b7fb980u
+#else
+#define DUTY_HASH           0xbdf7a0f1u
+#endif
+
+static int foc_limit(void)
+{
+    FocParam foc;
+
+    foc_init(KP, KI, INDUCTANCE, POLE_PAIRS, DC_BUS_VOLTAGE, T_S, PWM_MAX_VALUE, PWM_LIMIT, foc);
+    return foc.voltage_limit;
+}
+
+struct Result {
+    double rise_time;           //time to 63% of the q current step [us]
+    double steady_error;        //mean q current error 5 to 10 ms after the step [mA]
+    double d_excursion;         //largest d current within 5 ms after the reversal [mA]
+    double limited_current;     //mean q current at LIMITED_VELOCITY [mA]
+    int limited_periods;        //periods with the voltage vector at its limit
+    double max_voltage;         //largest voltage vector [mV]
+    unsigned hash;
+    double ns;                  //mean cost of foc_update [ns]
+};
+
+/**
+ * @brief Mechanical velocity of the scenario [rpm]: standstill, ramp to REVERSAL_VELOCITY, hold, then a ramp
+ *        to LIMITED_VELOCITY, where the back EMF drives the voltage vector into its limit.
+ */
+static double velocity_profile(double t)
+{
+    if (t < 0.1)
+        return 0;
+    if (t < 0.3)
+        return REVERSAL_VELOCITY * (t - 0.1) / 0.2;
+    if (t < LIMITED_TIME)
+        return REVERSAL_VELOCITY;
+    if (t < 0.7)
+        return REVERSAL_VELOCITY + (LIMITED_VELOCITY - REVERSAL_VELOCITY) * (t - LIMITED_TIME) / (0.7 - LIMITED_TIME);
+    return LIMITED_VELOCITY;
+}
+
+/**
+ * @brief Runs the scenario. With delay the duties act one period after the currents were sampled, as with
+ *        the PWM service, without they act immediately.
+ */
+static Result run(int phase_inductance, int delay)
+{
+    FocParam foc;
+    Result result = { -1, 0, 0, 0, 0, 0, 2166136261u, 0 };
+    double i_d = 0, i_q = 0, theta = 0, h = (T_S / 1000000.00) / SUBSTEPS, l = INDUCTANCE * 1.0e-6;
+    int duty[3] = { PWM_MAX_VALUE / 2, PWM_MAX_VALUE / 2, PWM_MAX_VALUE / 2 };
+    int n_periods = (int)(DURATION / (T_S / 1000000.00)), n_steady = 0, n_limited = 0;
+
+    CHECK(foc_init(KP, KI, phase_inductance, POLE_PAIRS, DC_BUS_VOLTAGE, T_S, PWM_MAX_VALUE, PWM_LIMIT, foc) == 0, "not initialized");
+
+    for (int k=0; k<n_periods; k++)
+    {
+        double t = k * (T_S / 1000000.00);
+        double velocity = velocity_profile(t);
+        double omega = velocity * (TWO_PI / 60.00) * POLE_PAIRS;
+        double i_alpha = (i_d * cos(theta)) - (i_q * sin(theta));
+        double i_beta = (i_d * sin(theta)) + (i_q * cos(theta));
+        double v_phase[3], v_neutral, v_alpha, v_beta, start;
+        int i_a = (int)lround(i_alpha * 1000.00);
+        int i_b = (int)lround(((-0.50 * i_alpha) + (0.866025403784 * i_beta)) * 1000.00);
+        unsigned angle = ((unsigned)(long long)floor(theta * (FOC_ANGLE_RESOLUTION / TWO_PI))) & (FOC_ANGLE_RESOLUTION - 1);
+        int i_q_ref, duty_k[3];
+        double voltage;
+
+        if (t < STEP_TIME)
+            i_q_ref = 0;
+        else if (t >= REVERSAL_TIME && t < LIMITED_TIME)
+            i_q_ref = -CURRENT;
+        else
+            i_q_ref = CURRENT;
+
+        start = test_time_ns();
+        foc_update(i_a, i_b, angle, (int)lround(velocity), 0, i_q_ref, duty_k, foc);
+        result.ns += test_time_ns() - start;
+
+        for (int i=0; i<3; i++)
+            result.hash = (result.hash ^ (unsigned)duty_k[i]) * 16777619u;
+        voltage = sqrt(((double)foc.v_d) * foc.v_d + ((double)foc.v_q) * foc.v_q);
+        if (voltage > result.max_voltage)
+            result.max_voltage = voltage;
+        if (voltage >= foc.voltage_limit - 2)
+            result.limited_periods++;
+
+        //with the delay the duties of the previous period are applied during this period
+        for (int i=0; i<3; i++)
+        {
+            v_phase[i] = ((((double)(delay ? duty[i] : duty_k[i])) / PWM_MAX_VALUE) - 0.50) * (DC_BUS_VOLTAGE / 1000.00);
+            duty[i] = duty_k[i];
+        }
+        v_neutral = (v_phase[0] + v_phase[1] + v_phase[2]) / 3.00;
+        v_alpha = v_phase[0] - v_neutral;
+        v_beta = ((v_phase[1] - v_neutral) - (v_phase[2] - v_neutral)) / 1.73205080757;
+
+        for (int i=0; i<SUBSTEPS; i++)
+        {
+            double v_d = (v_alpha * cos(theta)) + (v_beta * sin(theta));
+            double v_q = (v_beta * cos(theta)) - (v_alpha * sin(theta));
+            double d_i_d = (v_d - (RESISTANCE * i_d) + (omega * l * i_q)) / l;
+            double d_i_q = (v_q - (RESISTANCE * i_q) - (omega * l * i_d) - (omega * FLUX)) / l;
+
+            i_d += d_i_d * h;
+            i_q += d_i_q * h;
+            theta += omega * h;
+        }
+        if (theta > TWO_PI)
+            theta -= TWO_PI;
+
+        if (result.rise_time < 0 && t >= STEP_TIME && i_q * 1000.00 >= 0.632 * CURRENT)
+            result.rise_time = (t + (T_S / 1000000.00) - STEP_TIME) * 1.0e6;
+        if (t >= STEP_TIME + 0.005 && t < STEP_TIME + 0.010)
+        {
+            result.steady_error += fabs(CURRENT - (i_q * 1000.00));
+            n_steady++;
+        }
+        if (t >= REVERSAL_TIME && t < REVERSAL_TIME + 0.005 && fabs(i_d * 1000.00) > result.d_excursion)
+            result.d_excursion = fabs(i_d * 1000.00);
+        if (t >= 0.75)
+        {
+            result.limited_current += i_q * 1000.00;
+            n_limited++;
+        }
+    }
+
+    result.steady_error /= n_steady;
+    result.limited_current /= n_limited;
+    result.ns /= n_periods;
+
+    return result;
+}
+
+int main(void)
+{
+    Result with, without, with_immediate, without_immediate;
+    double best_ns = 1.0e9;
+
+    printf("test_foc, %d us, R %.1f Ohm, L %d uH, %d pole pairs, %d mV, kp %d mV/A, ki %d mV/(A*ms)\n",
+            T_S, RESISTANCE, INDUCTANCE, POLE_PAIRS, DC_BUS_VOLTAGE, KP, KI);
+
+    with = run(INDUCTANCE, 1);
+    without = run(0, 1);
+    with_immediate = run(INDUCTANCE, 0);
+    without_immediate = run(0, 0);
+    for (int i=0; i<N_RUNS; i++)
+    {
+        double ns = run(INDUCTANCE, 1).ns;
+        if (ns < best_ns)
+            best_ns = ns;
+    }
+
+    printf("  q step %d mA: 63%% after %.0f us, steady state error %.1f mA\n", CURRENT, with.rise_time, with.steady_error);
+    printf("  q reversal at %d rpm, d excursion: %.0f mA with decoupling, %.0f mA without (duties applied after one period),\n"
+           "                                   %.0f mA with decoupling, %.0f mA without (duties applied immediately)\n",
+            REVERSAL_VELOCITY, with.d_excursion, without.d_excursion, with_immediate.d_excursion, without_immediate.d_excursion);
+    printf("  %d rpm: q current %.0f mA, voltage vector limited in %d periods, largest %.0f mV of %d mV\n",
+            LIMITED_VELOCITY, with.limited_current, with.limited_periods, with.max_voltage, foc_limit());
+    printf("  duty hash 0x%08x, reference 0x%08x\n", with.hash, DUTY_HASH);
+    printf("  cost: %.0f ns per foc_update\n", best_ns);
+
+    CHECK(with.rise_time > 0 && with.rise_time <= 250, "rise time %.0f us", with.rise_time);
+    CHECK(with.steady_error <= 20, "steady state error %.1f mA", with.steady_error);
+    CHECK(with.d_excursion < without.d_excursion, "d excursion %.0f mA against %.0f mA", with.d_excursion, without.d_excursion);
+    CHECK(with_immediate.d_excursion * 3 < without_immediate.d_excursion, "d excursion %.0f mA against %.0f mA without delay",
+            with_immediate.d_excursion, without_immediate.d_excursion);
+    CHECK(with.limited_periods > 0, "the voltage vector was not limited");
+    CHECK(with.max_voltage <= foc_limit() + 2, "voltage vector of %.0f mV", with.max_voltage);
+    CHECK(with.limited_current > 0 && with.limited_current < CURRENT, "q current %.0f mA in the voltage limit", with.limited_current);
+    CHECK(with.hash == DUTY_HASH, "duty hash 0x%08x", with.hash);
+
+    return test_result("test_foc");
+}
@@ -0,0 +1,157 @@
+/**
+ * @file test_frequency_response.cpp
+ * @brief Frequency response analyzer against the discrete transfer functions of an analytic loop: a rigid
+ *        body with viscous friction and one period torque delay, closed with a PI velocity controller at
+ *        3 kHz. All excitations are checked with torque and velocity injection, the multisine also with
+ *        velocity noise. The analyzer gets the integer torque and velocity of the motion control service.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <complex>
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <frequency_response.h>
+}
+
+#define T_S             333
+#define INERTIA         5.0e-4      //[kg m^2]
+#define FRICTION        2.0e-4      //viscous friction [Nm s/rad]
+#define KP              16.4        //[mNm/rpm], 50 Hz bandwidth
+#define KI              0.344       //[mNm/rpm per period], integrator corner at 10 Hz
+#define RECORD_LENGTH   3000        //1 s, 1 Hz resolution
+#define PERIODS         4
+#define TWO_PI          6.28318530718
+
+typedef std::complex<double> Complex;
+
+static const int frequencies[] = { 5, 8, 12, 18, 27, 40, 60, 90, 135, 200, 300, 450, 670, 1000, 1400 };
+static const int n_frequencies = sizeof(frequencies) / sizeof(frequencies[0]);
+
+/**
+ * @brief Plant [rpm/Nm] and closed loop of the loop at exp(j*omega).
+ */
+static void analytic(double omega, int injection, Complex &plant, Complex &closed_loop)
+{
+    double a = exp(-(FRICTION / INERTIA) * (T_S / 1000000.00));
+    double b = (1.00 - a) / FRICTION;
+    Complex z = std::polar(1.00, omega);
+    Complex controller = KP + (KI / (1.00 - (1.00 / z)));
+    Complex loop;
+
+    plant = (60.00 / TWO_PI) * b / (z * (z - a));
+    loop = controller * plant / 1000.00;
+    if (injection == FREQUENCY_RESPONSE_TORQUE)
+        closed_loop = 1.00 / (1.00 + loop);
+    else
+        closed_loop = loop / (1.00 + loop);
+}
+
+static double phase_difference(int phase, double reference)
+{
+    double difference = (phase / 100.00) - reference;
+
+    while (difference > 180.00) difference -= 360.00;
+    while (difference < -180.00) difference += 360.00;
+    return fabs(difference);
+}
+
+/**
+ * @brief Measures the loop and returns the largest deviation of the plant and of the closed loop
+ *        up to max_frequency.
+ */
+static void measure(int excitation, int injection, int amplitude, double noise, int max_frequency,
+        double &magnitude_error, double &phase_error)
+{
+    FrequencyResponseParam analyzer;
+    FrequencyResponseConfig config;
+    FrequencyResponse response;
+    unsigned seed = 11;
+    double omega = 0, torque_1n = 0, integral = 0;
+    int k = 0;
+
+    config.excitation = excitation;
+    config.injection = injection;
+    config.amplitude = amplitude;
+    config.record_length = RECORD_LENGTH;
+    config.periods = PERIODS;
+    config.n_points = n_frequencies;
+    for (int i=0; i<n_frequencies; i++)
+        config.frequency[i] = frequencies[i];
+
+    frequency_response_init(analyzer);
+    CHECK(frequency_response_start(config, T_S, analyzer) == 0, "not started");
+
+    while (analyzer.status == FREQUENCY_RESPONSE_RUNNING && k < 10 * RECORD_LENGTH * (PERIODS + 1))
+    {
+        double measured = omega * 60.00 / TWO_PI + noise * (test_random_range(seed, -1000, 1000) / 1000.00);
+        int velocity = (int)lround(measured);
+        double value = frequency_response_excitation(analyzer);
+        double error = (injection == FREQUENCY_RESPONSE_VELOCITY ? value : 0) - velocity;
+        int torque;
+
+        integral += KI * error;
+        torque = (int)lround((KP * error) + integral + (injection == FREQUENCY_RESPONSE_TORQUE ? value : 0));
+        frequency_response_update(value, torque, velocity, analyzer);
+
+        //exact discretization of the rigid body, the torque acts one period later
+        omega = exp(-(FRICTION / INERTIA) * (T_S / 1000000.00)) * omega
+                + ((1.00 - exp(-(FRICTION / INERTIA) * (T_S / 1000000.00))) / FRICTION) * (torque_1n / 1000.00);
+        torque_1n = torque;
+        k++;
+    }
+    CHECK(analyzer.status == FREQUENCY_RESPONSE_DONE, "measurement not done after %d periods", k);
+    CHECK(k == RECORD_LENGTH * (PERIODS + 1), "%d periods instead of %d", k, RECORD_LENGTH * (PERIODS + 1));
+
+    frequency_response_result(analyzer, response);
+    magnitude_error = phase_error = 0;
+    for (int i=0; i<response.n_points && frequencies[i] <= max_frequency; i++)
+    {
+        long bin = lround(frequencies[i] * RECORD_LENGTH * (T_S / 1000000.00));
+        Complex plant, closed_loop;
+
+        CHECK(response.frequency[i] == (int)lround((bin * 1000.00) / (RECORD_LENGTH * (T_S / 1000000.00))),
+                "frequency %d mHz, %d Hz requested", response.frequency[i], frequencies[i]);
+        analytic((TWO_PI * bin) / RECORD_LENGTH, injection, plant, closed_loop);
+
+        magnitude_error = fmax(magnitude_error, fabs((response.plant_magnitude[i] / 100.00) - 20.00 * log10(abs(plant))));
+        magnitude_error = fmax(magnitude_error, fabs((response.closed_loop_magnitude[i] / 100.00) - 20.00 * log10(abs(closed_loop))));
+        phase_error = fmax(phase_error, phase_difference(response.plant_phase[i], arg(plant) * 360.00 / TWO_PI));
+        phase_error = fmax(phase_error, phase_difference(response.closed_loop_phase[i], arg(closed_loop) * 360.00 / TWO_PI));
+    }
+}
+
+static void test_excitation(int excitation, int injection, int amplitude, double noise, int max_frequency,
+        double max_magnitude_error, double max_phase_error)
+{
+    const char *excitations[] = { "multisine", "chirp", "PRBS" };
+    double magnitude_error, phase_error;
+
+    measure(excitation, injection, amplitude, noise, max_frequency, magnitude_error, phase_error);
+
+    printf("  %-9s %-8s injection, noise %.1f rpm, up to %4d Hz: max error %.3f dB, %.2f degree\n",
+            excitations[excitation], injection == FREQUENCY_RESPONSE_TORQUE ? "torque" : "velocity",
+            noise, max_frequency, magnitude_error, phase_error);
+    CHECK(magnitude_error < max_magnitude_error, "%s: magnitude error %.3f dB", excitations[excitation], magnitude_error);
+    CHECK(phase_error < max_phase_error, "%s: phase error %.2f degree", excitations[excitation], phase_error);
+}
+
+int main(void)
+{
+    printf("test_frequency_response, %d frequencies from %d to %d Hz, %d periods of %d samples\n",
+            n_frequencies, frequencies[0], frequencies[n_frequencies-1], PERIODS, RECORD_LENGTH);
+
+    //without noise the rounding of the velocity to rpm is the only error, it is largest where the velocity
+    //response falls below a few rpm: above 300 Hz only the multisine keeps enough amplitude per frequency
+    test_excitation(FREQUENCY_RESPONSE_MULTISINE, FREQUENCY_RESPONSE_TORQUE, 2000, 0, 1400, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_MULTISINE, FREQUENCY_RESPONSE_VELOCITY, 200, 0, 1400, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_CHIRP, FREQUENCY_RESPONSE_TORQUE, 2000, 0, 300, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_CHIRP, FREQUENCY_RESPONSE_VELOCITY, 200, 0, 300, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_PRBS, FREQUENCY_RESPONSE_TORQUE, 2000, 0, 300, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_PRBS, FREQUENCY_RESPONSE_VELOCITY, 200, 0, 300, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_MULTISINE, FREQUENCY_RESPONSE_TORQUE, 2000, 0.5, 300, 0.15, 1.0);
+    test_excitation(FREQUENCY_RESPONSE_MULTISINE, FREQUENCY_RESPONSE_VELOCITY, 200, 0.5, 300, 0.15, 1.0);
+
+    return test_result("test_frequency_response");
+}
@@ -0,0 +1,164 @@
+/**
+ * @file test_gain_schedule.cpp
+ * @brief Interpolation of the gain schedules and its cost, which must stay within a fixed budget,
+ *        and the bumpless change of the gains of a running PID controller, also at the integral limit.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <controllers.h>
+#include <gain_schedule.h>
+}
+
+#define T_S                 333
+#define N_CALLS             10000000
+#define N_INPUTS            1024
+#define N_RUNS              5
+#define BUDGET_NS           50.00       //cost budget of one interpolation with 16 breakpoints on the host [ns]
+
+static int inputs[N_INPUTS];
+
+/**
+ * @brief 16 breakpoints of the absolute velocity, Kp falling, Ki rising and Kd constant.
+ */
+static void make_schedule(GainSchedule &schedule)
+{
+    gain_schedule_init(schedule);
+    schedule.input = GAIN_SCHEDULE_VELOCITY;
+    schedule.length = GAIN_SCHEDULE_MAX_POINTS;
+    for (int i=0; i<GAIN_SCHEDULE_MAX_POINTS; i++)
+    {
+        schedule.breakpoint[i] = 250 * i;
+        schedule.kp[i] = 2000000 - 100000 * i;
+        schedule.ki[i] = 10000 + 7 * i * i;
+        schedule.kd[i] = 40000;
+    }
+}
+
+static void test_interpolation(void)
+{
+    GainSchedule schedule;
+    int kp, ki, kd, max_error = 0;
+
+    make_schedule(schedule);
+    CHECK(gain_schedule_check(schedule), "valid schedule rejected");
+
+    //held outside of the breakpoints
+    gain_schedule_interpolate(schedule, INT_MIN, kp, ki, kd);
+    CHECK(kp == schedule.kp[0] && ki == schedule.ki[0] && kd == schedule.kd[0], "below: %d %d %d", kp, ki, kd);
+    gain_schedule_interpolate(schedule, INT_MAX, kp, ki, kd);
+    CHECK(kp == schedule.kp[15] && ki == schedule.ki[15] && kd == schedule.kd[15], "above: %d %d %d", kp, ki, kd);
+
+    //against the interpolation in floating point, rounded
+    for (int value=0; value<=250 * (GAIN_SCHEDULE_MAX_POINTS-1); value++)
+    {
+        int i = value / 250 < GAIN_SCHEDULE_MAX_POINTS-1 ? value / 250 : GAIN_SCHEDULE_MAX_POINTS-2;
+        double x = (value - schedule.breakpoint[i]) / 250.00;
+        int expected_kp = (int)lround(schedule.kp[i] + x * (schedule.kp[i+1] - schedule.kp[i]));
+        int expected_ki = (int)lround(schedule.ki[i] + x * (schedule.ki[i+1] - schedule.ki[i]));
+
+        gain_schedule_interpolate(schedule, value, kp, ki, kd);
+        if (abs(kp - expected_kp) > max_error) max_error = abs(kp - expected_kp);
+        if (abs(ki - expected_ki) > max_error) max_error = abs(ki - expected_ki);
+        if (kd != 40000) max_error = INT_MAX;
+    }
+    printf("  interpolation over %d inputs: max error %d\n", 250 * (GAIN_SCHEDULE_MAX_POINTS-1) + 1, max_error);
+    CHECK(max_error == 0, "max error %d", max_error);
+
+    //breakpoints over the whole int range
+    schedule.length = 2;
+    schedule.breakpoint[0] = INT_MIN;
+    schedule.breakpoint[1] = INT_MAX;
+    schedule.kp[0] = 0;
+    schedule.kp[1] = 100000000;
+    gain_schedule_interpolate(schedule, 0, kp, ki, kd);
+    CHECK(kp == 50000000, "middle of the int range: %d", kp);
+
+    //invalid schedules
+    schedule.breakpoint[1] = INT_MIN;
+    CHECK(!gain_schedule_check(schedule), "breakpoints not increasing");
+    schedule.breakpoint[1] = INT_MAX;
+    schedule.kp[1] = 100000001;
+    CHECK(!gain_schedule_check(schedule), "gain out of range");
+    schedule.kp[1] = 0;
+    schedule.length = GAIN_SCHEDULE_MAX_POINTS + 1;
+    CHECK(!gain_schedule_check(schedule), "too many breakpoints");
+    schedule.length = 2;
+    schedule.input = GAIN_SCHEDULE_DISABLED;
+    CHECK(!gain_schedule_interpolate(schedule, 0, kp, ki, kd), "disabled schedule interpolated");
+}
+
+/**
+ * @brief The best of several runs is compared with the budget, the other processes of the host
+ *        only make runs slower.
+ */
+static void test_cost(void)
+{
+    GainSchedule schedule;
+    unsigned seed = 7;
+    int kp, ki, kd, sum = 0;
+    double best = 1.0e9;
+
+    make_schedule(schedule);
+    for (int i=0; i<N_INPUTS; i++)
+        inputs[i] = test_random_range(seed, -100, 250 * GAIN_SCHEDULE_MAX_POINTS + 100);
+
+    for (int run=0; run<N_RUNS; run++)
+    {
+        double start = test_time_ns();
+        for (int k=0; k<N_CALLS; k++)
+        {
+            gain_schedule_interpolate(schedule, inputs[k & (N_INPUTS-1)], kp, ki, kd);
+            sum += kp + ki + kd;
+        }
+        double ns = (test_time_ns() - start) / N_CALLS;
+        if (ns < best)
+            best = ns;
+    }
+    bench_sink = sum;
+
+    printf("  interpolation with %d breakpoints: %.2f ns/call, budget %.0f ns\n", GAIN_SCHEDULE_MAX_POINTS, best, BUDGET_NS);
+    CHECK(best < BUDGET_NS, "%.2f ns/call above the budget of %.0f ns", best, BUDGET_NS);
+}
+
+/**
+ * @brief Change of Kp with constant inputs: the output changes by one integration step only.
+ *        Near the integral limit Kp only moves as far as the integrator can take, it reaches the
+ *        new value once the error is 0.
+ */
+static void test_bumpless(double integral_limit)
+{
+    PIDparam pid;
+    double before, after, step;
+
+    pid_init(pid);
+    pid_set_parameters(1000000, 10000, 0, integral_limit, T_S, pid);
+    for (int k=0; k<100; k++)
+        before = pid_update(1000, 900, T_S, pid);
+    pid_set_gains_bumpless(3000000, 10000, 0, 100, pid);
+    after = pid_update(1000, 900, T_S, pid);
+    step = fabs(pid.integral) < integral_limit ? (10000 / 1000000.00) * 100 : 0;
+
+    printf("  integral limit %6.0f: output %.2f before, %.2f after the change of Kp, Kp %.0f\n", integral_limit, before, after, pid.Kp);
+    CHECK(fabs((after - before) - step) < 1.0e-6, "limit %.0f: jump %g", integral_limit, after - before);
+
+    pid_set_gains_bumpless(3000000, 10000, 0, 0, pid);
+    CHECK(pid.Kp == 3000000, "limit %.0f: Kp %.0f at an error of 0", integral_limit, pid.Kp);
+}
+
+int main(void)
+{
+    printf("test_gain_schedule\n");
+
+    test_interpolation();
+    test_cost();
+    test_bumpless(1000);
+    test_bumpless(100);
+
+    return test_result("test_gain_schedule");
+}
@@ -0,0 +1,194 @@
+/**
+ * @file test_inertia_estimator.cpp
+ * @brief Online inertia and friction estimation on trapezoidal velocity moves of a rigid plant with
+ *        velocity and torque noise: J, B and Fc must converge from a wrong initial inertia, the estimate
+ *        must follow a doubled payload, and the cost of an update and of a rejected sample is reported.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <inertia_estimator.h>
+}
+
+#define T_S                 333         //[us]
+#define PLANT_SUBSTEPS      9
+#define INERTIA             3000        //[g cm^2]
+#define INITIAL_INERTIA     1000        //[g cm^2]
+#define VISCOUS_FRICTION    50          //[uNm/rpm]
+#define COULOMB_FRICTION    20          //[mNm]
+#define MOVE_VELOCITY       1000        //[rpm]
+#define MOVE_ACCELERATION   3000        //[rpm/s]
+#define MOVE_HOLD           0.20        //duration at constant velocity [s]
+#define KP                  2.0         //velocity controller [mNm/rpm]
+#define VELOCITY_NOISE      2           //[rpm]
+#define TORQUE_NOISE        5           //[mNm]
+#define CONVERGENCE_TIME    3.0         //[s]
+#define N_RUNS              5
+
+/**
+ * @brief Rigid plant under a proportional velocity controller with acceleration feed-forward,
+ *        following a trapezoidal velocity between -MOVE_VELOCITY and MOVE_VELOCITY.
+ */
+typedef struct {
+    double inertia;     //[kg m^2]
+    double omega;       //[rad/s]
+    double reference;   //[rpm]
+    double direction;
+    double hold;        //[s]
+    unsigned seed;
+} Plant;
+
+static void plant_init(Plant &plant, int inertia)
+{
+    plant.inertia = inertia * 1.0e-7;
+    plant.omega = 0;
+    plant.reference = 0;
+    plant.direction = 1;
+    plant.hold = 0;
+    plant.seed = 7;
+}
+
+/**
+ * @brief Runs one period, returns the measured torque [mNm] and velocity [rpm] with noise.
+ */
+static void plant_update(Plant &plant, int &torque_measured, int &velocity_measured)
+{
+    double dt = T_S / 1000000.00;
+    double acceleration = 0, torque, velocity = plant.omega * 60.00 / (2.00 * M_PI);
+
+    if (plant.hold > 0)
+        plant.hold -= dt;
+    else
+    {
+        acceleration = plant.direction * MOVE_ACCELERATION;
+        plant.reference += acceleration * dt;
+        if (fabs(plant.reference) >= MOVE_VELOCITY)
+        {
+            plant.reference = plant.direction * MOVE_VELOCITY;
+            plant.direction = -plant.direction;
+            plant.hold = MOVE_HOLD;
+        }
+    }
+
+    torque = KP * (plant.reference - velocity) + acceleration * (2.00 * M_PI / 60.00) * INITIAL_INERTIA * 1.0e-4;
+
+    for (int i=0; i<PLANT_SUBSTEPS; i++)
+    {
+        double velocity_rpm = plant.omega * 60.00 / (2.00 * M_PI);
+        double friction = VISCOUS_FRICTION * 1.0e-3 * velocity_rpm + ((plant.omega > 0) ? COULOMB_FRICTION : -COULOMB_FRICTION);
+        plant.omega += ((torque - friction) * 1.0e-3 / plant.inertia) * (dt / PLANT_SUBSTEPS);
+    }
+
+    torque_measured = (int)lround(torque) + test_random_range(plant.seed, -TORQUE_NOISE, TORQUE_NOISE);
+    velocity_measured = (int)lround(plant.omega * 60.00 / (2.00 * M_PI)) + test_random_range(plant.seed, -VELOCITY_NOISE, VELOCITY_NOISE);
+}
+
+static double error_percent(int estimate, int actual)
+{
+    return (100.00 * abs(estimate - actual)) / actual;
+}
+
+/**
+ * @brief Converges from INITIAL_INERTIA, then doubles the inertia and converges again.
+ */
+static void test_accuracy(void)
+{
+    InertiaEstimatorParam param;
+    InertiaEstimate estimate;
+    Plant plant;
+    int periods = (int)(CONVERGENCE_TIME / (T_S / 1000000.00));
+    int torque, velocity;
+
+    plant_init(plant, INERTIA);
+    inertia_estimator_init(INITIAL_INERTIA, T_S, param);
+
+    for (int i=0; i<periods; i++)
+    {
+        plant_update(plant, torque, velocity);
+        inertia_estimator_update(torque, velocity, param);
+    }
+    inertia_estimator_result(param, estimate);
+
+    printf("  after %.1f s: J %d g cm^2 (%d), B %d uNm/rpm (%d), Fc %d mNm (%d), %d updates\n", CONVERGENCE_TIME,
+            estimate.moment_of_inertia, INERTIA, estimate.viscous_friction, VISCOUS_FRICTION,
+            estimate.coulomb_friction, COULOMB_FRICTION, estimate.updates);
+    CHECK(error_percent(estimate.moment_of_inertia, INERTIA) <= 3, "J %d g cm^2", estimate.moment_of_inertia);
+    CHECK(error_percent(estimate.viscous_friction, VISCOUS_FRICTION) <= 2, "B %d uNm/rpm", estimate.viscous_friction);
+    CHECK(error_percent(estimate.coulomb_friction, COULOMB_FRICTION) <= 2, "Fc %d mNm", estimate.coulomb_friction);
+
+    //doubled payload, the estimator is not restarted
+    plant.inertia *= 2;
+    for (int i=0; i<periods; i++)
+    {
+        plant_update(plant, torque, velocity);
+        inertia_estimator_update(torque, velocity, param);
+    }
+    inertia_estimator_result(param, estimate);
+
+    printf("  %.1f s after the payload doubled: J %d g cm^2 (%d), B %d uNm/rpm, Fc %d mNm\n", CONVERGENCE_TIME,
+            estimate.moment_of_inertia, 2 * INERTIA, estimate.viscous_friction, estimate.coulomb_friction);
+    CHECK(error_percent(estimate.moment_of_inertia, 2 * INERTIA) <= 3, "J %d g cm^2 after the payload change", estimate.moment_of_inertia);
+}
+
+/**
+ * @brief Best of N_RUNS of the mean cost of an update and of a rejected sample, on recorded data.
+ */
+static void bench_update(void)
+{
+    static int torque[20000], velocity[20000];
+    InertiaEstimatorParam param;
+    Plant plant;
+    double best_update = 1.0e9, best_rejected = 1.0e9;
+
+    plant_init(plant, INERTIA);
+    for (int i=0; i<20000; i++)
+        plant_update(plant, torque[i], velocity[i]);
+
+    for (int run=0; run<N_RUNS; run++)
+    {
+        double update_ns = 0, rejected_ns = 0;
+        int updates = 0, rejected = 0;
+
+        inertia_estimator_init(INITIAL_INERTIA, T_S, param);
+        for (int i=0; i<20000; i++)
+        {
+            double start = test_time_ns();
+            int updated = inertia_estimator_update(torque[i], velocity[i], param);
+            double ns = test_time_ns() - start;
+
+            if (updated)
+            {
+                update_ns += ns;
+                updates++;
+            }
+            else
+            {
+                rejected_ns += ns;
+                rejected++;
+            }
+        }
+        bench_sink = param.theta[0];
+
+        if (update_ns / updates < best_update)
+            best_update = update_ns / updates;
+        if (rejected_ns / rejected < best_rejected)
+            best_rejected = rejected_ns / rejected;
+    }
+
+    printf("  cost: %.0f ns per update, %.0f ns per rejected sample (timer overhead included)\n", best_update, best_rejected);
+}
+
+int main(void)
+{
+    printf("test_inertia_estimator, moves of +-%d rpm at %d rpm/s, noise %d rpm and %d mNm\n",
+            MOVE_VELOCITY, MOVE_ACCELERATION, VELOCITY_NOISE, TORQUE_NOISE);
+
+    test_accuracy();
+    bench_update();
+
+    return test_result("test_inertia_estimator");
+}
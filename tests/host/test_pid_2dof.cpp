@@ -0,0 +1,160 @@
+/**
+ * @file test_pid_2dof.cpp
+ * @brief Setpoint weights, derivative filter, back-calculation of the integrator and bumpless
+ *        change of the gains of the two-degree-of-freedom PID controller, and its equivalence
+ *        with pid_update() for the weights of the one-degree-of-freedom controller.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <controllers.h>
+}
+
+#define T_S     333
+#define KP      1300000
+#define KI      70000
+#define KD      500000
+
+/**
+ * @brief With b = 1, c = 0, no filter and no limits both controllers compute the same parts.
+ *        pid_update() integrates the error before the output, pid_2dof_update() after it, so the
+ *        outputs differ by Ki * error. The first step is skipped, there pid_update() differentiates
+ *        against an actual value of 0.
+ */
+static void test_equivalence(void)
+{
+    PIDparam pid;
+    PIDparam2DOF pid_2dof;
+    unsigned seed = 5;
+    double max_difference = 0;
+
+    pid_init(pid);
+    pid_set_parameters(KP, KI, KD, 1.0e12, T_S, pid);
+    pid_2dof_init(pid_2dof);
+    pid_2dof_set_parameters(KP, KI, KD, 1, 0, 0, 0, T_S, pid_2dof);
+
+    for (int k=0; k<100000; k++)
+    {
+        double desired = test_random_range(seed, -1000, 1000);
+        double actual = test_random_range(seed, -1000, 1000);
+        double output = pid_update(desired, actual, T_S, pid);
+        double output_2dof = pid_2dof_update(desired, actual, T_S, pid_2dof);
+        double difference = fabs(output - (output_2dof + ((KI / 1000000.00) * (desired - actual))));
+
+        if (k > 0 && difference > max_difference)
+            max_difference = difference;
+    }
+
+    printf("  b = 1, c = 0 against pid_update: max difference %.3g\n", max_difference);
+    CHECK(max_difference < 1.0e-6, "max difference %g", max_difference);
+}
+
+/**
+ * @brief Step of the setpoint at rest: the jump of the output is Kp * b * step + Kd * c * step.
+ */
+static void test_setpoint_weights(double b, double c)
+{
+    PIDparam2DOF pid;
+    double before, after, expected;
+
+    pid_2dof_init(pid);
+    pid_2dof_set_parameters(KP, KI, KD, b, c, 0, 0, T_S, pid);
+    before = pid_2dof_update(0, 0, T_S, pid);
+    after = pid_2dof_update(1000, 0, T_S, pid);
+    expected = ((KP / 1000000.00) * b * 1000) + ((KD / 1000000.00) * c * 1000);
+
+    printf("  b = %.1f, c = %.1f: jump of the output at a setpoint step of 1000: %8.2f\n", b, c, after - before);
+    CHECK(fabs((after - before) - expected) < 1.0e-9, "b %.1f c %.1f: jump %g, expected %g", b, c, after - before, expected);
+}
+
+/**
+ * @brief Step of the actual value: the filtered derivative decays with the filter coefficient,
+ *        its sum equals the unfiltered derivative.
+ */
+static void test_derivative_filter(void)
+{
+    PIDparam2DOF pid;
+    double first, second, sum = 0;
+    double derivative_filter;
+
+    pid_2dof_init(pid);
+    pid_2dof_set_parameters(0, 0, KD, 1, 0, 100, 0, T_S, pid);
+    derivative_filter = pid.derivative_filter;
+    pid_2dof_update(0, 0, T_S, pid);
+    first = pid_2dof_update(0, 1000, T_S, pid);
+    second = pid_2dof_update(0, 1000, T_S, pid);
+    sum = first + second;
+    for (int k=0; k<10000; k++)
+        sum += pid_2dof_update(0, 1000, T_S, pid);
+
+    printf("  derivative filter at 100 Hz: first %.2f, unfiltered %.2f, decay %.4f, sum %.2f\n",
+            first, -(KD / 1000000.00) * 1000, second / first, sum);
+    CHECK(fabs(first - ((1.00 - derivative_filter) * -(KD / 1000000.00) * 1000)) < 1.0e-9, "first %g", first);
+    CHECK(fabs((second / first) - derivative_filter) < 1.0e-9, "decay %g, filter %g", second / first, derivative_filter);
+    CHECK(fabs(sum + ((KD / 1000000.00) * 1000)) < 1.0e-6, "sum %g", sum);
+}
+
+/**
+ * @brief Long saturation followed by a reversal of the error. With the back-calculation the
+ *        integrator stays near the limit and the output leaves the limit within a few steps.
+ */
+static void test_anti_windup(void)
+{
+    PIDparam2DOF pid;
+    double output = 0;
+    int steps = 0;
+
+    pid_2dof_init(pid);
+    pid_2dof_set_parameters(KP, KI, 0, 1, 0, 0, 500, T_S, pid);
+    for (int k=0; k<100000; k++)
+        output = pid_2dof_update(1000, 0, T_S, pid);
+    CHECK(output == 500, "output %g not at the limit", output);
+    printf("  anti-windup: integrator %.1f after 100000 steps at the limit of 500", pid.integral);
+    CHECK(fabs(pid.integral) < 2 * 500, "integrator %g wound up", pid.integral);
+
+    while (output >= 500 && steps < 100000)
+    {
+        output = pid_2dof_update(-100, 0, T_S, pid);
+        steps++;
+    }
+    printf(", leaves the limit %d steps after the reversal\n", steps);
+    CHECK(steps <= 2, "%d steps at the limit after the reversal", steps);
+}
+
+/**
+ * @brief Changing the gains of a running controller with constant inputs: the output moves by one
+ *        integration step only, the jump of Kp * b * error is taken over by the integrator.
+ */
+static void test_bumpless(void)
+{
+    PIDparam2DOF pid;
+    double before, after;
+
+    pid_2dof_init(pid);
+    pid_2dof_set_parameters(KP, KI, KD, 0.5, 0.5, 100, 0, T_S, pid);
+    for (int k=0; k<1000; k++)
+        before = pid_2dof_update(1000, 800, T_S, pid);
+    pid_2dof_set_parameters(3 * KP, KI, 2 * KD, 1, 1, 200, 0, T_S, pid);
+    after = pid_2dof_update(1000, 800, T_S, pid);
+
+    printf("  bumpless change of the gains: output %.3f before, %.3f after\n", before, after);
+    CHECK(fabs((after - before) - ((KI / 1000000.00) * 200)) < 1.0e-6, "jump %g", after - before);
+}
+
+int main(void)
+{
+    printf("test_pid_2dof\n");
+
+    test_equivalence();
+    test_setpoint_weights(1, 0);
+    test_setpoint_weights(0, 0);
+    test_setpoint_weights(0.5, 1);
+    test_derivative_filter();
+    test_anti_windup();
+    test_bumpless();
+
+    return test_result("test_pid_2dof");
+}
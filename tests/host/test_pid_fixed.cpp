@@ -0,0 +1,131 @@
+/**
+ * @file test_pid_fixed.cpp
+ * @brief Equivalence of the fixed-point PID controller with the floating point pid_update()
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <controllers.h>
+#include <plant_model.h>
+}
+
+#define T_S     333
+
+/**
+ * @brief Same input sequence into both controllers. Without saturation of the integrator the
+ *        outputs differ by the rounding to an integer only. At the integral limit pid_update()
+ *        keeps the integrator below the limit, pid_fixed_update() clamps it to the limit, so the
+ *        outputs may differ by one integration step.
+ */
+static void test_open_loop(int Kp, int Ki, int Kd, int integral_limit, int error_range, int steps)
+{
+    PIDparam pid;
+    PIDparamFixed pid_fixed;
+    unsigned seed = 12345;
+    int actual = 0, max_difference = 0;
+    double tolerance = 1.0 + (((double)Ki) / 1000000.00) * error_range;
+    int saturated = 0;
+
+    pid_init(pid);
+    pid_set_parameters(Kp, Ki, Kd, integral_limit, T_S, pid);
+    pid_fixed_init(pid_fixed);
+    pid_fixed_set_parameters(Kp, Ki, Kd, integral_limit, T_S, pid_fixed);
+
+    for (int k=0; k<steps; k++)
+    {
+        int desired = test_random_range(seed, -error_range/2, error_range/2);
+        actual += test_random_range(seed, -error_range/8, error_range/8);
+        if (actual >  error_range/2) actual =  error_range/2;
+        if (actual < -error_range/2) actual = -error_range/2;
+
+        double output = pid_update(desired, actual, T_S, pid);
+        int output_fixed = pid_fixed_update(desired, actual, T_S, pid_fixed);
+        int difference = abs(output_fixed - (int)lround(output));
+
+        if (fabs(pid.integral) >= integral_limit - (((double)Ki) / 1000000.00) * error_range)
+            saturated++;
+        if (difference > max_difference)
+            max_difference = difference;
+    }
+
+    printf("  Kp %8d Ki %7d Kd %7d limit %6d: max difference %d, %d of %d steps near the integral limit\n",
+            Kp, Ki, Kd, integral_limit, max_difference, saturated, steps);
+    if (saturated == 0)
+        CHECK(max_difference <= 1, "max difference %d", max_difference);
+    else
+        CHECK(max_difference <= tolerance, "max difference %d, tolerance %.1f", max_difference, tolerance);
+}
+
+/**
+ * @brief Velocity loop closed over the plant model with either controller, the following errors
+ *        of a velocity ramp and a load step agree.
+ */
+static void test_closed_loop(void)
+{
+    PlantModelConfig config = { 65536, 200, 50, 20, 30, 200, 1000, 0, 0 };
+    double rms[2] = {0, 0};
+    int max_error[2] = {0, 0};
+
+    for (int variant=0; variant<2; variant++)
+    {
+        PlantModelState plant;
+        PIDparam pid;
+        PIDparamFixed pid_fixed;
+        int torque = 0;
+        double square_sum = 0;
+
+        plant_model_init(config, plant);
+        plant_model_set_brake(plant, 1);
+        pid_init(pid);
+        pid_set_parameters(1300000, 70000, 0, 1000, T_S, pid);
+        pid_fixed_init(pid_fixed);
+        pid_fixed_set_parameters(1300000, 70000, 0, 1000, T_S, pid_fixed);
+
+        for (int k=0; k<6000; k++)
+        {
+            int target = k < 3000 ? k/3 : 1000;
+            int velocity = plant_model_get_velocity(plant);
+
+            if (k == 4000)
+                plant_model_set_load_torque(plant, 200);
+
+            if (variant == 0)
+                torque = (int)pid_update(target, velocity, T_S, pid);
+            else
+                torque = pid_fixed_update(target, velocity, T_S, pid_fixed);
+            plant_model_update(plant, torque, T_S);
+
+            int error = abs(target - velocity);
+            if (error > max_error[variant])
+                max_error[variant] = error;
+            square_sum += ((double)error) * error;
+        }
+        rms[variant] = sqrt(square_sum / 6000);
+    }
+
+    printf("  closed loop: rms error %.2f / %.2f rpm, max error %d / %d rpm (pid_update / pid_fixed_update)\n",
+            rms[0], rms[1], max_error[0], max_error[1]);
+    CHECK(fabs(rms[0] - rms[1]) <= 0.02 * rms[0] + 0.1, "rms %.2f %.2f", rms[0], rms[1]);
+    CHECK(abs(max_error[0] - max_error[1]) <= 2, "max %d %d", max_error[0], max_error[1]);
+}
+
+int main(void)
+{
+    printf("test_pid_fixed\n");
+
+    //velocity controller scaling [mNm per rpm], position controller scaling [rpm per tick]
+    test_open_loop(1300000,   70000,       0, 1000000, 2000, 100000);
+    test_open_loop( 114000,    1000,   50000, 1000000, 20000, 100000);
+    test_open_loop(5000000, 2000000, 1000000,   10000, 200, 100000);
+    //integral limit reached
+    test_open_loop(1300000,   70000,       0,     100, 2000, 100000);
+    test_open_loop( 500000,  500000,  100000,      50, 400, 100000);
+
+    test_closed_loop();
+
+    return test_result("test_pid_fixed");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_plant_identification.cpp
+ * @brief PRBS identification against simulated plants with velocity noise, Coulomb friction and a transport
+ *        delay: J, B, Fc and the delay of rigid plants over two decades of inertia, the resonance of a
+ *        two-mass plant, and no resonance on a rigid plant.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <plant_identification.h>
+}
+
+#define T_S                 333
+#define VELOCITY            200         //operating velocity [rpm]
+#define AMPLITUDE           100         //PRBS amplitude [mNm]
+#define BANDWIDTH           50          //[Hz]
+#define RESOLUTION          65536
+#define NOISE               0.3         //velocity noise [rpm]
+#define SUBSTEPS            32
+#define TWO_PI              6.28318530718
+#define MAX_PERIODS         100000
+
+/**
+ * @brief Plant in the units of PlantModel, the load is rigidly coupled if its inertia is 0.
+ */
+struct Plant {
+    int motor_inertia;      //[g cm^2]
+    int load_inertia;       //[g cm^2]
+    int viscous_friction;   //[uNm/rpm]
+    int coulomb_friction;   //[mNm]
+    int delay;              //[control periods]
+    int resonance;          //[Hz]
+    double damping_ratio;
+};
+
+/**
+ * @brief Runs the identification, the torque reference acts on the motor after the delay.
+ *        The viscous and the Coulomb friction act on the motor.
+ */
+static void identify(const Plant &plant, int resonance, unsigned seed, PlantModel &model)
+{
+    PlantIdentificationParam param;
+    double torque_fifo[PLANT_ID_MAX_DELAY+1] = { 0 };
+    double h = (T_S / 1000000.00) / SUBSTEPS;
+    double jm = plant.motor_inertia * 1.0e-7, jl = plant.load_inertia * 1.0e-7;
+    double viscous = plant.viscous_friction * 1.0e-6 * 60.00 / TWO_PI;     //[Nm s/rad]
+    double stiffness = 0, damping = 0;
+    double motor = VELOCITY * TWO_PI / 60.00, load = motor, twist = 0;
+    int periods = 0;
+
+    if (plant.load_inertia > 0)
+    {
+        //resonance of the two masses: w^2 = stiffness * (1/J_motor + 1/J_load)
+        stiffness = (TWO_PI * plant.resonance) * (TWO_PI * plant.resonance) / ((1.00 / jm) + (1.00 / jl));
+        damping = 2.00 * plant.damping_ratio * sqrt(stiffness / ((1.00 / jm) + (1.00 / jl)));
+    }
+    else
+        jm += jl;
+
+    plant_identification_init(VELOCITY, AMPLITUDE, BANDWIDTH, resonance, RESOLUTION, T_S, param);
+
+    while (param.step != PLANT_ID_DONE && param.step != PLANT_ID_FAILED && periods < MAX_PERIODS)
+    {
+        double velocity = motor * 60.00 / TWO_PI + NOISE * (test_random_range(seed, -1000, 1000) / 1000.00);
+        double torque;
+
+        for (int i=plant.delay; i>0; i--)
+            torque_fifo[i] = torque_fifo[i-1];
+        torque_fifo[0] = plant_identification_update(velocity, param);
+        torque = torque_fifo[plant.delay] / 1000.00;
+
+        for (int i=0; i<SUBSTEPS; i++)
+        {
+            double coupling = (stiffness * twist) + (damping * (motor - load));
+            double friction = (viscous * motor) + ((motor > 0) ? plant.coulomb_friction / 1000.00 : -plant.coulomb_friction / 1000.00);
+
+            motor += ((torque - friction - coupling) / jm) * h;
+            if (plant.load_inertia > 0)
+            {
+                load += (coupling / jl) * h;
+                twist += (motor - load) * h;
+            }
+            else
+                load = motor;
+        }
+        periods++;
+    }
+
+    model = param.model;
+}
+
+static double error_percent(int estimate, int actual)
+{
+    return (100.00 * abs(estimate - actual)) / actual;
+}
+
+static void test_rigid(int inertia, int viscous_friction, int coulomb_friction, int delay)
+{
+    Plant plant = { inertia, 0, viscous_friction, coulomb_friction, delay, 0, 0 };
+    PlantModel model;
+
+    identify(plant, 0, 3, model);
+
+    printf("  rigid    J %5d B %3d Fc %2d d %d: J %5d (%4.1f%%), B %3d (%4.1f%%), Fc %2d (%4.1f%%), d %d, %d Hz\n",
+            inertia, viscous_friction, coulomb_friction, delay,
+            model.moment_of_inertia, error_percent(model.moment_of_inertia, inertia),
+            model.viscous_friction, error_percent(model.viscous_friction, viscous_friction),
+            model.coulomb_friction, error_percent(model.coulomb_friction, coulomb_friction), model.delay, model.bandwidth);
+
+    CHECK(model.status == PLANT_ID_DONE, "J %d: identification failed", inertia);
+    CHECK(error_percent(model.moment_of_inertia, inertia) <= 1, "J %d: J %d", inertia, model.moment_of_inertia);
+    CHECK(error_percent(model.viscous_friction, viscous_friction) <= 10, "J %d: B %d", inertia, model.viscous_friction);
+    CHECK(error_percent(model.coulomb_friction, coulomb_friction) <= 10, "J %d: Fc %d", inertia, model.coulomb_friction);
+    CHECK(model.delay == delay, "J %d: delay %d", inertia, model.delay);
+}
+
+/**
+ * @brief The resonance is searched on a two-mass and on a rigid plant with the same total inertia.
+ */
+static void test_resonance(int frequency, int load_inertia)
+{
+    Plant two_mass = { 3000, load_inertia, 50, 20, 0, frequency, 0.05 };
+    Plant rigid = { 3000 + load_inertia, 0, 50, 20, 0, 0, 0 };
+    PlantModel model;
+
+    identify(two_mass, 1, 3, model);
+    printf("  two-mass %3d Hz, zeta 0.050: %3d Hz, zeta %.3f, J %5d (%d), bandwidth %d Hz\n", frequency,
+            model.resonance_frequency, model.resonance_damping / 1000.00, model.moment_of_inertia,
+            3000 + load_inertia, model.bandwidth);
+    CHECK(model.status == PLANT_ID_DONE, "%d Hz: identification failed", frequency);
+    CHECK(abs(model.resonance_frequency - frequency) * 100 <= 3 * frequency, "%d Hz: resonance %d Hz", frequency, model.resonance_frequency);
+    CHECK(abs(model.resonance_damping - 50) <= 10, "%d Hz: damping %d per thousand", frequency, model.resonance_damping);
+    CHECK(error_percent(model.moment_of_inertia, 3000 + load_inertia) <= 5, "%d Hz: J %d", frequency, model.moment_of_inertia);
+    CHECK(model.bandwidth * 3 <= frequency, "%d Hz: bandwidth %d Hz above a third of the resonance", frequency, model.bandwidth);
+
+    identify(rigid, 1, 3, model);
+    printf("  rigid    J %5d, resonant fit: %d Hz\n", rigid.motor_inertia, model.resonance_frequency);
+    CHECK(model.status == PLANT_ID_DONE, "rigid: identification failed");
+    CHECK(model.resonance_frequency == 0, "rigid: false resonance at %d Hz", model.resonance_frequency);
+}
+
+int main(void)
+{
+    printf("test_plant_identification, %d rpm, PRBS %d mNm, noise %.1f rpm\n", VELOCITY, AMPLITUDE, NOISE);
+
+    test_rigid(500, 20, 10, 0);
+    test_rigid(3000, 50, 20, 1);
+    test_rigid(3000, 200, 40, 2);
+    test_rigid(20000, 100, 30, 3);
+    test_resonance(250, 3000);
+    test_resonance(500, 3000);
+
+    return test_result("test_plant_identification");
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_position_feedforward.cpp
+ * @brief Velocity and acceleration feed-forward of the cascaded position controller of
+ *        motion_control_service() on the plant model: the following error of an S-curve move must drop
+ *        with the velocity feed-forward and further with the acceleration feed-forward, and the move
+ *        must still end at the target.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <string.h>
+#include "test.h"
+
+extern "C" {
+#include <plant_model.h>
+#include <controllers.h>
+#include <profile.h>
+}
+
+#define PERIOD              POSITION_CONTROL_LOOP_PERIOD
+#define PLANT_SUBSTEPS      9
+#define RESOLUTION          65536
+#define INERTIA             200         //[g cm^2]
+#define POSITION_KP         114000      //about 20 Hz bandwidth
+#define POSITION_INTEGRAL_LIMIT 12000
+#define VELOCITY_KP         1300000     //about 100 Hz bandwidth
+#define VELOCITY_KI         70000
+#define VELOCITY_INTEGRAL_LIMIT 1000
+#define MAX_MOTOR_SPEED     5000        //[rpm]
+#define MAX_TORQUE          1000        //[mNm]
+#define TURNS               10
+#define PROFILE_VELOCITY    2000        //[rpm]
+#define PROFILE_ACCELERATION 10000      //[rpm/s]
+#define PROFILE_JERK        100000      //[rpm/s^2]
+#define DURATION            0.8         //move and settling [s]
+
+/**
+ * @brief Moves TURNS turns with the S-curve profiler, returns the peak following error [ticks].
+ *        The reference history and the order of the updates are those of motion_control_service().
+ */
+static double run(int velocity_feedforward, int acceleration_feedforward, int &final_error)
+{
+    PlantModelConfig config = { RESOLUTION, INERTIA, 50, 20, 30, 200, MAX_TORQUE, 50, 2000 };
+    PlantModelState plant;
+    PIDparam position_pid, velocity_pid;
+    ProfilerParam profiler;
+    ScurveProfilerState scurve;
+    double position_ref_k_1n, position_ref_k_2n, position_ref_k_3n, peak = 0;
+    int start, target;
+
+    plant_model_init(config, plant);
+    plant_model_set_brake(plant, 1);
+    for (int i=0; i<(int)((config.brake_release_time * 1000) / PERIOD) + 1; i++)
+        plant_model_update(plant, 0, PERIOD);
+
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.delta_T = PERIOD / 1000000.00;
+    profiler.resolution = RESOLUTION;
+    profiler.v_max = PROFILE_VELOCITY;
+    profiler.acceleration_max = PROFILE_ACCELERATION;
+    profiler.deceleration_max = PROFILE_ACCELERATION;
+    profiler.jerk_max = PROFILE_JERK;
+
+    pid_init(position_pid);
+    pid_set_parameters(POSITION_KP, 0, 0, POSITION_INTEGRAL_LIMIT, PERIOD, position_pid);
+    pid_init(velocity_pid);
+    pid_set_parameters(VELOCITY_KP, VELOCITY_KI, 0, VELOCITY_INTEGRAL_LIMIT, PERIOD, velocity_pid);
+
+    start = plant_model_get_position(plant);
+    target = start + TURNS * RESOLUTION;
+    position_pid.actual_value_1n = start;
+    position_ref_k_1n = position_ref_k_2n = position_ref_k_3n = start;
+    scurve_profiler_init(start, 0.00, scurve);
+
+    for (int k=0; k<(int)(DURATION / (PERIOD / 1000000.00)); k++)
+    {
+        int position = plant_model_get_position(plant);
+        int velocity = plant_model_get_velocity(plant);
+        double position_ref_k = scurve_pos_profiler(target, profiler, scurve);
+        double velocity_feedforward_k, torque_feedforward_k, velocity_ref_k, torque_ref_k;
+
+        position_ref_k_3n = position_ref_k_2n;
+        position_ref_k_2n = position_ref_k_1n;
+        position_ref_k_1n = position_ref_k;
+
+        position_feedforward(position_ref_k_1n, position_ref_k_2n, position_ref_k_3n, velocity_feedforward, acceleration_feedforward,
+                INERTIA, RESOLUTION, PERIOD, velocity_feedforward_k, torque_feedforward_k);
+
+        velocity_ref_k = pid_update(position_ref_k, position, PERIOD, position_pid) + velocity_feedforward_k;
+        if (velocity_ref_k > MAX_MOTOR_SPEED) velocity_ref_k = MAX_MOTOR_SPEED;
+        if (velocity_ref_k < -MAX_MOTOR_SPEED) velocity_ref_k = -MAX_MOTOR_SPEED;
+        torque_ref_k = pid_update(velocity_ref_k, velocity, PERIOD, velocity_pid) + torque_feedforward_k;
+        if (torque_ref_k > MAX_TORQUE) torque_ref_k = MAX_TORQUE;
+        if (torque_ref_k < -MAX_TORQUE) torque_ref_k = -MAX_TORQUE;
+
+        for (int i=0; i<PLANT_SUBSTEPS; i++)
+            plant_model_update(plant, (int)lround(torque_ref_k), PERIOD / PLANT_SUBSTEPS);
+
+        if (fabs(position_ref_k - position) > peak)
+            peak = fabs(position_ref_k - position);
+    }
+    final_error = target - plant_model_get_position(plant);
+
+    return peak;
+}
+
+int main(void)
+{
+    int final_off, final_velocity, final_both;
+    double off, velocity, both;
+
+    printf("test_position_feedforward, J %d g cm^2, S-curve of %d turns at %d rpm, %d rpm/s, %d rpm/s^2\n",
+            INERTIA, TURNS, PROFILE_VELOCITY, PROFILE_ACCELERATION, PROFILE_JERK);
+
+    off = run(0, 0, final_off);
+    velocity = run(1000, 0, final_velocity);
+    both = run(1000, 1000, final_both);
+
+    printf("  peak following error: %.0f ticks without feed-forward, %.0f ticks with the velocity, %.0f ticks with both\n",
+            off, velocity, both);
+    printf("  final error: %d, %d, %d ticks\n", final_off, final_velocity, final_both);
+
+    CHECK(velocity * 20 < off, "velocity feed-forward: %.0f ticks against %.0f ticks", velocity, off);
+    CHECK(both < velocity, "acceleration feed-forward: %.0f ticks against %.0f ticks", both, velocity);
+    CHECK(both < 200, "%.0f ticks with both feed-forwards", both);
+    CHECK(abs(final_velocity) <= 10 && abs(final_both) <= 10, "final error %d, %d ticks", final_velocity, final_both);
+
+    return test_result("test_position_feedforward");
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_profile_table.cpp
+ * @brief Playback of precomputed position profile tables against the evaluated profile at the period of
+ *        the position control loop, for slow and fast moves of high resolution encoders, plain and negated
+ *        for the inverted polarity, with an absolute limit of the interpolation error.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <profile.h>
+}
+
+#define TABLE_SIZE      1024
+#define DELTA_T         0.000333    //period of the position control loop [s]
+
+static short buffer[TABLE_SIZE];
+
+static int escapes(ProfileTable &table)
+{
+    int count = 0;
+
+    for (int k=0; k<table.length; k++)
+    {
+        if (buffer[k] == PROFILE_TABLE_ESCAPE)
+        {
+            count++;
+            k += 2;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Builds the table of a move with the smallest decimation that fits as set_profile_position_table()
+ *        does, plays it (negated if inverted) and compares each step with the profile evaluated directly.
+ *        Tables with an error above 1/PROFILE_TABLE_MAX_ERROR_DIVISOR turn have to be rejected.
+ */
+static void test_move(int resolution, int start, int target, int velocity, int acceleration, int inverted, int accepted)
+{
+    profile_position_param profile, reference;
+    ProfileTable table;
+    int length = -1, max_error = 0, steps, position = 0, limit = resolution / PROFILE_TABLE_MAX_ERROR_DIVISOR;
+
+    profile.position_feedback_params.resolution = resolution;
+    __initialize_position_profile_limits(acceleration, velocity, 0, INT_MAX, -INT_MAX, profile);
+    for (int log2_decimation = 0; log2_decimation <= PROFILE_TABLE_MAX_LOG2_DECIMATION && length < 0; log2_decimation++)
+    {
+        __initialize_position_profile(target, start, velocity, acceleration, acceleration, profile);
+        reference = profile;
+        length = profile_table_build_lfpb(profile, DELTA_T, log2_decimation, table, buffer, TABLE_SIZE);
+    }
+    CHECK(length > 0, "%d ticks at %d rpm does not fit into the table", target - start, velocity);
+    if (length <= 0)
+        return;
+
+    if (inverted)
+        profile_table_negate(table, buffer);
+
+    //same steps as profile_table_build_lfpb()
+    reference.s_time = (float) DELTA_T;
+    steps = (int) (reference.tf / DELTA_T);
+    for (int i=1; !profile_table_done(table); i++)
+    {
+        int expected = i <= steps ? __position_profile_generate_in_steps(i, reference) : target;
+        position = profile_table_next(table, buffer);
+        if (inverted)
+            expected = -expected;
+        if (abs(position - expected) > max_error)
+            max_error = abs(position - expected);
+    }
+
+    printf("  %11d ticks at %4d rpm%s: %4d entries (%2d escaped), decimation %3d, max error %5d ticks (limit %3d), %s\n",
+            target - start, velocity, inverted ? " inverted" : "         ", length, escapes(table), 1 << table.log2_decimation,
+            max_error, limit, table.max_error <= limit ? "table" : "step by step");
+    CHECK(position == (inverted ? -target : target), "ends at %d", position);
+    //the negated interpolation may round the other way
+    CHECK(max_error <= table.max_error + (inverted ? 1 : 0), "max error %d, reported %d", max_error, table.max_error);
+    CHECK((table.max_error <= limit) == accepted, "error %d ticks, limit %d ticks", table.max_error, limit);
+}
+
+/**
+ * @brief Jerk limited profile, the error reported by the builder against a second evaluation.
+ */
+static void test_scurve(double target, int log2_decimation)
+{
+    ProfilerParam param;
+    ScurveProfilerState state, reference;
+    ProfileTable table;
+    double position;
+    int length, max_error = 0, done = 0;
+
+    memset(&param, 0, sizeof(param));
+    param.delta_T = DELTA_T;
+    param.resolution = 262144;
+    param.v_max = 3000;
+    param.acceleration_max = 10000;
+    param.deceleration_max = 10000;
+    param.jerk_max = 100000;
+    scurve_profiler_init(0.00, 0.00, state);
+    reference = state;
+
+    length = profile_table_build_scurve(target, param, state, log2_decimation, table, buffer, TABLE_SIZE);
+    CHECK(length > 0, "S-curve of %.0f ticks does not fit", target);
+    if (length <= 0)
+        return;
+
+    while (!profile_table_done(table))
+    {
+        int expected = (int) target, played = profile_table_next(table, buffer);
+
+        if (!done)
+        {
+            position = scurve_pos_profiler(target, param, reference);
+            expected = (int) round(position);
+            done = (position == target && reference.velocity == 0);
+        }
+        if (abs(played - expected) > max_error)
+            max_error = abs(played - expected);
+    }
+
+    printf("  S-curve %9.0f ticks     : %4d entries (%2d escaped), decimation %3d, max error %5d ticks\n",
+            target, length, escapes(table), 1 << table.log2_decimation, max_error);
+    CHECK(max_error == table.max_error, "max error %d, reported %d", max_error, table.max_error);
+}
+
+int main(void)
+{
+    ProfileTable table;
+    int deltas[] = { 100, 100000, -100000, 5, 2000000000, -2000000000, 7 }, position;
+
+    printf("test_profile_table\n");
+
+    test_move(65536, 0, 500000, 1000, 10000, 0, 1);
+    //18 bit encoder at 5000 rpm, the deltas are far beyond 16 bit at every decimation, the changes are not
+    test_move(262144, -10000000, 20000000, 5000, 20000, 0, 1);
+    test_move(262144, -10000000, 20000000, 5000, 20000, 1, 1);
+    //about 50 s, the interpolation over 256 steps deviates by far more than 1/1000 turn
+    test_move(262144, 500000000, -600000000, 5000, 5000, 1, 0);
+    test_scurve(3000000, 2);
+    test_scurve(-20000000, 4);
+
+    //changes which do not fit into 16 bit are escaped, negation included
+    profile_table_init(0, 0, table);
+    position = 0;
+    for (unsigned k=0; k<sizeof(deltas)/sizeof(deltas[0]); k++)
+    {
+        position += deltas[k];
+        CHECK(profile_table_append(position, table, buffer, TABLE_SIZE) == 0, "delta %d rejected", deltas[k]);
+    }
+    CHECK(table.length == 1 + 3 + 3 + 3 + 3 + 3 + 3, "%d entries", table.length);
+    profile_table_negate(table, buffer);
+    position = 0;
+    for (unsigned k=0; k<sizeof(deltas)/sizeof(deltas[0]); k++)
+    {
+        int played = profile_table_next(table, buffer);
+        position -= deltas[k];
+        CHECK(played == position, "step %u at %d, expected %d", k, played, position);
+    }
+    CHECK(profile_table_done(table), "not done");
+
+    //a full buffer rejects the step without changing the table
+    profile_table_init(0, 0, table);
+    CHECK(profile_table_append(100000, table, buffer, 2) == -1 && table.length == 0, "escape beyond the buffer accepted");
+
+    //deltas whose negation overflows are rejected
+    profile_table_init(INT_MAX, 0, table);
+    CHECK(profile_table_append(0, table, buffer, TABLE_SIZE) == 0, "delta -INT_MAX rejected");
+    profile_table_init(INT_MAX, 0, table);
+    CHECK(profile_table_append(-1, table, buffer, TABLE_SIZE) == -1, "delta INT_MIN accepted");
+    profile_table_init(INT_MIN + 1, 0, table);
+    CHECK(profile_table_append(0, table, buffer, TABLE_SIZE) == 0, "delta INT_MAX rejected");
+
+    return test_result("test_profile_table");
+}
@@ -0,0 +1,124 @@
+/**
+ * @file test_profile_threads.cpp
+ * @brief Profiles of every type generated in parallel threads, each thread with its own contexts,
+ *        must equal the same profiles generated one after the other. Built with ThreadSanitizer by
+ *        make tsan, which also reports any state shared between the contexts.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <pthread.h>
+#include "test.h"
+
+extern "C" {
+#include <profile.h>
+}
+
+#define N_THREADS           16
+#define N_PROFILES          50
+#define TICKS_PER_TURN      65536
+
+enum { PROFILE_POSITION, PROFILE_VELOCITY, PROFILE_LINEAR, PROFILE_QUICK_STOP_POSITION, PROFILE_QUICK_STOP_VELOCITY, N_TYPES };
+
+static const char *type_names[N_TYPES] = { "position", "velocity", "linear", "quick stop position", "quick stop velocity" };
+
+struct Job {
+    pthread_t thread;
+    int axis;
+    unsigned long long checksum[N_TYPES];
+    int samples[N_TYPES];
+};
+
+static void add(Job &job, int type, int value)
+{
+    job.checksum[type] = job.checksum[type] * 1000003ull + (unsigned)value;
+    job.samples[type]++;
+}
+
+/**
+ * @brief Profiles of one axis, the parameters depend on the axis and the profile number.
+ */
+static void generate_profiles(Job &job)
+{
+    profile_position_param position;
+    profile_velocity_param velocity;
+    profile_linear_param linear;
+    profile_position_quick_stop_param quick_stop_position;
+    profile_velocity_quick_stop_param quick_stop_velocity;
+    unsigned seed = 1000 + job.axis;
+
+    position.position_feedback_params.resolution = TICKS_PER_TURN;
+    __initialize_position_profile_limits(10000, 5000, 0, 100000000, -100000000, position);
+
+    for (int p=0; p<N_PROFILES; p++)
+    {
+        int start = test_random_range(seed, -1000000, 1000000);
+        int target = test_random_range(seed, -1000000, 1000000);
+        int speed = test_random_range(seed, 100, 4000);
+        int acceleration = test_random_range(seed, 500, 8000);
+        int steps;
+
+        steps = __initialize_position_profile(target, start, speed, acceleration, acceleration, position);
+        for (int i=1; i<=steps; i++)
+            add(job, PROFILE_POSITION, __position_profile_generate_in_steps(i, position));
+
+        steps = __initialize_velocity_profile(speed, -speed/2, acceleration, acceleration, 5000, velocity);
+        for (int i=1; i<=steps; i++)
+            add(job, PROFILE_VELOCITY, __velocity_profile_generate_in_steps(i, velocity));
+
+        steps = __init_linear_profile_float(speed, 0, acceleration, acceleration, 5000, linear);
+        for (int i=1; i<=steps; i++)
+            add(job, PROFILE_LINEAR, (int)__linear_profile_generate_float(i, linear));
+
+        steps = __initialize_quick_stop_position_profile(speed, start, acceleration, quick_stop_position);
+        for (int i=1; i<=steps; i++)
+            add(job, PROFILE_QUICK_STOP_POSITION, __quick_stop_position_profile_generate_in_steps(i, quick_stop_position));
+
+        steps = __initialize_quick_stop_velocity_profile(speed, acceleration, quick_stop_velocity);
+        for (int i=1; i<=steps; i++)
+            add(job, PROFILE_QUICK_STOP_VELOCITY, __quick_stop_velocity_profile_generate_in_steps(i, quick_stop_velocity));
+    }
+}
+
+static void *run_job(void *arg)
+{
+    generate_profiles(*(Job *)arg);
+    return NULL;
+}
+
+int main(void)
+{
+    static Job sequential[N_THREADS], parallel[N_THREADS];
+
+    printf("test_profile_threads, %d threads, %d profiles of each type per thread\n", N_THREADS, N_PROFILES);
+
+    for (int i=0; i<N_THREADS; i++)
+    {
+        sequential[i].axis = i;
+        generate_profiles(sequential[i]);
+    }
+
+    for (int i=0; i<N_THREADS; i++)
+    {
+        parallel[i].axis = i;
+        pthread_create(&parallel[i].thread, NULL, run_job, &parallel[i]);
+    }
+    for (int i=0; i<N_THREADS; i++)
+        pthread_join(parallel[i].thread, NULL);
+
+    for (int type=0; type<N_TYPES; type++)
+    {
+        int samples = 0, differ = 0;
+
+        for (int i=0; i<N_THREADS; i++)
+        {
+            samples += parallel[i].samples[type];
+            if (parallel[i].checksum[type] != sequential[i].checksum[type] || parallel[i].samples[type] != sequential[i].samples[type])
+                differ++;
+        }
+        printf("  %-20s %8d samples, %d of %d axes differ\n", type_names[type], samples, differ, N_THREADS);
+        CHECK(differ == 0, "%s: %d axes differ", type_names[type], differ);
+        CHECK(samples > N_THREADS * N_PROFILES, "%s: only %d samples", type_names[type], samples);
+    }
+
+    return test_result("test_profile_threads");
+}
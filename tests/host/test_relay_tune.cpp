@@ -0,0 +1,142 @@
+/**
+ * @file test_relay_tune.cpp
+ * @brief Relay feedback tuner of the cascaded position controller against the plant model, with the
+ *        sequencing of motion_control_service() and the defaults of auto_tune.h: the tuning must take
+ *        less than 2 s and less than 1% of the travel of the step based tuner (2 x AUTO_TUNE_STEP_AMPLITUDE),
+ *        and the tuned cascade must settle a position step without a limit cycle.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <plant_model.h>
+#include <controllers.h>
+#include <auto_tune.h>
+}
+
+#define PERIOD              POSITION_CONTROL_LOOP_PERIOD
+#define PLANT_SUBSTEPS      9
+#define NOISE               1           //velocity noise [rpm]
+#define INTEGRAL_LIMIT      1000
+#define MAX_MOTOR_SPEED     5000        //[rpm]
+#define STEP                2000        //position step after the tuning [ticks]
+#define STEP_TIME           1.0         //duration of the position step [s]
+#define STEP_TUNER_TRAVEL   (2 * AUTO_TUNE_STEP_AMPLITUDE)
+
+/**
+ * @brief Tunes, then steps the position by STEP with the tuned gains. Returns the duration of the tuning [s].
+ */
+static double tune(PlantModelConfig config, int &travel, int &final_error, int &ripple, RelayTuneParam &tuner)
+{
+    PlantModelState plant;
+    PIDparam velocity_pid, position_pid;
+    unsigned seed = 5;
+    int position_min = 0, position_max = 0, k = 0, start, target;
+    int window_min = 0, window_max = 0;
+    double duration;
+
+    plant_model_init(config, plant);
+    plant_model_set_brake(plant, 1);
+    for (int i=0; i<(int)((config.brake_release_time * 1000) / PERIOD) + 1; i++)
+        plant_model_update(plant, 0, PERIOD);
+
+    relay_tune_init(RELAY_TUNE_TORQUE_AMPLITUDE, RELAY_TUNE_VELOCITY_AMPLITUDE, RELAY_TUNE_VELOCITY_HYSTERESIS,
+            RELAY_TUNE_POSITION_HYSTERESIS, RELAY_TUNE_CYCLES, RELAY_TUNE_RULE, PERIOD, tuner);
+    pid_init(velocity_pid);
+    pid_init(position_pid);
+
+    while (tuner.step == RELAY_TUNE_VELOCITY_LOOP || tuner.step == RELAY_TUNE_POSITION_LOOP)
+    {
+        int position = plant_model_get_position(plant);
+        int velocity = plant_model_get_velocity(plant) + test_random_range(seed, -NOISE, NOISE);
+        double torque = 0;
+
+        if (position < position_min) position_min = position;
+        if (position > position_max) position_max = position;
+
+        if (tuner.step == RELAY_TUNE_VELOCITY_LOOP)
+        {
+            torque = relay_tune_update(velocity, tuner);
+            if (tuner.step == RELAY_TUNE_POSITION_LOOP)
+                pid_set_parameters(tuner.velocity_kp, tuner.velocity_ki, tuner.velocity_kd, INTEGRAL_LIMIT, PERIOD, velocity_pid);
+        }
+        else
+        {
+            double velocity_ref = relay_tune_update(position, tuner);
+            torque = pid_update(velocity_ref, velocity, PERIOD, velocity_pid);
+        }
+
+        for (int i=0; i<PLANT_SUBSTEPS; i++)
+            plant_model_update(plant, (int)lround(torque), PERIOD / PLANT_SUBSTEPS);
+        k++;
+    }
+    duration = k * (PERIOD / 1000000.00);
+    travel = position_max - position_min;
+    if (tuner.step != RELAY_TUNE_DONE)
+        return duration;
+
+    //position step with the tuned cascade
+    pid_set_parameters(tuner.position_kp, tuner.position_ki, tuner.position_kd, 12000, PERIOD, position_pid);
+    start = plant_model_get_position(plant);
+    position_pid.actual_value_1n = start;
+    target = start + STEP;
+    for (int j=0; j<(int)(STEP_TIME / (PERIOD / 1000000.00)); j++)
+    {
+        int position = plant_model_get_position(plant);
+        int velocity = plant_model_get_velocity(plant) + test_random_range(seed, -NOISE, NOISE);
+        double velocity_ref = pid_update(target, position, PERIOD, position_pid);
+        double torque;
+
+        if (velocity_ref > MAX_MOTOR_SPEED) velocity_ref = MAX_MOTOR_SPEED;
+        if (velocity_ref < -MAX_MOTOR_SPEED) velocity_ref = -MAX_MOTOR_SPEED;
+        torque = pid_update(velocity_ref, velocity, PERIOD, velocity_pid);
+        for (int i=0; i<PLANT_SUBSTEPS; i++)
+            plant_model_update(plant, (int)lround(torque), PERIOD / PLANT_SUBSTEPS);
+
+        //the last 200 ms
+        if (j == (int)((STEP_TIME - 0.20) / (PERIOD / 1000000.00)))
+            window_min = window_max = position;
+        if (position < window_min) window_min = position;
+        if (position > window_max) window_max = position;
+    }
+    final_error = target - plant_model_get_position(plant);
+    ripple = window_max - window_min;
+
+    return duration;
+}
+
+static void test_plant(int inertia, int viscous_friction, int coulomb_friction)
+{
+    PlantModelConfig config = { 65536, inertia, viscous_friction, coulomb_friction, coulomb_friction + 10, 200, 1000, 50, 2000 };
+    RelayTuneParam tuner;
+    int travel, final_error = 0, ripple = 0;
+    double duration = tune(config, travel, final_error, ripple, tuner);
+
+    printf("  J %5d g cm^2, B %3d uNm/rpm, Fc %2d mNm: %.3f s, travel %3d ticks (%.2f%%), velocity kp %7d ki %5d, position kp %6d ki %3d kd %6d,"
+            " step error %d, ripple %d ticks\n",
+            inertia, viscous_friction, coulomb_friction, duration, travel, (100.00 * travel) / STEP_TUNER_TRAVEL,
+            tuner.velocity_kp, tuner.velocity_ki, tuner.position_kp, tuner.position_ki, tuner.position_kd, final_error, ripple);
+
+    CHECK(tuner.step == RELAY_TUNE_DONE, "J %d: tuning failed", inertia);
+    CHECK(duration < 2.00, "J %d: tuning took %.3f s", inertia, duration);
+    CHECK(travel * 100 < STEP_TUNER_TRAVEL, "J %d: travel %d ticks", inertia, travel);
+    CHECK(abs(final_error) <= 20, "J %d: error %d ticks %.1f s after the step", inertia, final_error, STEP_TIME);
+    CHECK(ripple <= 20, "J %d: limit cycle of %d ticks after the step", inertia, ripple);
+}
+
+int main(void)
+{
+    printf("test_relay_tune, relay %d mNm / %d rpm, hysteresis %d rpm / %d ticks, %d cycles, rule %d\n",
+            RELAY_TUNE_TORQUE_AMPLITUDE, RELAY_TUNE_VELOCITY_AMPLITUDE, RELAY_TUNE_VELOCITY_HYSTERESIS,
+            RELAY_TUNE_POSITION_HYSTERESIS, RELAY_TUNE_CYCLES, RELAY_TUNE_RULE);
+
+    test_plant(300, 10, 5);
+    test_plant(3000, 50, 20);
+    test_plant(30000, 50, 20);
+    test_plant(3000, 200, 40);
+
+    return test_result("test_relay_tune");
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_sample_ring.cpp
+ * @brief Lag of the position feedback with and without the latency compensation of the sample ring.
+ *        The sensor and the motion control loop have their own time bases which both overflow during
+ *        the trace, the sensor timestamps are 32 bit timer ticks divided by the ticks per microsecond.
+ *        The compensation removes the age of the samples beyond the smallest age (MIN_AGE), which
+ *        can't be told apart from the offset between the time bases.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <sample_ring.h>
+}
+
+#define LOOP_PERIOD         1000        //motion control period [microseconds]
+#define SENSOR_PERIOD       100         //sensor read period [microseconds]
+#define SENSOR_USEC         250         //timer ticks per microsecond of the sensor tile
+#define APP_USEC            100         //timer ticks per microsecond of the motion control tile
+#define MAX_HORIZON         2000
+#define TRACE_LENGTH        4000000     //[microseconds]
+#define SENSOR_WRAP_TIME    1000000     //time of the overflow of the sensor timer [microseconds]
+#define APP_WRAP_TIME       2500000     //time of the overflow of the motion control timer [microseconds]
+#define MIN_AGE             SENSOR_PERIOD   //smallest age of a sample in the trace [microseconds]
+#define WRAP_WINDOW         20000       //time around the overflows evaluated separately [microseconds]
+#define TWO_PI              6.28318530718
+
+static double true_position(double t)
+{
+    return 100000.00 * sin(TWO_PI * 2.00 * t * 1.0e-6) + 0.50 * t;
+}
+
+/**
+ * @brief Timestamp in microseconds of a 32 bit timer overflowing at wrap_time.
+ */
+static unsigned int timestamp(double t, int usec, double wrap_time)
+{
+    unsigned int ticks = (unsigned int)(unsigned long long)(4294967296.00 + (t - wrap_time) * usec);
+    return ticks / usec;
+}
+
+struct LagStatistics {
+    double square_sum;
+    double max;
+    int n;
+
+    void add(double error)
+    {
+        square_sum += error * error;
+        if (fabs(error) > max)
+            max = fabs(error);
+        n++;
+    }
+
+    double rms(void) const
+    {
+        return n ? sqrt(square_sum / n) : 0;
+    }
+};
+
+int main(void)
+{
+    SampleRing ring;
+    unsigned int clock_offset = 0;
+    unsigned seed = 3;
+    LagStatistics raw = {0, 0, 0}, compensated = {0, 0, 0};
+    LagStatistics raw_wrap = {0, 0, 0}, compensated_wrap = {0, 0, 0};
+    LagStatistics beyond_min_age = {0, 0, 0};
+
+    printf("test_sample_ring\n");
+
+    sample_ring_init(ring);
+    for (double t_now = LOOP_PERIOD; t_now < TRACE_LENGTH; t_now += LOOP_PERIOD)
+    {
+        //newest sensor sample which reached the motion control loop: age between 20 and 320 microseconds
+        int delay = test_random_range(seed, 20, 220);
+        double t_sample = floor((t_now - delay) / SENSOR_PERIOD) * SENSOR_PERIOD;
+        int position = (int)lround(true_position(t_sample));
+
+        int feedback = sample_ring_compensate_latency(ring, clock_offset, position,
+                timestamp(t_sample, SENSOR_USEC, SENSOR_WRAP_TIME), timestamp(t_now, APP_USEC, APP_WRAP_TIME), MAX_HORIZON);
+
+        double error_raw = true_position(t_now) - position;
+        double error_compensated = true_position(t_now) - feedback;
+
+        if (t_now < 4 * LOOP_PERIOD)
+            continue;
+        raw.add(error_raw);
+        compensated.add(error_compensated);
+        beyond_min_age.add(true_position(t_now - MIN_AGE) - feedback);
+        if (fabs(t_now - SENSOR_WRAP_TIME) < WRAP_WINDOW || fabs(t_now - APP_WRAP_TIME) < WRAP_WINDOW)
+        {
+            raw_wrap.add(error_raw);
+            compensated_wrap.add(error_compensated);
+        }
+    }
+
+    printf("  lag whole trace      : rms %7.1f ticks, max %7.1f ticks without, rms %7.1f ticks, max %7.1f ticks with compensation\n",
+            raw.rms(), raw.max, compensated.rms(), compensated.max);
+    printf("  lag around overflows : rms %7.1f ticks, max %7.1f ticks without, rms %7.1f ticks, max %7.1f ticks with compensation\n",
+            raw_wrap.rms(), raw_wrap.max, compensated_wrap.rms(), compensated_wrap.max);
+    printf("  error to the position %d microseconds ago: rms %7.1f ticks, max %7.1f ticks with compensation\n",
+            MIN_AGE, beyond_min_age.rms(), beyond_min_age.max);
+
+    CHECK(compensated.rms() < 0.60 * raw.rms(), "rms %.1f not reduced enough from %.1f", compensated.rms(), raw.rms());
+    CHECK(beyond_min_age.rms() < 0.10 * raw.rms(), "rms %.1f of the age beyond the minimum", beyond_min_age.rms());
+    //the overflows may restart the estimation, but the feedback must not get worse than without compensation
+    CHECK(compensated_wrap.max <= raw_wrap.max, "max %.1f around the overflows above %.1f", compensated_wrap.max, raw_wrap.max);
+
+    return test_result("test_sample_ring");
+}
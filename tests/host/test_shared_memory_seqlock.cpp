@@ -0,0 +1,312 @@
+/**
+ * @file test_shared_memory_seqlock.cpp
+ * @brief Stress test of the lock-free shared memory with one writer and several readers running
+ *        in parallel threads. Every snapshot must be consistent. The latencies of the lock-free
+ *        reads and writes are compared with the same copies protected by a mutex and with
+ *        transactions to a service thread which owns the data (the interface based shared memory).
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "test.h"
+
+extern "C" {
+#include <shared_memory_seqlock.h>
+}
+
+#define N_WRITES        2000000
+#define N_SERVICE_WRITES 200000
+#define N_READERS       3
+#define HISTOGRAM_NS    100000
+
+/**
+ * @brief Latencies in 1 ns bins, the last bin counts everything longer.
+ */
+struct Latency {
+    unsigned long long count[HISTOGRAM_NS + 1];
+    unsigned long long n;
+    double max;
+
+    void add(double ns)
+    {
+        int bin = ns < HISTOGRAM_NS ? (int)ns : HISTOGRAM_NS;
+        count[bin]++;
+        n++;
+        if (ns > max)
+            max = ns;
+    }
+
+    void merge(const Latency &other)
+    {
+        for (int i=0; i<=HISTOGRAM_NS; i++)
+            count[i] += other.count[i];
+        n += other.n;
+        if (other.max > max)
+            max = other.max;
+    }
+
+    int percentile(double p) const
+    {
+        unsigned long long limit = (unsigned long long)(p * n), seen = 0;
+        for (int i=0; i<=HISTOGRAM_NS; i++)
+        {
+            seen += count[i];
+            if (seen > limit)
+                return i;
+        }
+        return HISTOGRAM_NS;
+    }
+};
+
+static SharedMemoryBlocks blocks;
+static volatile int writer_done;
+
+enum AccessMode { ACCESS_LOCK_FREE, ACCESS_MUTEX, ACCESS_SERVICE };
+
+static const char *access_mode_name[] = { "lock-free", "mutex", "service" };
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static UpstreamControlData locked_data;
+
+/*
+ * Message passing baseline: like the interface calls to shared_memory_service, every read and write
+ * is a transaction handled one at a time by the service thread, the client waits for the reply.
+ */
+struct Transaction {
+    int write;
+    int done;
+    UpstreamControlData data;
+    pthread_cond_t reply;
+    Transaction *next;
+};
+
+static pthread_mutex_t service_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t service_request = PTHREAD_COND_INITIALIZER;
+static Transaction *service_queue_head, *service_queue_tail;
+static volatile int service_stop;
+static UpstreamControlData service_data;
+
+static void *service(void *arg)
+{
+    pthread_mutex_lock(&service_mutex);
+    while (1)
+    {
+        while (!service_queue_head && !service_stop)
+            pthread_cond_wait(&service_request, &service_mutex);
+        if (!service_queue_head)
+            break;
+
+        Transaction *t = service_queue_head;
+        service_queue_head = t->next;
+        if (!service_queue_head)
+            service_queue_tail = NULL;
+
+        if (t->write)
+            service_data = t->data;
+        else
+            t->data = service_data;
+        t->done = 1;
+        pthread_cond_signal(&t->reply);
+    }
+    pthread_mutex_unlock(&service_mutex);
+
+    return NULL;
+}
+
+static void service_transaction(Transaction &t)
+{
+    pthread_mutex_lock(&service_mutex);
+    t.done = 0;
+    t.next = NULL;
+    if (service_queue_tail)
+        service_queue_tail->next = &t;
+    else
+        service_queue_head = &t;
+    service_queue_tail = &t;
+    pthread_cond_signal(&service_request);
+    while (!t.done)
+        pthread_cond_wait(&t.reply, &service_mutex);
+    pthread_mutex_unlock(&service_mutex);
+}
+
+struct Reader {
+    pthread_t thread;
+    AccessMode mode;
+    unsigned long long reads;
+    unsigned long long inconsistent;
+    unsigned long long backwards;
+    Latency latency;
+};
+
+static Latency write_latency;
+
+/*
+ * The writer keeps the fields of a block related to each other, a torn snapshot breaks the relation:
+ * velocity = -position, timestamp = 3 * position, angle = velocity modulo 4096.
+ */
+static void *writer(void *arg)
+{
+    AccessMode mode = *(AccessMode *)arg;
+    int n_writes = mode == ACCESS_SERVICE ? N_SERVICE_WRITES : N_WRITES;
+    Transaction t;
+
+    pthread_cond_init(&t.reply, NULL);
+    for (int i=1; i<=n_writes; i++)
+    {
+        double start = test_time_ns();
+        if (mode == ACCESS_SERVICE)
+        {
+            t.write = 1;
+            t.data.position = i;
+            t.data.velocity = -i;
+            t.data.sensor_timestamp = 3u * i;
+            t.data.angle = i & 4095;
+            t.data.angle_velocity = i;
+            service_transaction(t);
+        }
+        else if (mode == ACCESS_MUTEX)
+        {
+            pthread_mutex_lock(&mutex);
+            locked_data.position = i;
+            locked_data.velocity = -i;
+            locked_data.sensor_timestamp = 3u * i;
+            locked_data.angle = i & 4095;
+            locked_data.angle_velocity = i;
+            pthread_mutex_unlock(&mutex);
+        }
+        else
+        {
+            shared_memory_write_angle(blocks, i & 4095, i & 7, i, SENSOR_NO_ERROR, SENSOR_NO_ERROR);
+            shared_memory_write_primary_feedback(blocks, i, -i, SENSOR_NO_ERROR, SENSOR_NO_ERROR, 3u * i);
+        }
+        write_latency.add(test_time_ns() - start);
+    }
+    writer_done = 1;
+    pthread_cond_destroy(&t.reply);
+
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    Reader &r = *(Reader *)arg;
+    int last_position = 0;
+    Transaction t;
+
+    pthread_cond_init(&t.reply, NULL);
+    while (!writer_done)
+    {
+        UpstreamControlData data;
+        double start = test_time_ns();
+
+        if (r.mode == ACCESS_SERVICE)
+        {
+            t.write = 0;
+            service_transaction(t);
+            data = t.data;
+        }
+        else if (r.mode == ACCESS_MUTEX)
+        {
+            pthread_mutex_lock(&mutex);
+            data = locked_data;
+            pthread_mutex_unlock(&mutex);
+        }
+        else
+        {
+            shared_memory_read_primary_feedback(blocks, data);
+            shared_memory_read_angle(blocks, data);
+        }
+        r.latency.add(test_time_ns() - start);
+
+        if (data.velocity != -data.position || data.sensor_timestamp != 3u * data.position ||
+                data.angle != (unsigned)(data.angle_velocity & 4095))
+            r.inconsistent++;
+        if (data.position < last_position)
+            r.backwards++;
+        last_position = data.position;
+        r.reads++;
+    }
+    pthread_cond_destroy(&t.reply);
+
+    return NULL;
+}
+
+/*
+ * Returns the median read latency.
+ */
+static int run(AccessMode mode)
+{
+    static Reader readers[N_READERS];
+    Latency read_latency;
+    pthread_t writer_thread, service_thread;
+    unsigned long long reads = 0, inconsistent = 0, backwards = 0;
+    const char *name = access_mode_name[mode];
+
+    memset(readers, 0, sizeof(readers));
+    memset(&read_latency, 0, sizeof(read_latency));
+    memset(&write_latency, 0, sizeof(write_latency));
+    memset(&locked_data, 0, sizeof(locked_data));
+    memset(&service_data, 0, sizeof(service_data));
+    shared_memory_blocks_init(blocks);
+    writer_done = 0;
+    service_stop = 0;
+
+    if (mode == ACCESS_SERVICE)
+        pthread_create(&service_thread, NULL, service, NULL);
+    for (int i=0; i<N_READERS; i++)
+    {
+        readers[i].mode = mode;
+        pthread_create(&readers[i].thread, NULL, reader, &readers[i]);
+    }
+    pthread_create(&writer_thread, NULL, writer, &mode);
+
+    pthread_join(writer_thread, NULL);
+    for (int i=0; i<N_READERS; i++)
+    {
+        pthread_join(readers[i].thread, NULL);
+        reads += readers[i].reads;
+        inconsistent += readers[i].inconsistent;
+        backwards += readers[i].backwards;
+        read_latency.merge(readers[i].latency);
+    }
+    if (mode == ACCESS_SERVICE)
+    {
+        pthread_mutex_lock(&service_mutex);
+        service_stop = 1;
+        pthread_cond_signal(&service_request);
+        pthread_mutex_unlock(&service_mutex);
+        pthread_join(service_thread, NULL);
+    }
+
+    printf("  %-9s %d writes, %llu reads by %d readers: %llu inconsistent, %llu backwards\n",
+            name, mode == ACCESS_SERVICE ? N_SERVICE_WRITES : N_WRITES, reads, N_READERS, inconsistent, backwards);
+    printf("  %-9s write median %5d ns  99%% %5d ns  99.9%% %6d ns  max %8.0f ns\n", "", write_latency.percentile(0.5),
+            write_latency.percentile(0.99), write_latency.percentile(0.999), write_latency.max);
+    printf("  %-9s read  median %5d ns  99%% %5d ns  99.9%% %6d ns  max %8.0f ns\n", "", read_latency.percentile(0.5),
+            read_latency.percentile(0.99), read_latency.percentile(0.999), read_latency.max);
+
+    CHECK(inconsistent == 0, "%s: %llu inconsistent snapshots", name, inconsistent);
+    CHECK(backwards == 0, "%s: %llu snapshots older than the previous one", name, backwards);
+    CHECK(reads > 0, "no reads");
+
+    return read_latency.percentile(0.5);
+}
+
+int main(void)
+{
+    //with fewer cores than threads the tail latencies are dominated by the preemption of the threads
+    printf("test_shared_memory_seqlock, %ld cores (latencies include the clock read)\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+    int lock_free = run(ACCESS_LOCK_FREE);
+    int mutex = run(ACCESS_MUTEX);
+    int service = run(ACCESS_SERVICE);
+
+    //the lock-free copy replaces the service transactions, the mutex is only a reference for the cost of the copy
+    printf("  read median: lock-free %d ns, mutex %d ns, service %d ns (%.1f times the lock-free read)\n",
+            lock_free, mutex, service, (double)service / lock_free);
+    CHECK(lock_free < service, "lock-free read %d ns not faster than the service transaction %d ns", lock_free, service);
+
+    return test_result("test_shared_memory_seqlock");
+}
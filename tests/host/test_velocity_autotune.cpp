@@ -0,0 +1,161 @@
+/**
+ * @file test_velocity_autotune.cpp
+ * @brief The velocity autotuner evaluating the step response with running sums must give the same
+ *        gains as the former tuner storing the whole step response, on step responses recorded from
+ *        plants with different inertia, friction and velocity noise.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include "test.h"
+
+extern "C" {
+#include <auto_tune.h>
+}
+
+#define PERIOD          POSITION_CONTROL_LOOP_PERIOD
+#define N_CALLS         (4 * ((MEASUREMENT_ARRAY_LENGTH * 5) / 4) + 8)
+#define TWO_PI          6.28318530718
+
+/**
+ * @brief The former velocity autotuner with the buffer of the step response, as reference.
+ */
+struct BufferedAutoTune {
+    int counter;
+    int save_counter;
+    int actual_velocity[MEASUREMENT_ARRAY_LENGTH + 1];
+    double velocity_ref;
+    double j, f, z, st, kp, ki;
+
+    void init(int velocity, double settling_time)
+    {
+        counter = 0;
+        save_counter = 0;
+        for (int i=0; i<=MEASUREMENT_ARRAY_LENGTH; i++)
+            actual_velocity[i] = 0;
+        j = f = kp = ki = 0.00;
+        z = 0.70;
+        st = settling_time;
+        velocity_ref = velocity > 2000 ? 2000 : velocity;
+    }
+
+    void update(double velocity_k, int velocity_kp)
+    {
+        save_counter++;
+        if (save_counter == 4)
+        {
+            save_counter = 0;
+            counter++;
+        }
+        if (counter < 1 || counter > MEASUREMENT_ARRAY_LENGTH)
+            return;
+
+        actual_velocity[counter] = (int)velocity_k;
+        if (counter == MEASUREMENT_ARRAY_LENGTH)
+        {
+            double steady_state = 0, speed_integral = 0, g_speed = 60.00 / (2.00 * 3.1416), wn;
+
+            for (int i=MEASUREMENT_ARRAY_LENGTH-100; i<=MEASUREMENT_ARRAY_LENGTH; i++)
+                steady_state += (double)actual_velocity[i];
+            steady_state = steady_state / 100.00;
+            for (int i=1; i<=MEASUREMENT_ARRAY_LENGTH; i++)
+                speed_integral += steady_state - (double)actual_velocity[i];
+            speed_integral *= (4 * PERIOD) / 1000000.00;
+            speed_integral /= g_speed;
+
+            j = ((speed_integral * velocity_kp) / 1000000000) / (steady_state / g_speed) / (steady_state / g_speed) * velocity_ref;
+            f = ((velocity_ref * velocity_kp) / 1000000000) / (steady_state / g_speed) - ((g_speed * velocity_kp) / 1000000000);
+
+            kp = ki = 0.00;
+            if (f > 0 && j > 0)
+            {
+                wn = 4.00 / (z * st);
+                kp = (1.00 / (0.001 * g_speed)) * ((2.00 * z * wn * j) - f) * 1000000.00;
+                ki = ((wn * wn * j) / (0.001 * g_speed)) * 1000.00;
+                if (kp < 0 || ki < 0)
+                    kp = ki = 0.00;
+            }
+        }
+    }
+};
+
+struct Plant {
+    double inertia;             //[kg m^2]
+    double viscous_friction;    //[Nm s/rad]
+    double coulomb_friction;    //[Nm]
+    double noise;               //amplitude of the velocity noise [rpm]
+};
+
+static double relative_difference(double a, double b)
+{
+    double scale = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    return scale > 0 ? fabs(a - b) / scale : 0;
+}
+
+/**
+ * @brief Runs the tuner in the loop of the P velocity controller of the tuning against the plant
+ *        and records the measured velocity, then feeds the recording to the former tuner.
+ */
+static void test_plant(const Plant &plant)
+{
+    static double recorded[N_CALLS];
+    VelCtrlAutoTuneParam tuner;
+    BufferedAutoTune reference;
+    MotionControlConfig config;
+    unsigned seed = 17;
+    double omega = 0, velocity_ref = 0, j, kp, ki;
+    int velocity_kp;
+
+    config.enable_velocity_auto_tuner = 1;
+    init_velocity_auto_tuner(tuner, config, TUNING_VELOCITY, SETTLING_TIME);
+    velocity_kp = config.velocity_kp;
+
+    for (int k=0; k<N_CALLS; k++)
+    {
+        double velocity = omega * 60.00 / TWO_PI + plant.noise * (test_random_range(seed, -1000, 1000) / 1000.00);
+        double torque = ((velocity_kp / 1000000.00) * (velocity_ref - velocity)) / 1000.00;
+
+        recorded[k] = velocity;
+        velocity_controller_auto_tune(tuner, config, velocity_ref, velocity, PERIOD);
+
+        torque -= plant.viscous_friction * omega;
+        if (omega != 0)
+            torque -= omega > 0 ? plant.coulomb_friction : -plant.coulomb_friction;
+        omega += (torque / plant.inertia) * (PERIOD / 1000000.00);
+    }
+    CHECK(config.enable_velocity_auto_tuner == 0, "J %g: tuning not ended", plant.inertia);
+    j = tuner.j;
+    kp = config.velocity_kp;
+    ki = config.velocity_ki;
+
+    reference.init(TUNING_VELOCITY, SETTLING_TIME);
+    for (int k=0; k<N_CALLS; k++)
+        reference.update(recorded[k], velocity_kp);
+
+    printf("  J %.1e f %.1e c %.2f noise %.0f rpm: J %.3e kp %8.0f ki %6.0f, former J %.3e kp %8.0f ki %6.0f\n",
+            plant.inertia, plant.viscous_friction, plant.coulomb_friction, plant.noise,
+            j, kp, ki, reference.j, (double)(int)reference.kp, (double)(int)reference.ki);
+    CHECK(relative_difference(j, reference.j) < 1.0e-9, "J %g: J %g, former %g", plant.inertia, j, reference.j);
+    CHECK(fabs(kp - (int)reference.kp) <= 1, "J %g: kp %.0f, former %d", plant.inertia, kp, (int)reference.kp);
+    CHECK(fabs(ki - (int)reference.ki) <= 1, "J %g: ki %.0f, former %d", plant.inertia, ki, (int)reference.ki);
+}
+
+int main(void)
+{
+    const Plant plants[] = {
+        { 1.0e-4, 1.0e-4, 0.00, 0 },
+        { 1.0e-4, 1.0e-3, 0.02, 3 },
+        { 5.0e-4, 1.0e-4, 0.00, 1 },
+        { 5.0e-4, 5.0e-4, 0.05, 3 },
+        { 3.0e-3, 1.0e-4, 0.00, 0 },
+        { 3.0e-3, 1.0e-3, 0.02, 3 },
+    };
+
+    printf("test_velocity_autotune, %d bytes of state, %d bytes with the buffer\n",
+            (int)sizeof(VelCtrlAutoTuneParam), (int)sizeof(BufferedAutoTune));
+
+    for (unsigned i=0; i<sizeof(plants)/sizeof(plants[0]); i++)
+        test_plant(plants[i]);
+
+    return test_result("test_velocity_autotune");
+}
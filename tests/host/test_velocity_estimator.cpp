@@ -0,0 +1,86 @@
+/**
+ * @file test_velocity_estimator.cpp
+ * @brief Velocity of the alpha-beta-gamma estimator at constant speed, and at its restarts after a gap of
+ *        the positions and at a backward step of the timestamps (overflow of a timestamp which is not
+ *        unwrapped). The restarts begin at the velocity of the sensor instead of 0.
+ * @author Synapticon GmbH <support@synapticon.com>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+
+extern "C" {
+#include <velocity_estimator.h>
+}
+
+#define T_S             333
+#define BANDWIDTH       100
+#define RESOLUTION      65536
+#define VELOCITY        1500        //[rpm]
+#define N_PERIODS       30000
+#define GAP_PERIOD      10000       //the positions stop for 2*VELOCITY_ESTIMATOR_MAX_GAP periods
+#define WRAP_PERIOD     20000       //the timestamps step back by 2^32/250 us
+#define SETTLING        500         //periods after the start
+
+/**
+ * @brief Largest velocity error after the start, and right after the two restarts.
+ */
+static int run(int seed_with_sensor_velocity, int &error_at_restart)
+{
+    VelocityEstimatorParam estimator;
+    unsigned seed = 9;
+    int max_error = 0;
+    unsigned int timestamp = 0;
+
+    velocity_estimator_init(BANDWIDTH, RESOLUTION, T_S, estimator);
+    error_at_restart = 0;
+
+    for (int k=0; k<N_PERIODS; k++)
+    {
+        double t = (double)k * T_S;
+        int position = (int)lround((((double)VELOCITY) * RESOLUTION / 60.00) * t * 1.0e-6) + test_random_range(seed, -2, 2);
+        int sensor_velocity = VELOCITY + test_random_range(seed, -20, 20);
+        int velocity, error;
+
+        if (k >= GAP_PERIOD && k < GAP_PERIOD + 2 * VELOCITY_ESTIMATOR_MAX_GAP)
+            continue;
+        timestamp = (unsigned int)t;
+        if (k >= WRAP_PERIOD)
+            timestamp -= 17179869;
+
+        velocity = velocity_estimator_update(position, timestamp, 0, seed_with_sensor_velocity ? sensor_velocity : 0, estimator);
+        error = abs(velocity - VELOCITY);
+
+        if (k == GAP_PERIOD + 2 * VELOCITY_ESTIMATOR_MAX_GAP || k == WRAP_PERIOD)
+        {
+            if (error > error_at_restart)
+                error_at_restart = error;
+        }
+        else if (k > SETTLING && error > max_error)
+            max_error = error;
+    }
+
+    return max_error;
+}
+
+int main(void)
+{
+    int error_at_restart, error_at_restart_zero;
+    int max_error, max_error_zero;
+
+    printf("test_velocity_estimator, %d rpm\n", VELOCITY);
+
+    max_error = run(1, error_at_restart);
+    max_error_zero = run(0, error_at_restart_zero);
+
+    printf("  restart at 0 rpm           : velocity error %4d rpm at the restarts, max %4d rpm otherwise\n", error_at_restart_zero, max_error_zero);
+    printf("  restart at sensor velocity : velocity error %4d rpm at the restarts, max %4d rpm otherwise\n", error_at_restart, max_error);
+
+    CHECK(error_at_restart_zero == VELOCITY, "restart at 0 rpm: error %d", error_at_restart_zero);
+    CHECK(error_at_restart <= 20, "restart at the sensor velocity: error %d", error_at_restart);
+    CHECK(max_error < 50, "max error %d with the restarts at the sensor velocity", max_error);
+    CHECK(max_error < max_error_zero, "max error %d not below %d of the restarts at 0 rpm", max_error, max_error_zero);
+
+    return test_result("test_velocity_estimator");
+}